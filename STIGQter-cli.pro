@@ -0,0 +1,104 @@
+#-------------------------------------------------
+#
+# STIGQter - STIG fun with Qt
+#
+# Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+#-------------------------------------------------
+
+# Headless command-line interface; see src/cli.cpp for its commands.
+QT       = core network sql xml concurrent
+
+TARGET = stigqter-cli
+TEMPLATE = app
+
+CONFIG += console c++1z
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS STIGQTER_CLI
+
+SOURCES += \
+    src/asset.cpp \
+    src/cci.cpp \
+    src/cklcache.cpp \
+    src/cklcheck.cpp \
+    src/cli.cpp \
+    src/clijob.cpp \
+    src/climain.cpp \
+    src/common.cpp \
+    src/control.cpp \
+    src/dbmanager.cpp \
+    src/family.cpp \
+    src/jobscheduler.cpp \
+    src/memorymonitor.cpp \
+    src/progressreporter.cpp \
+    src/querystats.cpp \
+    src/stig.cpp \
+    src/stigcheck.cpp \
+    src/supplement.cpp \
+    src/tracerecorder.cpp \
+    src/warningsink.cpp \
+    src/worker.cpp \
+    src/workercciadd.cpp \
+    src/workercklexport.cpp \
+    src/workercklimport.cpp \
+    src/workercmrsexport.cpp \
+    src/workeremassreport.cpp \
+    src/workerfindingsreport.cpp \
+    src/workerstigadd.cpp
+
+HEADERS += \
+    src/asset.h \
+    src/cci.h \
+    src/cklcache.h \
+    src/cklcheck.h \
+    src/cli.h \
+    src/clijob.h \
+    src/common.h \
+    src/control.h \
+    src/dbmanager.h \
+    src/family.h \
+    src/jobscheduler.h \
+    src/memorymonitor.h \
+    src/progressreporter.h \
+    src/querystats.h \
+    src/stig.h \
+    src/stigcheck.h \
+    src/supplement.h \
+    src/tracerecorder.h \
+    src/warningsink.h \
+    src/worker.h \
+    src/workercciadd.h \
+    src/workercklexport.h \
+    src/workercklimport.h \
+    src/workercmrsexport.h \
+    src/workeremassreport.h \
+    src/workerfindingsreport.h \
+    src/workerstigadd.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = $${PREFIX}/bin
+!isEmpty(target.path): INSTALLS += target
+
+LIBS += -ltidy -lzip -lxlsxwriter -lz
+win32: LIBS += -lpsapi
+
+INCLUDEPATH = src
+
+exists(/usr/include/tidy) {
+	INCLUDEPATH += /usr/include/tidy
+}
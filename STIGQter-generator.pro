@@ -0,0 +1,83 @@
+#-------------------------------------------------
+#
+# STIGQter - STIG fun with Qt
+#
+# Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+#-------------------------------------------------
+
+# Synthetic package generator; see src/generatormain.cpp for its options.
+QT       = core network sql xml concurrent
+
+TARGET = stigqter-generator
+TEMPLATE = app
+
+CONFIG += console c++1z
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS STIGQTER_CLI
+
+SOURCES += \
+    src/asset.cpp \
+    src/cci.cpp \
+    src/cklcache.cpp \
+    src/cklcheck.cpp \
+    src/common.cpp \
+    src/control.cpp \
+    src/dbmanager.cpp \
+    src/family.cpp \
+    src/fixturegenerator.cpp \
+    src/generatormain.cpp \
+    src/memorymonitor.cpp \
+    src/querystats.cpp \
+    src/stig.cpp \
+    src/stigcheck.cpp \
+    src/supplement.cpp \
+    src/tracerecorder.cpp \
+    src/warningsink.cpp \
+    src/worker.cpp \
+    src/workercklexport.cpp \
+    src/workerstigadd.cpp
+
+HEADERS += \
+    src/asset.h \
+    src/cci.h \
+    src/cklcache.h \
+    src/cklcheck.h \
+    src/common.h \
+    src/control.h \
+    src/dbmanager.h \
+    src/family.h \
+    src/fixturegenerator.h \
+    src/memorymonitor.h \
+    src/querystats.h \
+    src/stig.h \
+    src/stigcheck.h \
+    src/supplement.h \
+    src/tracerecorder.h \
+    src/warningsink.h \
+    src/worker.h \
+    src/workercklexport.h \
+    src/workerstigadd.h
+
+LIBS += -ltidy -lzip -lxlsxwriter -lz
+win32: LIBS += -lpsapi
+
+INCLUDEPATH = src
+
+exists(/usr/include/tidy) {
+	INCLUDEPATH += /usr/include/tidy
+}
@@ -21,7 +21,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui network sql xml
+QT       += core gui network sql xml concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -45,22 +45,36 @@ SOURCES += \
     src/asset.cpp \
     src/assetview.cpp \
     src/cci.cpp \
+    src/cklcache.cpp \
     src/cklcheck.cpp \
+    src/cklcheckmodel.cpp \
+    src/cklcheckproxymodel.cpp \
+    src/cklwritequeue.cpp \
     src/common.cpp \
     src/control.cpp \
+    src/dblistmodel.cpp \
     src/dbmanager.cpp \
+    src/diagnostics.cpp \
     src/family.cpp \
     src/help.cpp \
+    src/jobscheduler.cpp \
     src/main.cpp \
+    src/memorymonitor.cpp \
+    src/progressreporter.cpp \
+    src/querystats.cpp \
+    src/searchview.cpp \
     src/stig.cpp \
     src/stigcheck.cpp \
     src/stigedit.cpp \
     src/stigqter.cpp \
     src/supplement.cpp \
     src/tabviewwidget.cpp \
+    src/tracerecorder.cpp \
+    src/warningsink.cpp \
     src/worker.cpp \
     src/workerassetadd.cpp \
     src/workerassetckl.cpp \
+    src/workerassetload.cpp \
     src/workercciadd.cpp \
     src/workerccidelete.cpp \
     src/workercheckversion.cpp \
@@ -80,21 +94,35 @@ HEADERS += \
     src/asset.h \
     src/assetview.h \
     src/cci.h \
+    src/cklcache.h \
     src/cklcheck.h \
+    src/cklcheckmodel.h \
+    src/cklcheckproxymodel.h \
+    src/cklwritequeue.h \
     src/common.h \
     src/control.h \
+    src/dblistmodel.h \
     src/dbmanager.h \
+    src/diagnostics.h \
     src/family.h \
     src/help.h \
+    src/jobscheduler.h \
+    src/memorymonitor.h \
+    src/progressreporter.h \
+    src/querystats.h \
+    src/searchview.h \
     src/stig.h \
     src/stigcheck.h \
     src/stigedit.h \
     src/stigqter.h \
     src/supplement.h \
     src/tabviewwidget.h \
+    src/tracerecorder.h \
+    src/warningsink.h \
     src/worker.h \
     src/workerassetadd.h \
     src/workerassetckl.h \
+    src/workerassetload.h \
     src/workercciadd.h \
     src/workerccidelete.h \
     src/workercheckversion.h \
@@ -112,7 +140,9 @@ HEADERS += \
 
 FORMS += \
     src/assetview.ui \
+    src/diagnostics.ui \
     src/help.ui \
+    src/searchview.ui \
     src/stigedit.ui \
     src/stigqter.ui
 
@@ -122,6 +152,7 @@ else: unix:!android: target.path = $${PREFIX}/bin
 !isEmpty(target.path): INSTALLS += target
 
 LIBS += -ltidy -lzip -lxlsxwriter -lz
+win32: LIBS += -lpsapi
 
 INCLUDEPATH = src
 
@@ -26,15 +26,21 @@
 #include "stigqter.h"
 #include "ui_assetview.h"
 #include "workerassetckl.h"
+#include "workerassetload.h"
 
+#include <QApplication>
 #include <QFileDialog>
 #include <QFont>
 #include <QInputDialog>
 #include <QMessageBox>
+#include <QScrollBar>
+#include <QSet>
 #include <QShortcut>
 #include <QXmlStreamWriter>
+#include <QThread>
 #include <QTimer>
 
+#include <algorithm>
 #include <iostream>
 #include <utility>
 
@@ -64,6 +70,13 @@ AssetView::AssetView(Asset &asset, QWidget *parent) :
     _asset(std::move(asset)),
     _justification(),
     _updateStatus(false),
+    _counts(),
+    _loadId(0),
+    _loading(false),
+    _suspended(false),
+    _restoreView(false),
+    _restoreCurrent(-1),
+    _restoreScroll(0),
     _isFiltered(false)
 {
     ui->setupUi(this);
@@ -73,6 +86,12 @@ AssetView::AssetView(Asset &asset, QWidget *parent) :
     ui->splitter->setStretchFactor(1, 3);
     ui->splitter->setStretchFactor(2, 2);
 
+    //the checks are displayed through a sorted and filtered model
+    _checkProxy.setSourceModel(&_checkModel);
+    ui->lstChecks->setModel(&_checkProxy);
+    connect(ui->lstChecks->selectionModel(), SIGNAL(currentChanged(QModelIndex, QModelIndex)), this, SLOT(CheckSelected(QModelIndex, QModelIndex)));
+    connect(ui->lstChecks->selectionModel(), SIGNAL(selectionChanged(QItemSelection, QItemSelection)), this, SLOT(CheckSelectedChanged()));
+
     /*
      * The main timer signals that the checklist entries have been
      * modified by the user. Since the user may be modifying large
@@ -91,17 +110,14 @@ AssetView::AssetView(Asset &asset, QWidget *parent) :
     connect(&_timerChecks, SIGNAL(timeout()), this, SLOT(CountChecks()));
 
     /*
-     * Shortcuts for quickly setting compliance state of selected
-     * check(s):
-     * 1. CTRL+N: Not a Finding
-     * 2. CTRL+O: Open Finding
-     * 3. CTRL+R: Not Reviewed
-     * 4. CTRL+X: Not Applicable
+     * Edited checks are written to the database in the background by
+     * the write queue; the number of unsaved changes is displayed.
      */
-    _shortcuts.append(new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_N), this, SLOT(KeyShortcutCtrlN())));
-    _shortcuts.append(new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_O), this, SLOT(KeyShortcutCtrlO())));
-    _shortcuts.append(new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_R), this, SLOT(KeyShortcutCtrlR())));
-    _shortcuts.append(new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_X), this, SLOT(KeyShortcutCtrlX())));
+    connect(&_writeQueue, SIGNAL(PendingChanged(int)), this, SLOT(PendingChanged(int)));
+    connect(&_writeQueue, SIGNAL(WriteFailed(int)), this, SLOT(WriteFailed(int)));
+
+    //shortcuts for setting the compliance state of selected checks
+    CreateShortcuts();
 
     if (_asset.id >= 0)
         Display();
@@ -114,9 +130,10 @@ AssetView::AssetView(Asset &asset, QWidget *parent) :
  */
 AssetView::~AssetView()
 {
-    Q_FOREACH (QShortcut *shortcut, _shortcuts)
-        delete shortcut;
-    _shortcuts.clear();
+    _writeQueue.Drain();
+    disconnect(&_writeQueue, nullptr, this, nullptr);
+    disconnect(ui->lstChecks->selectionModel(), nullptr, this, nullptr);
+    DeleteShortcuts();
     delete ui;
 }
 
@@ -149,15 +166,15 @@ void AssetView::DisableInput()
 /**
  * @brief AssetView::Display
  *
- * Shows the STIGs and CKL Checks for the selected Asset
+ * Shows the STIGs and CKL Checks for the selected Asset. They are
+ * loaded in the background; the tab is usable while they load.
  */
 void AssetView::Display()
 {
     ui->txtIP->setText(_asset.hostIP);
     ui->txtMAC->setText(_asset.hostMAC);
     ui->txtFQDN->setText(_asset.hostFQDN);
-    SelectSTIGs();
-    ShowChecks();
+    Load(true);
 }
 
 /**
@@ -195,6 +212,45 @@ TabType AssetView::GetTabType()
     return TabType::asset;
 }
 
+/**
+ * @brief AssetView::Resume
+ *
+ * Reload a suspended tab and reselect the checks that were selected
+ * when it was suspended.
+ */
+void AssetView::Resume()
+{
+    if (!_suspended)
+        return;
+    _suspended = false;
+    CreateShortcuts();
+    _restoreView = true;
+    Load(true);
+}
+
+/**
+ * @brief AssetView::SaveChanges
+ * @return @c True when every edit of this @a Asset's checks has been
+ * written to the database. Otherwise, @c false.
+ *
+ * Write the edits that are still waiting on the user to finish
+ * typing or on the write queue.
+ */
+bool AssetView::SaveChanges()
+{
+    if (_timer.isActive())
+    {
+        _timer.stop();
+        UpdateCKLHelper();
+    }
+    if (!_writeQueue.Drain())
+    {
+        Warning(QStringLiteral("Unable to Save Changes"), "The changes to " + PrintAsset(_asset) + " could not be written to the database.");
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief AssetView::SelectSTIGs
  * @param search
@@ -205,10 +261,22 @@ TabType AssetView::GetTabType()
 void AssetView::SelectSTIGs(const QString &search)
 {
     DbManager db;
+    ShowSTIGs(db.GetSTIGs(), _asset.GetSTIGs(), search);
+}
 
+/**
+ * @brief AssetView::ShowSTIGs
+ * @param stigs
+ * @param assetSTIGs
+ * @param search
+ *
+ * Lists the @a stigs whose titles match the @a search text, marking
+ * the @a assetSTIGs that are tied to the Asset as selected.
+ */
+void AssetView::ShowSTIGs(const QVector<STIG> &stigs, const QVector<STIG> &assetSTIGs, const QString &search)
+{
     ui->lstSTIGs->clear();
-    QVector<STIG> stigs = _asset.GetSTIGs();
-    Q_FOREACH (const STIG s, db.GetSTIGs())
+    Q_FOREACH (const STIG s, stigs)
     {
         if (!search.isEmpty() && !s.title.contains(search, Qt::CaseInsensitive))
         {
@@ -217,10 +285,25 @@ void AssetView::SelectSTIGs(const QString &search)
         QListWidgetItem *i = new QListWidgetItem(PrintSTIG(s));
         ui->lstSTIGs->addItem(i);
         i->setData(Qt::UserRole, QVariant::fromValue<STIG>(s));
-        i->setSelected(stigs.contains(s));
+        i->setSelected(assetSTIGs.contains(s));
     }
 }
 
+/**
+ * @brief AssetView::AddCount
+ * @param status
+ * @param severity
+ * @param count
+ *
+ * Adjust the number of checks with the provided compliance
+ * @a status and @a severity by @a count.
+ */
+void AssetView::AddCount(Status status, Severity severity, int count)
+{
+    if ((status >= 0) && (status < 4) && (severity >= 0) && (severity < 4))
+        _counts[status][severity] += count;
+}
+
 /**
  * @brief AssetView::CountChecks
  *
@@ -237,57 +320,88 @@ void AssetView::CountChecks()
  *
  * When @a countOnly is @c true, the number of checks and their
  * compliance statuses are updated. When @a countOnly is @c false,
- * the display of CKL Checks is also updated.
+ * the CKL Checks are also reloaded in the background.
  */
 void AssetView::ShowChecks(bool countOnly)
 {
     if (!countOnly)
-        ui->lstChecks->clear();
+        Load(false);
+
     int total = 0; //total checks
     int open = 0; //findings
     int closed = 0; //passed checks
-
-    QString filterSeverityText = ui->cboBoxFilterSeverity->currentText();
-    Severity filterSeverity = GetSeverity(ui->cboBoxFilterSeverity->currentText());
-    QString filterStatusText = ui->cboBoxFilterStatus->currentText();
-    Status filterStatus = GetStatus(ui->cboBoxFilterStatus->currentText());
-
-    Q_FOREACH(const CKLCheck c, _asset.GetCKLChecks())
+    for (int status = 0; status < 4; status++)
     {
-        total++;
-        switch (c.status)
+        for (int severity = 0; severity < 4; severity++)
         {
-        case Status::NotAFinding:
-            closed++;
-            break;
-        case Status::Open:
-            open++;
-            break;
-        default:
-            break;
-        }
-        //update the list of CKL checks
-        if (
-                !countOnly //perform filtering
-                && //severity filter
-                ((filterSeverityText == QStringLiteral("All")) ||
-                 (filterSeverity == c.GetSeverity()))
-                && //status filter
-                ((filterStatusText == QStringLiteral("All")) ||
-                 (filterStatus == c.status))
-            )
-        {
-            QListWidgetItem *i = new QListWidgetItem(PrintCKLCheck(c));
-            ui->lstChecks->addItem(i);
-            i->setData(Qt::UserRole, QVariant::fromValue<CKLCheck>(c));
-            SetItemColor(i, c.status, (c.severityOverride == Severity::none) ? c.GetSTIGCheck().severity : c.severityOverride);
+            int count = _counts[status][severity];
+            total += count;
+            switch (status)
+            {
+            case Status::NotAFinding:
+                closed += count;
+                break;
+            case Status::Open:
+                open += count;
+                break;
+            default:
+                break;
+            }
         }
     }
     ui->lblTotalChecks->setText(QString::number(total));
     ui->lblOpen->setText(QString::number(open));
     ui->lblNotAFinding->setText(QString::number(closed));
-    if (!countOnly)
-        ui->lstChecks->sortItems();
+}
+
+/**
+ * @brief AssetView::Suspend
+ *
+ * Release the checks, the list of STIGs, and the displayed check of
+ * a tab that has not been viewed for a while. Only the @a Asset and
+ * what the user had selected are kept so that Resume() can display
+ * the tab as it was. A tab with unsaved edits is not suspended, so
+ * that suspending never waits on the database.
+ */
+void AssetView::Suspend()
+{
+    if (_suspended || _loading || _timer.isActive() || (_writeQueue.Pending() > 0))
+        return;
+
+    //remember the selection and position of the check list
+    _restoreIds.clear();
+    Q_FOREACH (int row, SelectedRows())
+    {
+        _restoreIds.append(_checkModel.index(row).data(CKLCheckModel::IdRole).toInt());
+    }
+    QModelIndex current = ui->lstChecks->currentIndex();
+    _restoreCurrent = current.isValid() ? current.data(CKLCheckModel::IdRole).toInt() : -1;
+    _restoreScroll = ui->lstChecks->verticalScrollBar()->value();
+    _suspended = true;
+
+    //release the checks and STIGs
+    _checkModel.Clear();
+    ui->lstSTIGs->clear();
+    _cklCheck = CKLCheck();
+
+    //release the text of the displayed check
+    ui->txtComments->blockSignals(true);
+    ui->txtFindingDetails->blockSignals(true);
+    ui->txtComments->clear();
+    ui->txtFindingDetails->clear();
+    ui->txtComments->blockSignals(false);
+    ui->txtFindingDetails->blockSignals(false);
+    _justification.clear();
+    ui->lblCheckRule->clear();
+    ui->lblCheckTitle->clear();
+    ui->lblDiscussion->clear();
+    ui->lblFalsePositives->clear();
+    ui->lblFalseNegatives->clear();
+    ui->lblFix->clear();
+    ui->lblCheck->clear();
+    ui->lblCcis->clear();
+
+    DeleteShortcuts();
 }
 
 /**
@@ -356,6 +470,13 @@ void AssetView::UpdateSTIGCheck(const STIGCheck &stigCheck)
 void AssetView::RunTests()
 {
     int onTest = 0;
+    //wait for the checks to load
+    while (_loading)
+    {
+        QThread::msleep(100);
+        QApplication::processEvents();
+    }
+
     //step 1: search for Windows components
     std::cout << "\t\tTest " << onTest++ << ": Filter" << std::endl;
     ui->txtSTIGFilter->setText(QStringLiteral("Windows"));
@@ -398,37 +519,73 @@ void AssetView::RunTests()
     ProcEvents();
     std::cout << "done!" << std::endl;
 
-    //step 6: update asset
+    //step 6: write the queued changes
+    std::cout << "\t\tTest " << onTest++ << ": Save Changes" << std::endl;
+    SaveChanges();
+
+    //step 7: update asset
     std::cout << "\t\tTest " << onTest++ << ": Change Asset" << std::endl;
     ui->txtFQDN->setText(QStringLiteral("test.example.org"));
     ui->txtIP->setText(QStringLiteral("127.0.0.1"));
     ui->txtMAC->setText(QStringLiteral("00:00:00:00:00:00"));
 
-    //step 7: save CKL
+    //step 8: save CKL
     std::cout << "\t\tSaving CKL" << std::endl;
     SaveCKL(QStringLiteral("tests/monolithic.ckl"));
     ProcEvents();
 
-    //step 8: Count Checks
+    //step 9: Count Checks
     std::cout << "\t\tTest " << onTest++ << ": Counting Checks" << std::endl;
     UpdateChecks();
 
-    //step 9: import XCCDF
+    //step 10: import XCCDF
     std::cout << "\t\tTest " << onTest++ << ": Importing XCCDF" << std::endl;
     ImportXCCDF(QStringLiteral("tests/xccdf_lol.xml"));
     ProcEvents();
 
-    //step 10: rename asset
+    //step 11: suspend and resume the tab
+    std::cout << "\t\tTest " << onTest++ << ": Suspend Tab" << std::endl;
+    Suspend();
+    Resume();
+    while (_loading)
+    {
+        QThread::msleep(100);
+        QApplication::processEvents();
+    }
+
+    //step 12: rename asset
     std::cout << "\t\tTest " << onTest++ << ": Rename Asset" << std::endl;
     RenameAsset("TEST2");
     RenameAsset("TEST");
 
-    //step 11: delete asset
+    //step 13: delete asset
     std::cout << "\t\tTest " << onTest++ << ":Deleting Asset" << std::endl;
     DeleteAsset(true);
 }
 #endif
 
+/**
+ * @brief AssetView::ChecksLoaded
+ * @param loadId
+ * @param rows
+ *
+ * Display and count a chunk of checks read in the background.
+ */
+void AssetView::ChecksLoaded(int loadId, const QVector<CKLCheckRow> &rows)
+{
+    if (loadId != _loadId)
+        return;
+    //the edits that have not been written yet are displayed over the rows read from the database
+    QVector<CKLCheckRow> current(rows);
+    _writeQueue.Overlay(current);
+    _checkModel.Append(current);
+    Q_FOREACH (const CKLCheckRow &row, current)
+    {
+        AddCount(row.status, row.severity);
+    }
+    ShowChecks(true);
+}
+
 /**
  * @brief AssetView::CheckSelectedChanged
  *
@@ -437,7 +594,7 @@ void AssetView::RunTests()
  */
 void AssetView::CheckSelectedChanged()
 {
-    if (ui->lstChecks->selectedItems().count() > 1)
+    if (ui->lstChecks->selectionModel()->selectedIndexes().count() > 1)
     {
         //disable multi-editable fields
         ui->txtComments->setEnabled(false);
@@ -503,6 +660,9 @@ void AssetView::FilterSTIGs(const QString &text)
  */
 void AssetView::ImportXCCDF(const QString &filename)
 {
+    //the imported results replace the user's edits
+    SaveChanges();
+
     DbManager db;
     db.DelayCommit(true);
 
@@ -611,6 +771,9 @@ void AssetView::ImportXCCDF(const QString &filename)
                             QFileInfo fi(f);
                             ckl.findingDetails += "This finding information was set by XCCDF file " + fi.fileName();
                             db.UpdateCKLCheck(ckl);
+                            int row = _checkModel.Find(ckl.id);
+                            if (row >= 0)
+                                UpdateRow(row, ckl.status, static_cast<Severity>(_checkModel.index(row).data(CKLCheckModel::SeverityRole).toInt()));
                         }
                     }
                 }
@@ -625,7 +788,11 @@ void AssetView::ImportXCCDF(const QString &filename)
     }
     db.DelayCommit(false);
     if (updates) //only update the checks if something changed
-        ShowChecks();
+    {
+        _cklCheck = CKLCheck();
+        UpdateChecks();
+        CountChecks();
+    }
 }
 
 void AssetView::KeyShortcutCtrlN()
@@ -648,6 +815,71 @@ void AssetView::KeyShortcutCtrlX()
     KeyShortcut(Status::NotApplicable);
 }
 
+/**
+ * @brief AssetView::Load
+ * @param loadSTIGs
+ *
+ * Read the checks, and the list of STIGs when @a loadSTIGs is
+ * @c true, in the background. The checks are displayed and counted
+ * in chunks as they are read.
+ *
+ * The load is a @a ReadOnly job, so it waits for any
+ * @a DatabaseWriter job (such as an import) that is running or was
+ * submitted earlier. Until then, the tab shows "Loading checks…"
+ * rather than checks that the writer is changing.
+ */
+void AssetView::Load(bool loadSTIGs)
+{
+    //results of earlier loads are ignored
+    _loadId++;
+    _loading = true;
+    ui->lblLoading->setText(QStringLiteral("Loading checks…"));
+    _checkModel.Clear();
+    _checkProxy.SetFilter(ui->cboBoxFilterSeverity->currentText(), ui->cboBoxFilterStatus->currentText());
+    std::fill(&_counts[0][0], &_counts[0][0] + 16, 0);
+    ShowChecks(true);
+
+    auto *a = new WorkerAssetLoad();
+    a->AddAsset(_asset);
+    a->SetLoadId(_loadId);
+    a->SetLoadSTIGs(loadSTIGs);
+    connect(a, SIGNAL(STIGsLoaded(int, QVector<STIG>, QVector<STIG>)), this, SLOT(STIGsLoaded(int, QVector<STIG>, QVector<STIG>)));
+    connect(a, SIGNAL(ChecksLoaded(int, QVector<CKLCheckRow>)), this, SLOT(ChecksLoaded(int, QVector<CKLCheckRow>)));
+    connect(a, SIGNAL(Loaded(int)), this, SLOT(Loaded(int)));
+    //the load is not tied to the main window's progress; the scheduler cleans it up
+    _parent->Scheduler()->Submit(a, JobScheduler::ReadOnly);
+}
+
+/**
+ * @brief AssetView::Loaded
+ * @param loadId
+ *
+ * Hide the loading indicator when the latest load finishes.
+ */
+void AssetView::Loaded(int loadId)
+{
+    if (loadId == _loadId)
+    {
+        //the chunks are displayed in the order they were read and sorted once they are all loaded
+        _checkProxy.sort(0);
+        _loading = false;
+        ui->lblLoading->setText(QString());
+        if (_restoreView)
+            RestoreView();
+    }
+}
+
+/**
+ * @brief AssetView::PendingChanged
+ * @param count
+ *
+ * Show how many edits have not been written to the database yet.
+ */
+void AssetView::PendingChanged(int count)
+{
+    ui->lblPending->setText(count > 0 ? QString::number(count) + QStringLiteral(" unsaved change") + Pluralize(count) : QString());
+}
+
 /**
  * @brief AssetView::RenameAsset
  * @param name
@@ -685,7 +917,25 @@ void AssetView::SaveCKL(const QString &name)
     auto *a = new WorkerAssetCKL();
     a->AddAsset(_asset);
     a->AddFilename(fileName);
-    _parent->ConnectThreads(a)->start();
+    _parent->StartJob(a, JobScheduler::ReadOnly);
+}
+
+/**
+ * @brief AssetView::STIGsLoaded
+ * @param loadId
+ * @param stigs
+ * @param assetSTIGs
+ *
+ * Display the list of STIGs read in the background.
+ */
+void AssetView::STIGsLoaded(int loadId, const QVector<STIG> &stigs, const QVector<STIG> &assetSTIGs)
+{
+    if (loadId != _loadId)
+        return;
+    //listing the STIGs is not a change of the Asset's STIGs
+    ui->lstSTIGs->blockSignals(true);
+    ShowSTIGs(stigs, assetSTIGs, _isFiltered ? ui->txtSTIGFilter->text() : QString());
+    ui->lstSTIGs->blockSignals(false);
 }
 
 /**
@@ -696,7 +946,37 @@ void AssetView::SaveCKL(const QString &name)
  */
 void AssetView::UpdateChecks()
 {
-    ShowChecks();
+    _checkProxy.SetFilter(ui->cboBoxFilterSeverity->currentText(), ui->cboBoxFilterStatus->currentText());
+}
+
+/**
+ * @brief AssetView::CreateShortcuts
+ *
+ * Shortcuts for quickly setting compliance state of selected
+ * check(s):
+ * 1. CTRL+N: Not a Finding
+ * 2. CTRL+O: Open Finding
+ * 3. CTRL+R: Not Reviewed
+ * 4. CTRL+X: Not Applicable
+ */
+void AssetView::CreateShortcuts()
+{
+    _shortcuts.append(new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_N), this, SLOT(KeyShortcutCtrlN())));
+    _shortcuts.append(new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_O), this, SLOT(KeyShortcutCtrlO())));
+    _shortcuts.append(new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_R), this, SLOT(KeyShortcutCtrlR())));
+    _shortcuts.append(new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_X), this, SLOT(KeyShortcutCtrlX())));
+}
+
+/**
+ * @brief AssetView::DeleteShortcuts
+ *
+ * Remove the compliance state shortcuts.
+ */
+void AssetView::DeleteShortcuts()
+{
+    Q_FOREACH (QShortcut *shortcut, _shortcuts)
+        delete shortcut;
+    _shortcuts.clear();
 }
 
 /**
@@ -731,40 +1011,52 @@ void AssetView::KeyShortcut(Status action)
 /**
  * @brief AssetView::UpdateCKLHelper
  *
- * Update the database with user-modified data from the interface.
+ * Queue the user-modified data from the interface to be written to
+ * the database.
  */
 void AssetView::UpdateCKLHelper()
 {
-    QList<QListWidgetItem*> selectedItems = ui->lstChecks->selectedItems();
-    int count = selectedItems.count();
-    //make sure that something is selected
-    if (count > 0)
+    QList<int> selectedRows = SelectedRows();
+    int count = selectedRows.count();
+    //if multiple checks are selected, only update their status
+    if (count > 1)
     {
-        DbManager db;
-        db.DelayCommit(true);
-        Q_FOREACH (QListWidgetItem *i, selectedItems)
+        if (_updateStatus)
         {
-            auto cc = i->data(Qt::UserRole).value<CKLCheck>();
-            //if multiple checks are selected, only update their status
-            if (count < 2)
+            Status status = GetStatus(ui->cboBoxStatus->currentText());
+            QVector<int> ids;
+            ids.reserve(count);
+            Q_FOREACH (int row, selectedRows)
             {
-                cc.comments = ui->txtComments->toPlainText();
-                cc.findingDetails = ui->txtFindingDetails->toPlainText();
-                Severity tmpSeverity = GetSeverity(ui->cboBoxSeverity->currentText());
-                cc.severityOverride = (tmpSeverity == cc.GetSTIGCheck().severity) ? Severity::none : tmpSeverity;
-                cc.severityJustification = _justification;
-                cc.status = GetStatus(ui->cboBoxStatus->currentText());
+                ids.append(_checkModel.index(row).data(CKLCheckModel::IdRole).toInt());
             }
-            else {
-                if (_updateStatus)
-                {
-                    cc.status = GetStatus(ui->cboBoxStatus->currentText());
-                }
+            _writeQueue.Add(ids, status);
+            if (ids.contains(_cklCheck.id))
+                _cklCheck.status = status;
+            Q_FOREACH (int row, selectedRows)
+            {
+                UpdateRow(row, status, static_cast<Severity>(_checkModel.index(row).data(CKLCheckModel::SeverityRole).toInt()));
             }
-            db.UpdateCKLCheck(cc);
-            i->setData(Qt::UserRole, QVariant::fromValue<CKLCheck>(db.GetCKLCheck(cc)));
         }
-        db.DelayCommit(false);
+        _updateStatus = false;
+        _timerChecks.start(1000);
+    }
+    else if (count > 0)
+    {
+        int row = selectedRows.first();
+        int id = _checkModel.index(row).data(CKLCheckModel::IdRole).toInt();
+        //the displayed check is kept so that edits do not read the database
+        CKLCheck cc = (_cklCheck.id == id) ? _cklCheck : _writeQueue.GetCKLCheck(id);
+        Severity stigSeverity = static_cast<Severity>(_checkModel.index(row).data(CKLCheckModel::STIGSeverityRole).toInt());
+        cc.comments = ui->txtComments->toPlainText();
+        cc.findingDetails = ui->txtFindingDetails->toPlainText();
+        Severity tmpSeverity = GetSeverity(ui->cboBoxSeverity->currentText());
+        cc.severityOverride = (tmpSeverity == stigSeverity) ? Severity::none : tmpSeverity;
+        cc.severityJustification = _justification;
+        cc.status = GetStatus(ui->cboBoxStatus->currentText());
+        _writeQueue.Add(cc);
+        _cklCheck = cc;
+        UpdateRow(row, cc.status, tmpSeverity);
         _updateStatus = false;
         _timerChecks.start(1000);
     }
@@ -779,6 +1071,25 @@ void AssetView::UpdateCKLHelper()
     }
 }
 
+/**
+ * @brief AssetView::UpdateRow
+ * @param row
+ * @param status
+ * @param severity
+ *
+ * Display the check at @a row of the @a CKLCheckModel with the
+ * provided compliance @a status and effective @a severity, keeping
+ * the compliance counts in sync with the displayed checks.
+ */
+void AssetView::UpdateRow(int row, Status status, Severity severity)
+{
+    QModelIndex i = _checkModel.index(row);
+    AddCount(static_cast<Status>(i.data(CKLCheckModel::StatusRole).toInt()), static_cast<Severity>(i.data(CKLCheckModel::SeverityRole).toInt()), -1);
+    _checkModel.SetStatus(row, status);
+    _checkModel.SetSeverity(row, severity);
+    AddCount(status, severity);
+}
+
 /**
  * @brief AssetView::UpdateCKL
  *
@@ -799,16 +1110,14 @@ void AssetView::UpdateCKL()
  */
 void AssetView::UpdateCKLStatus(const QString &val)
 {
-    QList<QListWidgetItem*> selectedItems = ui->lstChecks->selectedItems();
+    QList<int> selectedRows = SelectedRows();
     Status stat;
     stat = GetStatus(val);
-    if (selectedItems.count() > 0)
+    if (selectedRows.count() > 0)
     {
-        Q_FOREACH (QListWidgetItem *i, selectedItems)
+        Q_FOREACH (int row, selectedRows)
         {
-            auto cc = i->data(Qt::UserRole).value<CKLCheck>();
-            STIGCheck sc = cc.GetSTIGCheck();
-            SetItemColor(i, stat, (cc.severityOverride == Severity::none) ? sc.severity : cc.severityOverride);
+            UpdateRow(row, stat, static_cast<Severity>(_checkModel.index(row).data(CKLCheckModel::SeverityRole).toInt()));
         }
         _updateStatus = true;
         UpdateCKL();
@@ -824,22 +1133,22 @@ void AssetView::UpdateCKLStatus(const QString &val)
  */
 void AssetView::UpdateCKLSeverity(const QString &val)
 {
-    QList<QListWidgetItem*> selectedItems = ui->lstChecks->selectedItems();
+    QList<int> selectedRows = SelectedRows();
     //should only be executed if one severity is set
-    if (selectedItems.count() > 0)
+    if (selectedRows.count() > 0)
     {
-        QListWidgetItem *i = selectedItems.first();
-        auto cc = i->data(Qt::UserRole).value<CKLCheck>();
-        STIGCheck sc = cc.GetSTIGCheck();
+        int row = selectedRows.first();
+        //the STIGCheck's severity is loaded with the row
+        Severity stigSeverity = static_cast<Severity>(_checkModel.index(row).data(CKLCheckModel::STIGSeverityRole).toInt());
         Severity tmpSeverity = GetSeverity(val);
-        if (sc.severity != tmpSeverity)
+        if (stigSeverity != tmpSeverity)
         {
             if (tmpSeverity == Severity::none)
             {
                 QMessageBox::warning(nullptr, QStringLiteral("Removed Severity Override"), QStringLiteral("Severity override is removed; findings cannot be downgraded to CAT IV."));
                 _justification = QString();
                 ui->cboBoxSeverity->blockSignals(true);
-                ui->cboBoxSeverity->setCurrentText(GetSeverity(sc.severity));
+                ui->cboBoxSeverity->setCurrentText(GetSeverity(stigSeverity));
                 ui->cboBoxSeverity->blockSignals(false);
             }
             else
@@ -854,13 +1163,13 @@ void AssetView::UpdateCKLSeverity(const QString &val)
                 else
                 {
                     ui->cboBoxSeverity->blockSignals(true);
-                    ui->cboBoxSeverity->setCurrentText(GetSeverity(sc.severity));
+                    ui->cboBoxSeverity->setCurrentText(GetSeverity(stigSeverity));
                     ui->cboBoxSeverity->blockSignals(false);
                     return;
                 }
             }
         }
-        SetItemColor(i, GetStatus(ui->cboBoxStatus->currentText()), GetSeverity(ui->cboBoxSeverity->currentText()));
+        UpdateRow(row, static_cast<Status>(_checkModel.index(row).data(CKLCheckModel::StatusRole).toInt()), GetSeverity(ui->cboBoxSeverity->currentText()));
         UpdateCKL();
     }
 }
@@ -873,83 +1182,70 @@ void AssetView::UpdateCKLSeverity(const QString &val)
  */
 void AssetView::UpdateSTIGs()
 {
-    DbManager db;
-    QVector<STIG> stigs = _asset.GetSTIGs();
+    //ids of the STIGs currently mapped to the Asset
+    QSet<int> assigned;
+    Q_FOREACH (const STIG &s, _asset.GetSTIGs())
+    {
+        assigned.insert(s.id);
+    }
+
+    QVector<int> addIds;
+    QVector<int> removeIds;
+    QList<QListWidgetItem*> removeItems;
+    QStringList removeNames;
     for (int i = 0; i < ui->lstSTIGs->count(); i++)
     {
         QListWidgetItem *item = ui->lstSTIGs->item(i);
         STIG s = item->data(Qt::UserRole).value<STIG>();
-        if (item->isSelected() && !stigs.contains(s))
+        if (item->isSelected() && !assigned.contains(s.id))
         {
-            db.AddSTIGToAsset(s, _asset);
-            ShowChecks();
+            addIds.append(s.id);
         }
-        else if (!item->isSelected() && stigs.contains(s))
+        else if (!item->isSelected() && assigned.contains(s.id))
         {
-            //confirm to delete the STIG (avoid accidental clicks in the STIG box)
-            QMessageBox::StandardButton confirm = QMessageBox::question(this, QStringLiteral("Confirm STIG Removal"), "Really delete the " + PrintSTIG(s) + " stig from " + PrintAsset(_asset) + "?",
-                                            QMessageBox::Yes|QMessageBox::No);
-            if (confirm == QMessageBox::Yes)
-            {
-                db.DeleteSTIGFromAsset(s, _asset);
-                ShowChecks();
-            }
-            else
+            removeIds.append(s.id);
+            removeItems.append(item);
+            removeNames.append(PrintSTIG(s));
+        }
+    }
+
+    if (!removeIds.isEmpty())
+    {
+        //confirm to delete the STIGs (avoid accidental clicks in the STIG box)
+        QMessageBox::StandardButton confirm = QMessageBox::question(this, QStringLiteral("Confirm STIG Removal"), "Really delete the " + removeNames.join(QStringLiteral(", ")) + " stig" + Pluralize(removeNames.count()) + " from " + PrintAsset(_asset) + "?",
+                                        QMessageBox::Yes|QMessageBox::No);
+        if (confirm != QMessageBox::Yes)
+        {
+            //keep STIGs selected on accidental click
+            ui->lstSTIGs->blockSignals(true);
+            Q_FOREACH (QListWidgetItem *item, removeItems)
             {
-                //keep STIG selected on accidental click
-                ui->lstSTIGs->blockSignals(true);
                 item->setSelected(true);
-                ui->lstSTIGs->blockSignals(false);
             }
+            ui->lstSTIGs->blockSignals(false);
+            removeIds.clear();
         }
     }
+
+    if (addIds.isEmpty() && removeIds.isEmpty())
+        return;
+
+    DbManager db;
+    if (!db.UpdateAssetSTIGs(_asset, addIds, removeIds))
+        Warning(QStringLiteral("Unable to Update STIGs"), "The STIGs of " + PrintAsset(_asset) + " could not be updated.");
+    ShowChecks();
 }
 
 /**
- * @brief AssetView::SetItemColor
- * @param i
- * @param stat
- * @param sev
+ * @brief AssetView::WriteFailed
+ * @param count
  *
- * Sets the QListWidgetItem's color so that attention is drawn to it,
- * particularly when the check is non-compliant.
+ * Warn the user that @a count edits could not be written to the
+ * database. They are still retried.
  */
-void AssetView::SetItemColor(QListWidgetItem *i, Status stat, Severity sev)
+void AssetView::WriteFailed(int count)
 {
-    QFont f;
-    i->setFont(f);
-    if (stat == Status::Open)
-    {
-        f.setBold(true);
-        i->setFont(f);
-        switch (sev)
-        {
-        case Severity::high:
-            i->setForeground(Qt::red);
-            break;
-        case Severity::medium:
-            i->setForeground(QColor("orange"));
-            break;
-        case Severity::low:
-            i->setForeground(Qt::yellow);
-            break;
-        default:
-            i->setForeground(Qt::black);
-            break;
-        }
-    }
-    else if (stat == Status::NotAFinding)
-    {
-        i->setForeground(Qt::green);
-    }
-    else if (stat == Status::NotApplicable)
-    {
-        i->setForeground(Qt::gray);
-    }
-    else
-    {
-        i->setForeground(Qt::black);
-    }
+    Warning(QStringLiteral("Unable to Save Changes"), QString::number(count) + " change" + Pluralize(count) + " to " + PrintAsset(_asset) + " could not be written to the database. STIGQter will keep trying; check the log for details.");
 }
 
 /**
@@ -958,12 +1254,54 @@ void AssetView::SetItemColor(QListWidgetItem *i, Status stat, Severity sev)
  * When a new CKL check is selected, make sure that the previously displayed
  * one has updated its elements correctly.
  */
-void AssetView::CheckSelected(QListWidgetItem *current, QListWidgetItem *previous [[maybe_unused]])
+void AssetView::CheckSelected(const QModelIndex &current, const QModelIndex &previous [[maybe_unused]])
 {
-    if (current)
+    if (current.isValid())
     {
-        auto cc = current->data(Qt::UserRole).value<CKLCheck>();
-        DbManager db;
-        UpdateCKLCheck(db.GetCKLCheck(cc));
+        _cklCheck = _writeQueue.GetCKLCheck(current.data(CKLCheckModel::IdRole).toInt());
+        UpdateCKLCheck(_cklCheck);
+    }
+}
+
+/**
+ * @brief AssetView::RestoreView
+ *
+ * Reselect the checks and scroll the check list to where they were
+ * when the tab was suspended.
+ */
+void AssetView::RestoreView()
+{
+    _restoreView = false;
+    QItemSelection selection;
+    Q_FOREACH (int id, _restoreIds)
+    {
+        int row = _checkModel.Find(id);
+        if (row >= 0)
+        {
+            QModelIndex i = _checkProxy.mapFromSource(_checkModel.index(row));
+            if (i.isValid())
+                selection.select(i, i);
+        }
+    }
+    int currentRow = _checkModel.Find(_restoreCurrent);
+    if (currentRow >= 0)
+        ui->lstChecks->selectionModel()->setCurrentIndex(_checkProxy.mapFromSource(_checkModel.index(currentRow)), QItemSelectionModel::NoUpdate);
+    ui->lstChecks->selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect);
+    ui->lstChecks->verticalScrollBar()->setValue(_restoreScroll);
+    _restoreIds.clear();
+}
+
+/**
+ * @brief AssetView::SelectedRows
+ * @return The rows of the @a CKLCheckModel that are selected in the
+ * list of checks.
+ */
+QList<int> AssetView::SelectedRows() const
+{
+    QList<int> ret;
+    Q_FOREACH (const QModelIndex &i, ui->lstChecks->selectionModel()->selectedIndexes())
+    {
+        ret.append(_checkProxy.mapToSource(i).row());
     }
+    return ret;
 }
@@ -22,14 +22,20 @@
 
 #include "asset.h"
 #include "cklcheck.h"
+#include "cklcheckmodel.h"
+#include "cklcheckproxymodel.h"
+#include "cklwritequeue.h"
+#include "stig.h"
 #include "stigcheck.h"
 #include "stigqter.h"
 
 #include <QLabel>
 #include <QListWidget>
+#include <QModelIndex>
 #include <QProgressBar>
 #include <QShortcut>
 #include <QTimer>
+#include <QVector>
 #include <QWidget>
 
 #include "tabviewwidget.h"
@@ -51,8 +57,11 @@ public:
     void Display();
     void EnableInput() override;
     TabType GetTabType() override;
+    void Resume() override;
+    bool SaveChanges() override;
     void SelectSTIGs(const QString &search = QString());
     void ShowChecks(bool countOnly = false);
+    void Suspend() override;
     void UpdateCKLCheck(const CKLCheck &cklCheck);
     void UpdateSTIGCheck(const STIGCheck &stigCheck);
 #ifdef USE_TESTS
@@ -60,8 +69,9 @@ public:
 #endif
 
 private Q_SLOTS:
-    void CheckSelected(QListWidgetItem *current, QListWidgetItem *previous);
+    void CheckSelected(const QModelIndex &current, const QModelIndex &previous);
     void CheckSelectedChanged();
+    void ChecksLoaded(int loadId, const QVector<CKLCheckRow> &rows);
     void CountChecks();
     void DeleteAsset(bool confirm = false);
     void FilterSTIGs(const QString &text);
@@ -70,14 +80,18 @@ private Q_SLOTS:
     void KeyShortcutCtrlO();
     void KeyShortcutCtrlR();
     void KeyShortcutCtrlX();
+    void Loaded(int loadId);
+    void PendingChanged(int count);
     void RenameAsset(const QString &name = QString());
     void SaveCKL(const QString &name = QString());
+    void STIGsLoaded(int loadId, const QVector<STIG> &stigs, const QVector<STIG> &assetSTIGs);
     void UpdateChecks();
     void UpdateCKL();
     void UpdateCKLHelper();
     void UpdateCKLStatus(const QString &val);
     void UpdateCKLSeverity(const QString &val);
     void UpdateSTIGs();
+    void WriteFailed(int count);
 
 private:
     Ui::AssetView *ui;
@@ -85,10 +99,29 @@ private:
     QString _justification;
     QTimer _timer;
     QTimer _timerChecks;
+    CKLCheckModel _checkModel;
+    CKLCheckProxyModel _checkProxy;
+    CKLWriteQueue _writeQueue;
+    CKLCheck _cklCheck; //displayed check, including unsaved changes
     QList<QShortcut*> _shortcuts;
     bool _updateStatus;
+    int _counts[4][4]; //CKLChecks by Status and Severity
+    int _loadId; //the latest background load of this Asset
+    bool _loading;
+    bool _suspended; //the checks and STIGs are released until the tab is viewed
+    bool _restoreView; //reselect the checks below once they are loaded
+    QVector<int> _restoreIds; //selected CKLCheck ids
+    int _restoreCurrent; //current CKLCheck id
+    int _restoreScroll; //position of the check list
+    void AddCount(Status status, Severity severity, int count = 1);
+    void CreateShortcuts();
+    void DeleteShortcuts();
     void KeyShortcut(Status action);
-    void SetItemColor(QListWidgetItem *i, Status stat, Severity sev);
+    void Load(bool loadSTIGs);
+    void RestoreView();
+    void ShowSTIGs(const QVector<STIG> &stigs, const QVector<STIG> &assetSTIGs, const QString &search = QString());
+    void UpdateRow(int row, Status status, Severity severity);
+    QList<int> SelectedRows() const;
     bool _isFiltered;
 };
 
@@ -0,0 +1,100 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include "common.h"
+#include "dbmanager.h"
+#include "memorymonitor.h"
+#include "tracerecorder.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+
+#include <cstdlib>
+#include <iostream>
+
+[[maybe_unused]] bool IgnoreWarnings = true; //see common.h; there is no one to show warnings to
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("stigqter-bench"));
+    QCoreApplication::setApplicationVersion(VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Measure STIGQter's import, export, and report paths against generated content."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption assets(QStringLiteral("assets"), QStringLiteral("Number of Assets."), QStringLiteral("count"), QStringLiteral("50"));
+    QCommandLineOption stigs(QStringLiteral("stigs"), QStringLiteral("Number of STIGs."), QStringLiteral("count"), QStringLiteral("10"));
+    QCommandLineOption stigsPerAsset(QStringLiteral("stigs-per-asset"), QStringLiteral("STIGs mapped to each Asset."), QStringLiteral("count"), QStringLiteral("5"));
+    QCommandLineOption rules(QStringLiteral("rules"), QStringLiteral("Rules in each STIG."), QStringLiteral("count"), QStringLiteral("200"));
+    QCommandLineOption ccis(QStringLiteral("ccis"), QStringLiteral("Number of CCIs."), QStringLiteral("count"), QStringLiteral("500"));
+    QCommandLineOption seed(QStringLiteral("seed"), QStringLiteral("Seed of the generated content."), QStringLiteral("seed"), QStringLiteral("1"));
+    QCommandLineOption dir(QStringLiteral("dir"), QStringLiteral("Keep the database and generated files in this directory instead of a temporary one."), QStringLiteral("directory"));
+    QCommandLineOption output(QStringLiteral("output"), QStringLiteral("Write the JSON results to this file instead of stdout."), QStringLiteral("file"));
+    QCommandLineOption trace(QStringLiteral("trace"), QStringLiteral("Write a Chrome/Perfetto trace of the run to this file."), QStringLiteral("file"));
+    QCommandLineOption memoryBudget(QStringLiteral("memory-budget"), QStringLiteral("MiB of memory the workers try to stay within (0 is unlimited)."), QStringLiteral("mib"), QStringLiteral("0"));
+    parser.addOptions({assets, stigs, stigsPerAsset, rules, ccis, seed, dir, output, trace, memoryBudget});
+    parser.process(a);
+
+    //never touch the user's database
+    QTemporaryDir tmpDir;
+    QString workDir = parser.isSet(dir) ? parser.value(dir) : tmpDir.path();
+    if (!QDir().mkpath(workDir) || QFile::exists(QDir(workDir).filePath(QStringLiteral("STIGQter.db"))))
+    {
+        std::cerr << "The directory " << workDir.toStdString() << " must be writable and must not already have a STIGQter.db." << std::endl;
+        return EXIT_FAILURE;
+    }
+    DbManager::SetDefaultPath(QDir(workDir).filePath(QStringLiteral("STIGQter.db")));
+    qInstallMessageHandler(MessageHandler);
+
+    Benchmark b(workDir);
+    b.SetScale(parser.value(assets).toInt(), parser.value(stigs).toInt(), parser.value(stigsPerAsset).toInt(), parser.value(rules).toInt(), parser.value(ccis).toInt());
+    b.SetSeed(parser.value(seed).toUInt());
+    MemoryMonitor::SetBudget(parser.value(memoryBudget).toLongLong() * 1024 * 1024);
+    TraceRecorder::SetEnabled(parser.isSet(trace));
+    QByteArray results = QJsonDocument(b.Run()).toJson();
+    TraceRecorder::SetEnabled(false);
+    if (parser.isSet(trace) && !TraceRecorder::Write(parser.value(trace)))
+    {
+        std::cerr << "Unable to write " << parser.value(trace).toStdString() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (parser.isSet(output))
+    {
+        QFile f(parser.value(output));
+        if (!f.open(QIODevice::WriteOnly))
+        {
+            std::cerr << "Unable to write " << parser.value(output).toStdString() << std::endl;
+            return EXIT_FAILURE;
+        }
+        f.write(results);
+        f.close();
+    }
+    else
+        std::cout << results.toStdString();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,304 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include "cklcheckmodel.h"
+#include "common.h"
+#include "dbmanager.h"
+#include "fixturegenerator.h"
+#include "memorymonitor.h"
+#include "querystats.h"
+#include "workerassetload.h"
+#include "workercklexport.h"
+#include "workercklimport.h"
+#include "workeremassreport.h"
+#include "workerfindingsreport.h"
+#include "workerhtml.h"
+#include "workerstigadd.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+/**
+ * @class Benchmark
+ * @brief Time the import, export, and report paths against a scratch
+ * database filled with generated content.
+ *
+ * Each scenario records its wall time, the rows it processed, the
+ * queries it issued, and the peak memory of the process while it ran
+ * so that the results of two versions can be compared. The resident
+ * memory is sampled every 10ms during each scenario, so a scenario's
+ * peak is not hidden by an earlier scenario's.
+ */
+
+/**
+ * @brief Benchmark::Benchmark
+ * @param dir
+ *
+ * Main constructor. Generated content and exports are written to
+ * @a dir.
+ */
+Benchmark::Benchmark(const QString &dir) :
+    _dir(dir),
+    _assets(50),
+    _stigs(10),
+    _stigsPerAsset(5),
+    _rules(200),
+    _ccis(500),
+    _seed(1),
+    _warnings(0)
+{
+}
+
+/**
+ * @brief Benchmark::Run
+ * @return The scale of the run and the results of every scenario.
+ *
+ * The scenarios build on each other, so they are always run in the
+ * same order.
+ */
+QJsonObject Benchmark::Run()
+{
+    QDir dir(_dir);
+    dir.mkpath(QStringLiteral("stigs"));
+    dir.mkpath(QStringLiteral("ckls"));
+    dir.mkpath(QStringLiteral("html"));
+    FixtureGenerator generator(_seed);
+    int stigsPerAsset = std::min(_stigsPerAsset, _stigs);
+    qint64 checks = static_cast<qint64>(_assets) * stigsPerAsset * _rules;
+
+    Scenario(QStringLiteral("cci-add"), [&]() {
+        return static_cast<qint64>(generator.AddCCIs(_ccis));
+    });
+
+    QStringList stigFiles;
+    for (int i = 1; i <= _stigs; i++)
+        stigFiles.append(generator.WriteSTIG(dir.filePath(QStringLiteral("stigs")), i, _rules));
+
+    Scenario(QStringLiteral("stig-import"), [&]() {
+        WorkerSTIGAdd w;
+        w.AddSTIGs(stigFiles);
+        RunWorker(&w);
+        return static_cast<qint64>(_stigs) * _rules;
+    });
+
+    Scenario(QStringLiteral("asset-stig-fanout"), [&]() {
+        DbManager db;
+        QVector<STIG> stigs = db.GetSTIGs();
+        for (int i = 0; i < _assets && !stigs.isEmpty(); i++)
+        {
+            Asset a;
+            a.hostName = QStringLiteral("SYNTHETIC-") + QString::number(i + 1).rightJustified(5, '0');
+            if (!db.AddAsset(a))
+            {
+                _warnings++;
+                continue;
+            }
+            for (int j = 0; j < stigsPerAsset; j++)
+            {
+                if (!db.AddSTIGToAsset(stigs.at((i + j) % stigs.count()), a))
+                    _warnings++;
+            }
+        }
+        return checks;
+    });
+
+    Scenario(QStringLiteral("asset-model-load"), [&]() {
+        DbManager db;
+        qint64 rows = 0;
+        Q_FOREACH (const Asset &a, db.GetAssets())
+        {
+            WorkerAssetLoad w;
+            w.AddAsset(a);
+            CKLCheckModel model;
+            QObject::connect(&w, &WorkerAssetLoad::ChecksLoaded, [&model](int loadId [[maybe_unused]], const QVector<CKLCheckRow> &loaded) {
+                model.Append(loaded);
+            });
+            RunWorker(&w);
+            rows += model.rowCount();
+        }
+        return rows;
+    });
+
+    Scenario(QStringLiteral("ckl-export"), [&]() {
+        WorkerCKLExport w;
+        w.SetExportDir(dir.filePath(QStringLiteral("ckls")));
+        RunWorker(&w);
+        return checks;
+    });
+
+    Scenario(QStringLiteral("emass-report"), [&]() {
+        WorkerEMASSReport w;
+        w.SetReportName(dir.filePath(QStringLiteral("emass.xlsx")));
+        RunWorker(&w);
+        return checks;
+    });
+
+    Scenario(QStringLiteral("findings-report"), [&]() {
+        WorkerFindingsReport w;
+        w.SetReportName(dir.filePath(QStringLiteral("findings.xlsx")));
+        RunWorker(&w);
+        return checks;
+    });
+
+    Scenario(QStringLiteral("html-export"), [&]() {
+        WorkerHTML w;
+        w.SetDir(dir.filePath(QStringLiteral("html")));
+        RunWorker(&w);
+        return static_cast<qint64>(_stigs) * _rules;
+    });
+
+    //the exported checklists are imported into a database without Assets
+    {
+        DbManager db;
+        Q_FOREACH (const Asset &a, db.GetAssets())
+        {
+            QVector<int> stigIds;
+            Q_FOREACH (const STIG &s, a.GetSTIGs())
+                stigIds.append(s.id);
+            db.UpdateAssetSTIGs(a, {}, stigIds);
+            db.DeleteAsset(a);
+        }
+    }
+
+    Scenario(QStringLiteral("ckl-import"), [&]() {
+        QStringList ckls;
+        QDir cklDir(dir.filePath(QStringLiteral("ckls")));
+        Q_FOREACH (const QString &fileName, cklDir.entryList({QStringLiteral("*.ckl")}, QDir::Files, QDir::Name))
+            ckls.append(cklDir.filePath(fileName));
+        WorkerCKLImport w;
+        w.AddCKLs(ckls);
+        RunWorker(&w);
+        return checks;
+    });
+
+    QJsonObject scale{{QStringLiteral("assets"), _assets},
+                      {QStringLiteral("stigs"), _stigs},
+                      {QStringLiteral("stigsPerAsset"), stigsPerAsset},
+                      {QStringLiteral("rules"), _rules},
+                      {QStringLiteral("ccis"), _ccis}};
+    return QJsonObject{{QStringLiteral("version"), VERSION},
+                       {QStringLiteral("seed"), static_cast<qint64>(_seed)},
+                       {QStringLiteral("scale"), scale},
+                       {QStringLiteral("scenarios"), _results},
+                       {QStringLiteral("queryStats"), QueryStats::ToJson()}};
+}
+
+/**
+ * @brief Benchmark::SetScale
+ * @param assets
+ * @param stigs
+ * @param stigsPerAsset
+ * @param rules
+ * @param ccis
+ *
+ * Set how much content is generated: the number of @a assets, the
+ * number of @a stigs with @a rules checks each, how many STIGs are
+ * mapped to each Asset, and the number of @a ccis the rules refer to.
+ */
+void Benchmark::SetScale(int assets, int stigs, int stigsPerAsset, int rules, int ccis)
+{
+    _assets = assets;
+    _stigs = stigs;
+    _stigsPerAsset = stigsPerAsset;
+    _rules = rules;
+    _ccis = ccis;
+}
+
+/**
+ * @brief Benchmark::SetSeed
+ * @param seed
+ *
+ * The same @a seed generates the same content.
+ */
+void Benchmark::SetSeed(quint32 seed)
+{
+    _seed = seed;
+}
+
+/**
+ * @brief Benchmark::Scenario
+ * @param name
+ * @param scenario
+ *
+ * Run and measure the @a scenario, which returns the number of rows
+ * it processed.
+ */
+void Benchmark::Scenario(const QString &name, const std::function<qint64()> &scenario)
+{
+    std::cerr << "Running " << name.toStdString() << "…" << std::endl;
+    _warnings = 0;
+    quint64 queries = DbManager::QueryCount();
+
+    //the scenario runs on this thread, so its memory is sampled from another
+    MemoryUsage usage;
+    qint64 startRSS = MemoryMonitor::Resident();
+    usage.Sample(startRSS);
+    std::atomic<bool> running(true);
+    std::thread sampler([&usage, &running]() {
+        while (running)
+        {
+            usage.Sample(MemoryMonitor::Resident());
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+    MemoryUsage::SetCurrent(&usage);
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 rows = scenario();
+    double ms = static_cast<double>(timer.nsecsElapsed()) / 1000000.0;
+
+    MemoryUsage::SetCurrent(nullptr);
+    running = false;
+    sampler.join();
+    usage.Sample(MemoryMonitor::Resident());
+
+    QJsonObject result{{QStringLiteral("name"), name},
+                       {QStringLiteral("ms"), ms},
+                       {QStringLiteral("rows"), rows},
+                       {QStringLiteral("rowsPerSecond"), ms > 0 ? static_cast<double>(rows) * 1000.0 / ms : 0.0},
+                       {QStringLiteral("queries"), static_cast<qint64>(DbManager::QueryCount() - queries)},
+                       {QStringLiteral("startRSS"), startRSS},
+                       {QStringLiteral("peakRSS"), usage.PeakResident()},
+                       {QStringLiteral("peakRSSDelta"), usage.PeakResident() - startRSS},
+                       {QStringLiteral("peakTracked"), usage.PeakTracked()},
+                       {QStringLiteral("warnings"), _warnings}};
+    _results.append(result);
+}
+
+/**
+ * @brief Benchmark::RunWorker
+ * @param worker
+ *
+ * Run the @a worker on this thread, counting the warnings it raises.
+ */
+void Benchmark::RunWorker(Worker *worker)
+{
+    QObject::connect(worker, &Worker::ThrowWarning, [this](const QString &title [[maybe_unused]], const QString &message [[maybe_unused]]) {
+        _warnings++;
+    });
+    worker->process();
+}
@@ -0,0 +1,53 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "worker.h"
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+
+#include <functional>
+
+class Benchmark
+{
+public:
+    explicit Benchmark(const QString &dir);
+    QJsonObject Run();
+    void SetScale(int assets, int stigs, int stigsPerAsset, int rules, int ccis);
+    void SetSeed(quint32 seed);
+
+private:
+    void Scenario(const QString &name, const std::function<qint64()> &scenario);
+    void RunWorker(Worker *worker);
+    QString _dir;
+    int _assets;
+    int _stigs;
+    int _stigsPerAsset;
+    int _rules;
+    int _ccis;
+    quint32 _seed;
+    int _warnings; //raised by the running scenario
+    QJsonArray _results;
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,245 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cklcache.h"
+#include "common.h"
+#include "dbmanager.h"
+
+#include <QBuffer>
+
+/**
+ * @class CKLCache
+ * @brief The STIG_INFO block and most of the STIG_DATA attributes of
+ * a CKL file depend only on the @a STIG, not on the @a Asset being
+ * exported.
+ *
+ * These blocks are serialized (and XML-escaped) once per @a STIG and
+ * reused for every checklist that includes the @a STIG. Only the
+ * asset-specific severity, status, finding details, comments and
+ * severity override are written for each @a CKLCheck.
+ */
+
+/**
+ * @brief CKLCache::CKLCache
+ * @param legacyIds
+ *
+ * Main constructor. When @a legacyIds is set, the LEGACY_ID
+ * attributes of each check are included in the VULN blocks.
+ */
+CKLCache::CKLCache(bool legacyIds) : _legacyIds(legacyIds)
+{
+}
+
+/**
+ * @brief CKLCache::WriteSTIG
+ * @param stream
+ * @param stig
+ * @param checks
+ *
+ * Writes the STIG_INFO and VULN blocks of the @a stig for the
+ * provided @a checks. The iSTIG element must already be open on the
+ * @a stream.
+ *
+ * When a check's @a STIGCheck is not cached, the @a stig is cached
+ * again in case it changed. A check whose @a STIGCheck still cannot
+ * be found is left out with a warning.
+ */
+void CKLCache::WriteSTIG(QXmlStreamWriter &stream, const STIG &stig, const QVector<CKLCheck> &checks)
+{
+    if (!_stigInfo.contains(stig.id))
+        Load(stig);
+
+    //close the pending start tag before writing the cached fragments directly to the device
+    stream.writeCharacters(QString());
+    QIODevice *device = stream.device();
+    device->write(_stigInfo.value(stig.id));
+
+    bool reloaded = false;
+    Q_FOREACH (const CKLCheck &cc, checks)
+    {
+        if (!reloaded && !_vulns.value(stig.id).contains(cc.stigCheckId))
+        {
+            Load(stig);
+            reloaded = true;
+        }
+        VulnFragment vuln = _vulns.value(stig.id).value(cc.stigCheckId);
+        if (vuln.head.isEmpty())
+        {
+            Warning(QStringLiteral("Missing STIG Check"), "Check " + QString::number(cc.id) + " of " + PrintSTIG(stig) + " refers to a STIG check that no longer exists and was left out of the checklist.");
+            continue;
+        }
+        Severity severity = (cc.severityOverride == Severity::none) ? vuln.severity : cc.severityOverride;
+
+        device->write(vuln.head);
+        WriteSTIGData(stream, QStringLiteral("Severity"), GetSeverity(severity, false));
+        device->write(vuln.tail);
+
+        WriteXMLEntry(stream, QStringLiteral("STATUS"), GetStatus(cc.status, true)); //STATUS
+        WriteXMLEntry(stream, QStringLiteral("FINDING_DETAILS"), cc.findingDetails); //FINDING_DETAILS
+        WriteXMLEntry(stream, QStringLiteral("COMMENTS"), cc.comments); //COMMENTS
+        WriteXMLEntry(stream, QStringLiteral("SEVERITY_OVERRIDE"), GetSeverity(cc.severityOverride, false)); //SEVERITY_OVERRIDE
+        WriteXMLEntry(stream, QStringLiteral("SEVERITY_JUSTIFICATION"), cc.severityJustification); //SEVERITY_JUSTIFICATION
+        device->write("</VULN>");
+    }
+}
+
+/**
+ * @brief CKLCache::Load
+ * @param stig
+ *
+ * Serializes the STIG_INFO block and the static portions of the VULN
+ * blocks of the @a stig.
+ */
+void CKLCache::Load(const STIG &stig)
+{
+    DbManager db;
+
+    if (_ccis.isEmpty())
+    {
+        Q_FOREACH (const CCI &cci, db.GetCCIs())
+        {
+            _ccis.insert(cci.id, PrintCCI(cci));
+        }
+    }
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QXmlStreamWriter stream(&buffer);
+
+    stream.writeStartElement(QStringLiteral("STIG_INFO"));
+
+    stream.writeStartElement(QStringLiteral("SI_DATA"));
+    WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("version")); //SID_NAME
+    WriteXMLEntry(stream, QStringLiteral("SID_DATA"), QString::number(stig.version)); //SID_DATA
+    stream.writeEndElement(); //SI_DATA
+
+    stream.writeStartElement(QStringLiteral("SI_DATA"));
+    WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("stigid")); //SID_NAME
+    WriteXMLEntry(stream, QStringLiteral("SID_DATA"), stig.benchmarkId); //SID_DATA
+    stream.writeEndElement(); //SI_DATA
+
+    stream.writeStartElement(QStringLiteral("SI_DATA"));
+    WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("description")); //SID_NAME
+    WriteXMLEntry(stream, QStringLiteral("SID_DATA"), stig.description); //SID_DATA
+    stream.writeEndElement(); //SI_DATA
+
+    stream.writeStartElement(QStringLiteral("SI_DATA"));
+    WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("filename")); //SID_NAME
+    WriteXMLEntry(stream, QStringLiteral("SID_DATA"), stig.fileName); //SID_DATA
+    stream.writeEndElement(); //SI_DATA
+
+    stream.writeStartElement(QStringLiteral("SI_DATA"));
+    WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("releaseinfo")); //SID_NAME
+    WriteXMLEntry(stream, QStringLiteral("SID_DATA"), stig.release); //SID_DATA
+    stream.writeEndElement(); //SI_DATA
+
+    stream.writeStartElement(QStringLiteral("SI_DATA"));
+    WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("title")); //SID_NAME
+    WriteXMLEntry(stream, QStringLiteral("SID_DATA"), stig.title); //SID_DATA
+    stream.writeEndElement(); //SI_DATA
+
+    stream.writeEndElement(); //STIG_INFO
+    _stigInfo.insert(stig.id, buffer.data());
+
+    QString stigRef = stig.title + " :: Version " + QString::number(stig.version) + ", " + stig.release;
+    QHash<int, VulnFragment> vulns;
+    Q_FOREACH (const STIGCheck &sc, db.GetSTIGChecks(stig))
+    {
+        VulnFragment vuln;
+        vuln.severity = sc.severity;
+
+        buffer.buffer().clear();
+        buffer.seek(0);
+        WriteSTIGData(stream, QStringLiteral("Vuln_Num"), sc.vulnNum);
+        vuln.head = "<VULN>" + buffer.data();
+
+        buffer.buffer().clear();
+        buffer.seek(0);
+        WriteSTIGData(stream, QStringLiteral("Group_Title"), sc.groupTitle);
+        WriteSTIGData(stream, QStringLiteral("Rule_ID"), sc.rule);
+        WriteSTIGData(stream, QStringLiteral("Rule_Ver"), sc.ruleVersion);
+        WriteSTIGData(stream, QStringLiteral("Rule_Title"), sc.title);
+        WriteSTIGData(stream, QStringLiteral("Vuln_Discuss"), sc.vulnDiscussion);
+        WriteSTIGData(stream, QStringLiteral("IA_Controls"), sc.iaControls);
+        WriteSTIGData(stream, QStringLiteral("Check_Content"), sc.check);
+        WriteSTIGData(stream, QStringLiteral("Fix_Text"), sc.fix);
+        WriteSTIGData(stream, QStringLiteral("False_Positives"), sc.falsePositives);
+        WriteSTIGData(stream, QStringLiteral("False_Negatives"), sc.falseNegatives);
+        WriteSTIGData(stream, QStringLiteral("Documentable"), PrintTrueFalse(sc.documentable));
+        WriteSTIGData(stream, QStringLiteral("Mitigations"), sc.mitigations);
+        WriteSTIGData(stream, QStringLiteral("Potential_Impact"), sc.potentialImpact);
+        WriteSTIGData(stream, QStringLiteral("Third_Party_Tools"), sc.thirdPartyTools);
+        WriteSTIGData(stream, QStringLiteral("Mitigation_Control"), sc.mitigationControl);
+        WriteSTIGData(stream, QStringLiteral("Responsibility"), sc.responsibility);
+        WriteSTIGData(stream, QStringLiteral("Security_Override_Guidance"), sc.severityOverrideGuidance);
+        WriteSTIGData(stream, QStringLiteral("Check_Content_Ref"), sc.checkContentRef);
+        WriteSTIGData(stream, QStringLiteral("Weight"), QString::number(sc.weight));
+        WriteSTIGData(stream, QStringLiteral("STIGRef"), stigRef);
+        WriteSTIGData(stream, QStringLiteral("TargetKey"), sc.targetKey);
+        Q_FOREACH (int cciId, sc.cciIds)
+        {
+            if (_ccis.contains(cciId))
+                WriteSTIGData(stream, QStringLiteral("CCI_REF"), _ccis.value(cciId));
+        }
+        if (_legacyIds)
+        {
+            Q_FOREACH (const QString &legacyId, sc.legacyIds)
+            {
+                WriteSTIGData(stream, QStringLiteral("LEGACY_ID"), legacyId);
+            }
+        }
+        vuln.tail = buffer.data();
+
+        //the VULN element is closed by WriteSTIG() after the asset-specific data
+        vulns.insert(sc.id, vuln);
+    }
+    _vulns.insert(stig.id, vulns);
+}
+
+/**
+ * @brief CKLCache::WriteSTIGData
+ * @param stream
+ * @param attribute
+ * @param data
+ *
+ * Write a STIG_DATA element with the VULN_ATTRIBUTE @a attribute and
+ * ATTRIBUTE_DATA @a data to the XML stream.
+ */
+void CKLCache::WriteSTIGData(QXmlStreamWriter &stream, const QString &attribute, const QString &data)
+{
+    stream.writeStartElement(QStringLiteral("STIG_DATA"));
+    WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), attribute); //VULN_ATTRIBUTE
+    WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), data); //ATTRIBUTE_DATA
+    stream.writeEndElement(); //STIG_DATA
+}
+
+/**
+ * @brief CKLCache::WriteXMLEntry
+ * @param stream
+ * @param name
+ * @param value
+ *
+ * Write an element to the XML stream
+ */
+void CKLCache::WriteXMLEntry(QXmlStreamWriter &stream, const QString &name, const QString &value)
+{
+    stream.writeStartElement(name);
+    stream.writeCharacters(value);
+    stream.writeEndElement();
+}
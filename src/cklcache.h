@@ -0,0 +1,53 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CKLCACHE_H
+#define CKLCACHE_H
+
+#include "cklcheck.h"
+#include "stig.h"
+#include "stigcheck.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QXmlStreamWriter>
+
+class CKLCache
+{
+public:
+    explicit CKLCache(bool legacyIds = true);
+    void WriteSTIG(QXmlStreamWriter &stream, const STIG &stig, const QVector<CKLCheck> &checks);
+
+private:
+    struct VulnFragment
+    {
+        QByteArray head; /**< VULN start through the Vuln_Num attribute */
+        QByteArray tail; /**< Group_Title through the CCI and legacy references */
+        Severity severity; /**< STIG-defined severity of the check */
+    };
+    bool _legacyIds;
+    QHash<int, QString> _ccis;
+    QHash<int, QByteArray> _stigInfo;
+    QHash<int, QHash<int, VulnFragment>> _vulns;
+    void Load(const STIG &stig);
+    static void WriteSTIGData(QXmlStreamWriter &stream, const QString &attribute, const QString &data);
+    static void WriteXMLEntry(QXmlStreamWriter &stream, const QString &name, const QString &value);
+};
+
+#endif // CKLCACHE_H
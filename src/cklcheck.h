@@ -70,6 +70,20 @@ public:
 
 Q_DECLARE_METATYPE(CKLCheck);
 
+struct CKLCheckRow
+{
+    int id; /**< CKLCheck database id */
+    int stigCheckId; /**< STIGCheck database id */
+    Status status;
+    Severity severityOverride;
+    Severity stigSeverity; /**< severity defined by the STIGCheck */
+    Severity severity; /**< effective severity, including the override */
+    QString rule;
+    QString vulnNum;
+};
+
+Q_DECLARE_METATYPE(CKLCheckRow);
+
 QString PrintCKLCheck(const CKLCheck &cklCheck);
 
 #endif // CKLCHECK_H
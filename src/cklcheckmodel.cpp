@@ -0,0 +1,200 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cklcheckmodel.h"
+
+#include <QColor>
+#include <QFont>
+
+/**
+ * @class CKLCheckModel
+ * @brief The list of an @a Asset's @a CKLChecks as displayed in the
+ * @a AssetView.
+ *
+ * Each check is stored as a compact row of database ids, compliance
+ * @a Status, @a Severity, rule and vulnerability number. The rows are
+ * appended in chunks as they are read. The text, color, and font of
+ * each check are only computed when the view requests them, so
+ * assets with thousands of checks remain responsive.
+ */
+
+/**
+ * @brief CKLCheckModel::CKLCheckModel
+ * @param parent
+ *
+ * Main constructor.
+ */
+CKLCheckModel::CKLCheckModel(QObject *parent) : QAbstractListModel(parent)
+{
+}
+
+/**
+ * @brief CKLCheckModel::Append
+ * @param rows
+ *
+ * Add the @a rows to the end of the model.
+ */
+void CKLCheckModel::Append(const QVector<CKLCheckRow> &rows)
+{
+    if (rows.isEmpty())
+        return;
+    int first = _rows.count();
+    beginInsertRows(QModelIndex(), first, first + rows.count() - 1);
+    _rows.append(rows);
+    for (int i = first; i < _rows.count(); i++)
+    {
+        _index.insert(_rows.at(i).id, i);
+    }
+    endInsertRows();
+}
+
+/**
+ * @brief CKLCheckModel::Clear
+ *
+ * Remove every check from the model.
+ */
+void CKLCheckModel::Clear()
+{
+    beginResetModel();
+    _rows.clear();
+    _index.clear();
+    endResetModel();
+}
+
+/**
+ * @brief CKLCheckModel::rowCount
+ * @param parent
+ * @return The number of @a CKLChecks in the model.
+ */
+int CKLCheckModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return _rows.count();
+}
+
+/**
+ * @brief CKLCheckModel::data
+ * @param index
+ * @param role
+ * @return The displayed data for the @a CKLCheck at the @a index.
+ *
+ * Open findings are bolded and colored by their @a Severity so that
+ * attention is drawn to them.
+ */
+QVariant CKLCheckModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= _rows.count())
+        return QVariant();
+
+    const CKLCheckRow &row = _rows.at(index.row());
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case RuleRole:
+        return row.rule;
+    case Qt::ToolTipRole:
+        return row.rule + QStringLiteral(" (") + row.vulnNum + QStringLiteral(")");
+    case VulnNumRole:
+        return row.vulnNum;
+    case Qt::FontRole:
+    {
+        QFont f;
+        f.setBold(row.status == Status::Open);
+        return f;
+    }
+    case Qt::ForegroundRole:
+        switch (row.status)
+        {
+        case Status::Open:
+            switch (row.severity)
+            {
+            case Severity::high:
+                return QColor(Qt::red);
+            case Severity::medium:
+                return QColor("orange");
+            case Severity::low:
+                return QColor(Qt::yellow);
+            default:
+                return QColor(Qt::black);
+            }
+        case Status::NotAFinding:
+            return QColor(Qt::green);
+        case Status::NotApplicable:
+            return QColor(Qt::gray);
+        default:
+            return QColor(Qt::black);
+        }
+    case IdRole:
+        return row.id;
+    case STIGCheckIdRole:
+        return row.stigCheckId;
+    case StatusRole:
+        return row.status;
+    case SeverityRole:
+        return row.severity;
+    case STIGSeverityRole:
+        return row.stigSeverity;
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief CKLCheckModel::Find
+ * @param id
+ * @return The row of the @a CKLCheck with the database @a id, or -1
+ * when the check is not in the model.
+ */
+int CKLCheckModel::Find(int id) const
+{
+    return _index.value(id, -1);
+}
+
+/**
+ * @brief CKLCheckModel::SetSeverity
+ * @param row
+ * @param severity
+ *
+ * Display the check at @a row with the provided @a severity. When the
+ * @a severity matches the @a STIGCheck's, the override is removed.
+ */
+void CKLCheckModel::SetSeverity(int row, Severity severity)
+{
+    CKLCheckRow &r = _rows[row];
+    r.severityOverride = (r.stigSeverity == severity) ? Severity::none : severity;
+    r.severity = (r.severityOverride == Severity::none) ? r.stigSeverity : r.severityOverride;
+    QModelIndex i = index(row);
+    Q_EMIT dataChanged(i, i);
+}
+
+/**
+ * @brief CKLCheckModel::SetStatus
+ * @param row
+ * @param status
+ *
+ * Display the check at @a row with the provided compliance
+ * @a status.
+ */
+void CKLCheckModel::SetStatus(int row, Status status)
+{
+    _rows[row].status = status;
+    QModelIndex i = index(row);
+    Q_EMIT dataChanged(i, i);
+}
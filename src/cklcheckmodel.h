@@ -0,0 +1,59 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CKLCHECKMODEL_H
+#define CKLCHECKMODEL_H
+
+#include "cklcheck.h"
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QVector>
+
+class CKLCheckModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role
+    {
+        IdRole = Qt::UserRole,
+        STIGCheckIdRole,
+        StatusRole,
+        SeverityRole,
+        STIGSeverityRole,
+        RuleRole,
+        VulnNumRole
+    };
+
+    explicit CKLCheckModel(QObject *parent = nullptr);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    void Append(const QVector<CKLCheckRow> &rows);
+    void Clear();
+    int Find(int id) const;
+    void SetSeverity(int row, Severity severity);
+    void SetStatus(int row, Status status);
+
+private:
+    QVector<CKLCheckRow> _rows;
+    QHash<int, int> _index;
+};
+
+#endif // CKLCHECKMODEL_H
@@ -0,0 +1,92 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cklcheckmodel.h"
+#include "cklcheckproxymodel.h"
+
+/**
+ * @class CKLCheckProxyModel
+ * @brief Filters and sorts the @a CKLCheckModel without querying the
+ * database.
+ *
+ * Checks are sorted by rule. The filters are only applied when they
+ * change, so that a check does not disappear from the view while the
+ * user is editing its compliance @a Status.
+ */
+
+/**
+ * @brief CKLCheckProxyModel::CKLCheckProxyModel
+ * @param parent
+ *
+ * Main constructor.
+ */
+CKLCheckProxyModel::CKLCheckProxyModel(QObject *parent) : QSortFilterProxyModel(parent),
+    _filterSeverity(false),
+    _filterStatus(false),
+    _severity(Severity::none),
+    _status(Status::NotReviewed)
+{
+    setDynamicSortFilter(false);
+}
+
+/**
+ * @brief CKLCheckProxyModel::SetFilter
+ * @param severity
+ * @param status
+ *
+ * Only show the checks matching the @a severity and @a status. A
+ * filter of "All" shows every check.
+ */
+void CKLCheckProxyModel::SetFilter(const QString &severity, const QString &status)
+{
+    _filterSeverity = (severity != QStringLiteral("All"));
+    _severity = GetSeverity(severity);
+    _filterStatus = (status != QStringLiteral("All"));
+    _status = GetStatus(status);
+    invalidate();
+}
+
+/**
+ * @brief CKLCheckProxyModel::filterAcceptsRow
+ * @param sourceRow
+ * @param sourceParent
+ * @return @c true when the check matches the severity and status
+ * filters.
+ */
+bool CKLCheckProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    QModelIndex i = sourceModel()->index(sourceRow, 0, sourceParent);
+    if (_filterSeverity && (i.data(CKLCheckModel::SeverityRole).toInt() != _severity))
+        return false;
+    if (_filterStatus && (i.data(CKLCheckModel::StatusRole).toInt() != _status))
+        return false;
+    return true;
+}
+
+/**
+ * @brief CKLCheckProxyModel::lessThan
+ * @param left
+ * @param right
+ * @return @c true when the @a left check should be displayed before
+ * the @a right check.
+ */
+bool CKLCheckProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    return (left.data(CKLCheckModel::RuleRole).toString().compare(right.data(CKLCheckModel::RuleRole).toString()) < 0);
+}
@@ -0,0 +1,47 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CKLCHECKPROXYMODEL_H
+#define CKLCHECKPROXYMODEL_H
+
+#include "cklcheck.h"
+#include "stigcheck.h"
+
+#include <QSortFilterProxyModel>
+
+class CKLCheckProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit CKLCheckProxyModel(QObject *parent = nullptr);
+    void SetFilter(const QString &severity, const QString &status);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    bool _filterSeverity;
+    bool _filterStatus;
+    Severity _severity;
+    Status _status;
+};
+
+#endif // CKLCHECKPROXYMODEL_H
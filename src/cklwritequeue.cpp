@@ -0,0 +1,339 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cklwritequeue.h"
+#include "common.h"
+#include "dbmanager.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+
+/**
+ * @class CKLWriteQueue
+ * @brief Write-behind queue of the @a CKLChecks edited in an
+ * @a AssetView.
+ *
+ * Only the latest version of each edited check is kept. The queued
+ * checks are written to the database in batched transactions from a
+ * background thread, so the user interface is not blocked while
+ * another connection holds the database. Checks that cannot be
+ * written are kept and retried, waiting twice as long after each
+ * failure (up to 32 seconds). The user is warned once the writes
+ * have failed five times in a row.
+ *
+ * The writes do not go through the @a JobScheduler, so they may run
+ * alongside a @a DatabaseWriter job. Each write is one short
+ * transaction on the checks of one @a Asset; SQLite serializes it
+ * with the job's transactions, and a write that times out waiting on
+ * the job is retried.
+ */
+
+/**
+ * @brief CKLWriteQueue::CKLWriteQueue
+ * @param parent
+ *
+ * Main constructor.
+ */
+CKLWriteQueue::CKLWriteQueue(QObject *parent) : QObject(parent),
+    _failures(0)
+{
+    //one thread writes the changes in order; it exits when the tab is idle
+    _pool.setMaxThreadCount(1);
+
+    //gather the changes for a little while before writing them
+    _timer.setSingleShot(true);
+    _timer.setInterval(500);
+    connect(&_timer, SIGNAL(timeout()), this, SLOT(Flush()));
+    connect(this, SIGNAL(PendingChanged(int)), this, SLOT(Schedule(int)));
+}
+
+/**
+ * @brief CKLWriteQueue::~CKLWriteQueue
+ *
+ * Destructor. The pending changes are written before the queue is
+ * removed.
+ */
+CKLWriteQueue::~CKLWriteQueue()
+{
+    Drain();
+}
+
+/**
+ * @brief CKLWriteQueue::Add
+ * @param cklCheck
+ *
+ * Queue the edited @a cklCheck to be written, replacing any earlier
+ * edits of the same check.
+ */
+void CKLWriteQueue::Add(const CKLCheck &cklCheck)
+{
+    int count = 0;
+    {
+        QMutexLocker lock(&_mutex);
+        _statuses.remove(cklCheck.id);
+        _checks.insert(cklCheck.id, cklCheck);
+        count = PendingHelper();
+    }
+    Q_EMIT PendingChanged(count);
+}
+
+/**
+ * @overload CKLWriteQueue::Add(const CKLCheck &cklCheck)
+ * @brief CKLWriteQueue::Add
+ * @param ids
+ * @param status
+ *
+ * Queue the compliance @a status of each @a CKLCheck in @a ids to be
+ * written.
+ */
+void CKLWriteQueue::Add(const QVector<int> &ids, Status status)
+{
+    int count = 0;
+    {
+        QMutexLocker lock(&_mutex);
+        Q_FOREACH (int id, ids)
+        {
+            auto i = _checks.find(id);
+            if (i != _checks.end())
+                i->status = status;
+            else
+                _statuses.insert(id, status);
+        }
+        count = PendingHelper();
+    }
+    Q_EMIT PendingChanged(count);
+}
+
+/**
+ * @brief CKLWriteQueue::Drain
+ * @return @c True when every queued change has been written to the
+ * database. Otherwise, @c false.
+ *
+ * Write the queued changes and wait for them to finish.
+ */
+bool CKLWriteQueue::Drain()
+{
+    _timer.stop();
+    QtConcurrent::run(&_pool, [this]() { Write(); });
+    _pool.waitForDone();
+    return Pending() == 0;
+}
+
+/**
+ * @brief CKLWriteQueue::GetCKLCheck
+ * @param id
+ * @return The @a CKLCheck with the database @a id, including the
+ * changes that have not been written yet.
+ */
+CKLCheck CKLWriteQueue::GetCKLCheck(int id)
+{
+    CKLCheck ret;
+    bool found = false;
+    bool hasStatus = false;
+    Status status = Status::NotReviewed;
+    {
+        QMutexLocker lock(&_mutex);
+        auto i = _checks.constFind(id);
+        if (i != _checks.constEnd())
+            return i.value();
+        auto j = _writingChecks.constFind(id);
+        if (j != _writingChecks.constEnd())
+        {
+            ret = j.value();
+            found = true;
+        }
+        if (_statuses.contains(id))
+        {
+            status = _statuses.value(id);
+            hasStatus = true;
+        }
+        else if (_writingStatuses.contains(id))
+        {
+            status = _writingStatuses.value(id);
+            hasStatus = true;
+        }
+    }
+    if (!found)
+    {
+        DbManager db;
+        ret = db.GetCKLCheck(id);
+    }
+    if (hasStatus)
+        ret.status = status;
+    return ret;
+}
+
+/**
+ * @brief CKLWriteQueue::Overlay
+ * @param rows
+ *
+ * Apply the changes that have not been written yet to the @a rows
+ * read from the database.
+ */
+void CKLWriteQueue::Overlay(QVector<CKLCheckRow> &rows)
+{
+    QMutexLocker lock(&_mutex);
+    if (PendingHelper() == 0)
+        return;
+    for (CKLCheckRow &row : rows)
+    {
+        //the queued changes are newer than the changes being written
+        auto i = _checks.constFind(row.id);
+        if (i != _checks.constEnd())
+        {
+            row.status = i->status;
+            row.severityOverride = i->severityOverride;
+        }
+        else
+        {
+            auto j = _writingChecks.constFind(row.id);
+            if (j != _writingChecks.constEnd())
+            {
+                row.status = j->status;
+                row.severityOverride = j->severityOverride;
+            }
+            if (_statuses.contains(row.id))
+                row.status = _statuses.value(row.id);
+            else if (_writingStatuses.contains(row.id))
+                row.status = _writingStatuses.value(row.id);
+        }
+        row.severity = (row.severityOverride == Severity::none) ? row.stigSeverity : row.severityOverride;
+    }
+}
+
+/**
+ * @brief CKLWriteQueue::Pending
+ * @return The number of @a CKLChecks that have not been written to
+ * the database.
+ */
+int CKLWriteQueue::Pending()
+{
+    QMutexLocker lock(&_mutex);
+    return PendingHelper();
+}
+
+/**
+ * @brief CKLWriteQueue::Flush
+ *
+ * Write the queued changes in the background.
+ */
+void CKLWriteQueue::Flush()
+{
+    QtConcurrent::run(&_pool, [this]() { Write(); });
+}
+
+/**
+ * @brief CKLWriteQueue::Schedule
+ * @param count
+ *
+ * Start the countdown to write the queued changes when there are
+ * @a count changes pending. The countdown doubles after each failed
+ * write.
+ */
+void CKLWriteQueue::Schedule(int count)
+{
+    if (count > 0 && !_timer.isActive())
+    {
+        int failures = 0;
+        {
+            QMutexLocker lock(&_mutex);
+            failures = _failures;
+        }
+        _timer.start(500 << std::min(failures, 6));
+    }
+}
+
+/**
+ * @brief CKLWriteQueue::PendingHelper
+ * @return The number of queued and in-progress changes. The caller
+ * holds the mutex.
+ */
+int CKLWriteQueue::PendingHelper() const
+{
+    return _checks.count() + _statuses.count() + _writingChecks.count() + _writingStatuses.count();
+}
+
+/**
+ * @brief CKLWriteQueue::Write
+ *
+ * Write the queued changes to the database. This runs on the
+ * queue's background thread.
+ */
+void CKLWriteQueue::Write()
+{
+    {
+        QMutexLocker lock(&_mutex);
+        _writingChecks.swap(_checks);
+        _writingStatuses.swap(_statuses);
+    }
+    //only this thread modifies the changes being written
+    if (_writingChecks.isEmpty() && _writingStatuses.isEmpty())
+        return;
+
+    DbManager db;
+    bool checksWritten = db.UpdateCKLChecks(_writingChecks.values().toVector());
+
+    //status-only changes are written with one statement per status
+    QHash<int, QVector<int>> statusIds;
+    for (auto i = _writingStatuses.constBegin(); i != _writingStatuses.constEnd(); ++i)
+    {
+        statusIds[i.value()].append(i.key());
+    }
+    QVector<int> failedStatuses;
+    for (auto i = statusIds.constBegin(); i != statusIds.constEnd(); ++i)
+    {
+        if (!db.UpdateCKLCheckStatus(i.value(), static_cast<Status>(i.key())))
+            failedStatuses.append(i.key());
+    }
+
+    bool failed = !checksWritten || !failedStatuses.isEmpty();
+    int count = 0;
+    int failures = 0;
+    {
+        QMutexLocker lock(&_mutex);
+        failures = _failures = (failed ? _failures + 1 : 0);
+        //retry the changes that could not be written unless they were edited again
+        if (!checksWritten)
+        {
+            Q_FOREACH (CKLCheck cklCheck, _writingChecks)
+            {
+                if (_checks.contains(cklCheck.id))
+                    continue;
+                if (_statuses.contains(cklCheck.id))
+                    cklCheck.status = _statuses.take(cklCheck.id);
+                _checks.insert(cklCheck.id, cklCheck);
+            }
+        }
+        for (auto i = _writingStatuses.constBegin(); i != _writingStatuses.constEnd(); ++i)
+        {
+            if (failedStatuses.contains(i.value()) && !_checks.contains(i.key()) && !_statuses.contains(i.key()))
+                _statuses.insert(i.key(), i.value());
+        }
+        _writingChecks.clear();
+        _writingStatuses.clear();
+        count = PendingHelper();
+    }
+    //only the first failure and the warning to the user are logged, not every retry
+    if (failed && (failures == 1 || failures == 5))
+        db.Log(2, QStringLiteral("CKLWriteQueue"), QStringLiteral("Unable to write ") + QString::number(count) + QStringLiteral(" CKLCheck change") + Pluralize(count) + QStringLiteral("; retrying."));
+    if (failed && failures == 5)
+        Q_EMIT WriteFailed(count);
+    Q_EMIT PendingChanged(count);
+}
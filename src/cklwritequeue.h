@@ -0,0 +1,68 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CKLWRITEQUEUE_H
+#define CKLWRITEQUEUE_H
+
+#include "cklcheck.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+
+class CKLWriteQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    CKLWriteQueue(const CKLWriteQueue &queue) = delete;
+    explicit CKLWriteQueue(QObject *parent = nullptr);
+    ~CKLWriteQueue() override;
+    void Add(const CKLCheck &cklCheck);
+    void Add(const QVector<int> &ids, Status status);
+    bool Drain();
+    CKLCheck GetCKLCheck(int id);
+    void Overlay(QVector<CKLCheckRow> &rows);
+    int Pending();
+
+Q_SIGNALS:
+    void PendingChanged(int count);
+    void WriteFailed(int count);
+
+private Q_SLOTS:
+    void Flush();
+    void Schedule(int count);
+
+private:
+    int PendingHelper() const;
+    void Write();
+    QMutex _mutex;
+    QHash<int, CKLCheck> _checks; //edited checks waiting to be written
+    QHash<int, Status> _statuses; //status-only edits waiting to be written
+    QHash<int, CKLCheck> _writingChecks; //checks being written
+    QHash<int, Status> _writingStatuses; //statuses being written
+    int _failures; //consecutive writes that failed
+    QThreadPool _pool;
+    QTimer _timer;
+};
+
+#endif // CKLWRITEQUEUE_H
@@ -0,0 +1,297 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cli.h"
+#include "dbmanager.h"
+#include "memorymonitor.h"
+#include "querystats.h"
+#include "tracerecorder.h"
+#include "workercciadd.h"
+#include "workercklexport.h"
+#include "workercklimport.h"
+#include "workercmrsexport.h"
+#include "workeremassreport.h"
+#include "workerfindingsreport.h"
+#include "workerstigadd.h"
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstdlib>
+#include <iostream>
+
+/**
+ * @class CLI
+ * @brief The headless command-line interface to STIGQter.
+ *
+ * Each command is run by the same @a Worker that the graphical
+ * interface uses, on the same kind of @a JobScheduler. Commands that
+ * write the database are run one at a time, in the order given. The
+ * exports and reports only read the database, so they are run in
+ * parallel once every write has finished.
+ */
+
+/**
+ * @brief CLI::CLI
+ * @param parent
+ *
+ * Main constructor.
+ */
+CLI::CLI(QObject *parent) : QObject(parent),
+    _memoryBudget(-1)
+{
+}
+
+/**
+ * @brief CLI::~CLI
+ *
+ * Destructor.
+ */
+CLI::~CLI()
+{
+    Q_FOREACH (CLIJob *job, _jobs)
+        delete job;
+    _jobs.clear();
+}
+
+/**
+ * @brief CLI::Parse
+ * @param arguments
+ * @return @c True when every command in the @a arguments is valid.
+ *
+ * Commands are separated by "--". For example,
+ * "import-stigs a.zip b.zip -- export-ckls out -- emass-report out.xlsx"
+ *
+ * The commands may be preceded by "--trace FILE" to write a timeline
+ * of the run to FILE and by "--memory-budget MIB" to override the
+ * database's memory budget.
+ */
+bool CLI::Parse(const QStringList &arguments)
+{
+    QStringList commands = arguments;
+    while ((commands.count() >= 3) && commands.first().startsWith(QStringLiteral("--")) && (commands.first() != QStringLiteral("--")))
+    {
+        if (commands.first() == QStringLiteral("--trace"))
+        {
+            _trace = commands.at(1);
+        }
+        else if (commands.first() == QStringLiteral("--memory-budget"))
+        {
+            bool ok = false;
+            _memoryBudget = commands.at(1).toInt(&ok);
+            if (!ok || (_memoryBudget < 0))
+                return false;
+        }
+        else
+            return false;
+        commands = commands.mid(2);
+    }
+
+    QStringList command;
+    Q_FOREACH (const QString &argument, commands + QStringList{QStringLiteral("--")})
+    {
+        if (argument == QStringLiteral("--"))
+        {
+            if (command.isEmpty() || !AddJob(command.first(), command.mid(1)))
+                return false;
+            command.clear();
+        }
+        else
+            command.append(argument);
+    }
+    return !_jobs.isEmpty();
+}
+
+/**
+ * @brief CLI::Run
+ *
+ * Queue every job. Finished() is signaled with the exit code once
+ * every job is done.
+ */
+void CLI::Run()
+{
+    _elapsed.start();
+    TraceRecorder::SetEnabled(!_trace.isEmpty());
+    if (_memoryBudget < 0)
+    {
+        DbManager db;
+        _memoryBudget = db.GetVariable(QStringLiteral("memoryBudget")).toInt();
+    }
+    MemoryMonitor::SetBudget(static_cast<qint64>(_memoryBudget) * 1024 * 1024);
+    //writes are queued first, in the order given; the scheduler runs
+    //the reads after them
+    Q_FOREACH (CLIJob *job, _jobs)
+    {
+        if (job->WritesDatabase())
+            job->Start(&_scheduler);
+    }
+    Q_FOREACH (CLIJob *job, _jobs)
+    {
+        if (!job->WritesDatabase())
+            job->Start(&_scheduler);
+    }
+}
+
+/**
+ * @brief CLI::Usage
+ * @return The command-line help text.
+ */
+QString CLI::Usage()
+{
+    return QStringLiteral("Usage: stigqter-cli [--trace FILE] [--memory-budget MIB] COMMAND [ARGUMENTS] [-- COMMAND [ARGUMENTS]]...\n"
+                          "\n"
+                          "Commands that change the database run in the order given:\n"
+                          "  index-ccis                   download and index the CCI list\n"
+                          "  import-stigs FILE.zip...     import STIG benchmarks\n"
+                          "  import-ckls FILE.ckl...      import checklists\n"
+                          "\n"
+                          "Commands that read the database run in parallel afterward:\n"
+                          "  export-ckls DIRECTORY        export a checklist per Asset and STIG\n"
+                          "  emass-report FILE.xlsx       create an eMASS Test Result Import workbook\n"
+                          "  findings-report FILE.xlsx    create a Detailed Findings Report\n"
+                          "  cmrs-report FILE.xml         create a CMRS report\n"
+                          "\n"
+                          "Progress is written to stdout as one JSON object per line.\n"
+                          "The latency of the database queries is written before the\n"
+                          "final \"done\" line as a \"query-stats\" line.\n"
+                          "With --trace, a Chrome/Perfetto timeline of the jobs is\n"
+                          "written to FILE, and a \"trace\" line reports it.\n"
+                          "Jobs try to stay within the memory budget (in MiB; 0 is\n"
+                          "unlimited), which defaults to the database's setting. Each\n"
+                          "\"finished\" line reports the job's peak memory, and a\n"
+                          "\"memory\" line reports the process's before \"done\".\n"
+                          "The exit code is 0 when no job raised a warning.\n");
+}
+
+/**
+ * @brief CLI::JobFinished
+ *
+ * Report that everything is done once the last job finishes.
+ */
+void CLI::JobFinished()
+{
+    Q_FOREACH (CLIJob *job, _jobs)
+    {
+        if (!job->IsDone())
+            return;
+    }
+
+    int warnings = 0;
+    Q_FOREACH (CLIJob *job, _jobs)
+    {
+        warnings += job->Warnings();
+    }
+    QJsonObject stats = QueryStats::ToJson();
+    stats.insert(QStringLiteral("event"), QStringLiteral("query-stats"));
+    std::cout << QJsonDocument(stats).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+
+    QJsonObject memory = MemoryMonitor::ToJson();
+    memory.insert(QStringLiteral("event"), QStringLiteral("memory"));
+    std::cout << QJsonDocument(memory).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+
+    if (!_trace.isEmpty())
+    {
+        TraceRecorder::SetEnabled(false);
+        bool written = TraceRecorder::Write(_trace);
+        if (!written)
+            warnings++;
+        QJsonObject trace{{QStringLiteral("event"), QStringLiteral("trace")},
+                          {QStringLiteral("file"), _trace},
+                          {QStringLiteral("spans"), TraceRecorder::Count()},
+                          {QStringLiteral("written"), written}};
+        std::cout << QJsonDocument(trace).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+    }
+
+    QJsonObject done{{QStringLiteral("event"), QStringLiteral("done")},
+                     {QStringLiteral("jobs"), _jobs.count()},
+                     {QStringLiteral("warnings"), warnings},
+                     {QStringLiteral("ms"), _elapsed.elapsed()}};
+    std::cout << QJsonDocument(done).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+    Q_EMIT Finished(warnings > 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/**
+ * @brief CLI::AddJob
+ * @param command
+ * @param arguments
+ * @return @c True when the @a command and its @a arguments are valid.
+ */
+bool CLI::AddJob(const QString &command, const QStringList &arguments)
+{
+    Worker *worker = nullptr;
+    bool writesDatabase = true;
+
+    if (command == QStringLiteral("index-ccis") && arguments.isEmpty())
+    {
+        worker = new WorkerCCIAdd();
+    }
+    else if (command == QStringLiteral("import-stigs") && !arguments.isEmpty())
+    {
+        DbManager db;
+        auto *s = new WorkerSTIGAdd();
+        s->AddSTIGs(arguments);
+        s->SetEnableSupplements(db.GetVariable(QStringLiteral("indexSupplements")).startsWith(QStringLiteral("y"), Qt::CaseInsensitive));
+        worker = s;
+    }
+    else if (command == QStringLiteral("import-ckls") && !arguments.isEmpty())
+    {
+        auto *c = new WorkerCKLImport();
+        c->AddCKLs(arguments);
+        worker = c;
+    }
+    else if (arguments.count() == 1)
+    {
+        writesDatabase = false;
+        if (command == QStringLiteral("export-ckls"))
+        {
+            auto *f = new WorkerCKLExport();
+            f->SetExportDir(arguments.first());
+            worker = f;
+        }
+        else if (command == QStringLiteral("emass-report"))
+        {
+            auto *f = new WorkerEMASSReport();
+            f->SetReportName(arguments.first());
+            worker = f;
+        }
+        else if (command == QStringLiteral("findings-report"))
+        {
+            auto *f = new WorkerFindingsReport();
+            f->SetReportName(arguments.first());
+            worker = f;
+        }
+        else if (command == QStringLiteral("cmrs-report"))
+        {
+            auto *f = new WorkerCMRSExport();
+            f->SetExportPath(arguments.first());
+            worker = f;
+        }
+    }
+
+    if (!worker)
+    {
+        std::cerr << "Invalid command: " << (QStringList{command} + arguments).join(QStringLiteral(" ")).toStdString() << std::endl;
+        return false;
+    }
+
+    auto *job = new CLIJob(_jobs.count(), command, worker, writesDatabase);
+    connect(job, SIGNAL(Finished()), this, SLOT(JobFinished()));
+    _jobs.append(job);
+    return true;
+}
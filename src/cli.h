@@ -0,0 +1,58 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLI_H
+#define CLI_H
+
+#include "clijob.h"
+#include "jobscheduler.h"
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+
+class CLI : public QObject
+{
+    Q_OBJECT
+
+public:
+    CLI(const CLI &cli) = delete;
+    explicit CLI(QObject *parent = nullptr);
+    ~CLI() override;
+    bool Parse(const QStringList &arguments);
+    void Run();
+    static QString Usage();
+
+Q_SIGNALS:
+    void Finished(int exitCode);
+
+private Q_SLOTS:
+    void JobFinished();
+
+private:
+    bool AddJob(const QString &command, const QStringList &arguments);
+    QList<CLIJob*> _jobs;
+    QString _trace;
+    int _memoryBudget;
+    JobScheduler _scheduler;
+    QElapsedTimer _elapsed;
+};
+
+#endif // CLI_H
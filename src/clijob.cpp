@@ -0,0 +1,227 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "clijob.h"
+
+#include <QJsonDocument>
+
+#include <iostream>
+
+/**
+ * @class CLIJob
+ * @brief One command of the command-line interface, run by its
+ * @a Worker on a @a JobScheduler.
+ *
+ * The @a Worker's signals are reported on stdout as one JSON object
+ * per line so that scripts can follow the job's progress.
+ */
+
+/**
+ * @brief CLIJob::CLIJob
+ * @param id
+ * @param command
+ * @param worker
+ * @param writesDatabase
+ * @param parent
+ *
+ * Main constructor. The job owns the @a worker until it is started.
+ * Jobs that write the database are run one at a time.
+ */
+CLIJob::CLIJob(int id, const QString &command, Worker *worker, bool writesDatabase, QObject *parent) : QObject(parent),
+    _id(id),
+    _command(command),
+    _worker(worker),
+    _writesDatabase(writesDatabase),
+    _done(false),
+    _max(0),
+    _value(0),
+    _warnings(0),
+    _peakResident(0),
+    _peakTracked(0)
+{
+}
+
+/**
+ * @brief CLIJob::~CLIJob
+ *
+ * Destructor.
+ */
+CLIJob::~CLIJob()
+{
+    //a started worker belongs to the scheduler
+    delete _worker;
+}
+
+/**
+ * @brief CLIJob::IsDone
+ * @return @c True when the job has finished.
+ */
+bool CLIJob::IsDone() const
+{
+    return _done;
+}
+
+/**
+ * @brief CLIJob::WritesDatabase
+ * @return @c True when the job changes the database.
+ */
+bool CLIJob::WritesDatabase() const
+{
+    return _writesDatabase;
+}
+
+/**
+ * @brief CLIJob::Start
+ * @param scheduler
+ *
+ * Queue the @a Worker on the @a scheduler. The job is reported as
+ * started once the @a scheduler gives it a thread.
+ */
+void CLIJob::Start(JobScheduler *scheduler)
+{
+    int id = scheduler->Submit(_worker, _writesDatabase ? JobScheduler::DatabaseWriter : JobScheduler::ReadOnly);
+    _worker = nullptr;
+    //progress is coalesced by the scheduler rather than printed for every item
+    connect(scheduler, &JobScheduler::JobInitialize, this, [this, id](int job, int max, int val) {
+        if (job == id)
+            Initialize(max, val);
+    });
+    connect(scheduler, &JobScheduler::JobProgress, this, [this, id](int job, int val) {
+        if (job == id)
+            Progress(val);
+    });
+    connect(scheduler, &JobScheduler::JobStatus, this, [this, id](int job, const QString &status) {
+        if (job == id)
+            StatusChange(status);
+    });
+    connect(scheduler, &JobScheduler::JobStarted, this, [this, id](int started) {
+        if (started == id)
+        {
+            _elapsed.start();
+            Print(QStringLiteral("start"));
+        }
+    });
+    connect(scheduler, &JobScheduler::JobWarnings, this, [this, id](int job, const WarningSink *warnings) {
+        if (job == id)
+            ShowWarnings(warnings);
+    });
+    connect(scheduler, &JobScheduler::JobMemory, this, [this, id](int job, const MemoryUsage *memory) {
+        if (job == id)
+        {
+            _peakResident = memory->PeakResident();
+            _peakTracked = memory->PeakTracked();
+        }
+    });
+    connect(scheduler, &JobScheduler::JobFinished, this, [this, id](int finished) {
+        if (finished == id)
+            Completed();
+    });
+}
+
+/**
+ * @brief CLIJob::Warnings
+ * @return The number of warnings the @a Worker raised.
+ */
+int CLIJob::Warnings() const
+{
+    return _warnings;
+}
+
+/**
+ * @brief CLIJob::Completed
+ *
+ * Report that the @a Worker has finished.
+ */
+void CLIJob::Completed()
+{
+    _done = true;
+    Print(QStringLiteral("finished"), {{QStringLiteral("ms"), _elapsed.elapsed()},
+                                       {QStringLiteral("warnings"), _warnings},
+                                       {QStringLiteral("peakResident"), _peakResident},
+                                       {QStringLiteral("peakTracked"), _peakTracked}});
+    Q_EMIT Finished();
+}
+
+/**
+ * @brief CLIJob::Initialize
+ * @param max
+ * @param val
+ *
+ * Report the amount of work the @a Worker has to do.
+ */
+void CLIJob::Initialize(int max, int val)
+{
+    _max = max;
+    _value = val;
+    Print(QStringLiteral("initialize"), {{QStringLiteral("max"), _max}, {QStringLiteral("value"), _value}});
+}
+
+/**
+ * @brief CLIJob::Progress
+ * @param val
+ *
+ * Report the @a Worker's progress. A negative @a val advances the
+ * progress by one.
+ */
+void CLIJob::Progress(int val)
+{
+    _value = val < 0 ? _value + 1 : val;
+    Print(QStringLiteral("progress"), {{QStringLiteral("max"), _max}, {QStringLiteral("value"), _value}});
+}
+
+/**
+ * @brief CLIJob::ShowWarnings
+ * @param warnings
+ *
+ * Report the warnings raised by the @a Worker, one line for each
+ * different warning with the number of times that it was raised.
+ */
+void CLIJob::ShowWarnings(const WarningSink *warnings)
+{
+    _warnings += warnings->Count();
+    Q_FOREACH (const WarningEntry &entry, warnings->Entries())
+        Print(QStringLiteral("warning"), {{QStringLiteral("title"), entry.title}, {QStringLiteral("message"), entry.message}, {QStringLiteral("count"), entry.count}});
+}
+
+/**
+ * @brief CLIJob::StatusChange
+ * @param status
+ *
+ * Report the @a Worker's status.
+ */
+void CLIJob::StatusChange(const QString &status)
+{
+    Print(QStringLiteral("status"), {{QStringLiteral("message"), status}});
+}
+
+/**
+ * @brief CLIJob::Print
+ * @param event
+ * @param values
+ *
+ * Write the @a event and its @a values to stdout as a single line of
+ * JSON.
+ */
+void CLIJob::Print(const QString &event, QJsonObject values)
+{
+    values.insert(QStringLiteral("event"), event);
+    values.insert(QStringLiteral("id"), _id);
+    values.insert(QStringLiteral("job"), _command);
+    std::cout << QJsonDocument(values).toJson(QJsonDocument::Compact).toStdString() << std::endl;
+}
@@ -0,0 +1,70 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLIJOB_H
+#define CLIJOB_H
+
+#include "jobscheduler.h"
+#include "worker.h"
+
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QObject>
+#include <QString>
+
+class CLIJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    CLIJob() = delete;
+    CLIJob(const CLIJob &job) = delete;
+    CLIJob(int id, const QString &command, Worker *worker, bool writesDatabase, QObject *parent = nullptr);
+    ~CLIJob() override;
+    bool IsDone() const;
+    bool WritesDatabase() const;
+    void Start(JobScheduler *scheduler);
+    int Warnings() const;
+
+Q_SIGNALS:
+    void Finished();
+
+private Q_SLOTS:
+    void Completed();
+    void Initialize(int max, int val = 0);
+    void Progress(int val);
+    void ShowWarnings(const WarningSink *warnings);
+    void StatusChange(const QString &status);
+
+private:
+    void Print(const QString &event, QJsonObject values = QJsonObject());
+    int _id;
+    QString _command;
+    Worker *_worker;
+    bool _writesDatabase;
+    bool _done;
+    int _max;
+    int _value;
+    int _warnings;
+    qint64 _peakResident;
+    qint64 _peakTracked;
+    QElapsedTimer _elapsed;
+};
+
+#endif // CLIJOB_H
@@ -0,0 +1,64 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cli.h"
+#include "common.h"
+
+#include <QCoreApplication>
+#include <QHostInfo>
+#include <QTimer>
+
+#include <cstdlib>
+#include <iostream>
+
+[[maybe_unused]] bool IgnoreWarnings = true; //see common.h; there is no one to show warnings to
+
+int main(int argc, char *argv[])
+{
+    qInstallMessageHandler(MessageHandler);
+    QCoreApplication a(argc, argv);
+
+    //share the graphical interface's database
+    QCoreApplication::setApplicationName(QStringLiteral("STIGQter"));
+
+    QStringList arguments = QCoreApplication::arguments().mid(1);
+    if (arguments.isEmpty() || arguments.first() == QStringLiteral("--help") || arguments.first() == QStringLiteral("-h"))
+    {
+        std::cout << CLI::Usage().toStdString();
+        return arguments.isEmpty() ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    CLI cli;
+    if (!cli.Parse(arguments))
+    {
+        std::cerr << CLI::Usage().toStdString();
+        return EXIT_FAILURE;
+    }
+
+    //log software startup as required by SV-84041r1_rule
+    Warning(QStringLiteral("System is Starting"), QHostInfo::localHostName(), true, 4);
+
+    QObject::connect(&cli, &CLI::Finished, &a, &QCoreApplication::exit);
+    QTimer::singleShot(0, &cli, &CLI::Run);
+    int ret = a.exec();
+
+    //log software shutdown as required by SV-84041r1_rule
+    Warning(QStringLiteral("System is Shutting Down"), QHostInfo::localHostName(), true, 4);
+    return ret;
+}
@@ -21,14 +21,18 @@
 #include "dbmanager.h"
 #include "tidy.h"
 #include "tidybuffio.h"
+#include "tracerecorder.h"
+#include "warningsink.h"
 
 #include <zip.h>
 
-#include <QApplication>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QEventLoop>
 #include <QtGlobal>
+#ifndef STIGQTER_CLI
 #include <QMessageBox>
+#endif
 #include <QString>
 #include <QtNetwork>
 
@@ -83,6 +87,7 @@ void MessageHandler(QtMsgType type, const QMessageLogContext &context, const QSt
  */
 QString CleanXML(QString s, bool isXml)
 {
+    TraceSpan span(QStringLiteral("tidy"), "parse");
     TidyBuffer output;
     tidyBufInit(&output);
     TidyBuffer err;
@@ -248,6 +253,94 @@ int GetCCINumber(QString cci)
     return cci.toInt();
 }
 
+/**
+ * @brief ReadZipEntry
+ * @param za
+ * @param index
+ * @param size
+ * @return The uncompressed contents of entry @a index of the open
+ * zip @a za, which is @a size bytes long.
+ */
+static QByteArray ReadZipEntry(struct zip *za, zip_uint64_t index, zip_uint64_t size)
+{
+    QByteArray ret;
+    struct zip_file *zf = zip_fopen_index(za, index, 0);
+    if (zf)
+    {
+        ret.reserve(static_cast<int>(size));
+        zip_uint64_t sum = 0;
+        while (sum < size)
+        {
+            char buf[1024];
+            zip_int64_t len = zip_fread(zf, static_cast<void*>(buf), 1024);
+            if (len <= 0)
+                break;
+            ret.append(static_cast<const char*>(buf), static_cast<int>(len));
+            sum += static_cast<zip_uint64_t>(len);
+        }
+        zip_fclose(zf);
+    }
+    return ret;
+}
+
+/**
+ * @brief GetFileFromZip
+ * @param fileName
+ * @param entryName
+ * @return The contents of the file @a entryName in the zip
+ * @a fileName, or an empty array when it is not found.
+ *
+ * Unlike GetFilesFromZip(), only the one file is held in memory.
+ */
+QByteArray GetFileFromZip(const QString &fileName, const QString &entryName)
+{
+    TraceSpan span(QStringLiteral("extract zip"), "io");
+    QByteArray ret;
+    int err;
+    struct zip *za = zip_open(fileName.toStdString().c_str(), 0, &err);
+    if (za != nullptr)
+    {
+        zip_int64_t index = zip_name_locate(za, entryName.toLatin1().constData(), 0);
+        struct zip_stat sb;
+        zip_stat_init(&sb);
+        if ((index >= 0) && (zip_stat_index(za, static_cast<zip_uint64_t>(index), 0, &sb) == 0))
+            ret = ReadZipEntry(za, static_cast<zip_uint64_t>(index), sb.size);
+        zip_close(za);
+    }
+    return ret;
+}
+
+/**
+ * @brief GetFileNamesFromZip
+ * @param fileName
+ * @param fileNameFilter
+ * @return The names of the files in the zip @a fileName that end
+ * with @a fileNameFilter (case-insensitive), or of every file when
+ * the filter is empty.
+ */
+QStringList GetFileNamesFromZip(const QString &fileName, const QString &fileNameFilter)
+{
+    QStringList ret;
+    int err;
+    struct zip *za = zip_open(fileName.toStdString().c_str(), 0, &err);
+    if (za != nullptr)
+    {
+        struct zip_stat sb;
+        zip_stat_init(&sb);
+        for (zip_int64_t i = 0; i < zip_get_num_entries(za, 0); i++)
+        {
+            if (zip_stat_index(za, static_cast<zip_uint64_t>(i), 0, &sb) == 0)
+            {
+                QString name(QString::fromLatin1(sb.name));
+                if (fileNameFilter.isEmpty() || name.endsWith(fileNameFilter, Qt::CaseInsensitive))
+                    ret.append(name);
+            }
+        }
+        zip_close(za);
+    }
+    return ret;
+}
+
 /**
  * @brief GetFilesFromZip
  * @param fileName
@@ -261,6 +354,7 @@ int GetCCINumber(QString cci)
  */
 QMap<QString, QByteArray> GetFilesFromZip(const QString &fileName, const QString &fileNameFilter)
 {
+    TraceSpan span(QStringLiteral("extract zip"), "io");
     //map to return
     QMap<QString, QByteArray> ret;
 
@@ -283,24 +377,7 @@ QMap<QString, QByteArray> GetFilesFromZip(const QString &fileName, const QString
                     continue;
                 }
 
-                QByteArray todo;
-                struct zip_file *zf = zip_fopen_index(za, i, 0);
-                if (zf)
-                {
-                    unsigned int sum = 0;
-                    while (sum < sb.size)
-                    {
-                        char buf[1024];
-                        zip_int64_t len = zip_fread(zf, static_cast<void*>(buf), 1024);
-                        if (len > 0)
-                        {
-                            todo.append(static_cast<const char*>(buf), static_cast<int>(len));
-                            sum += len;
-                        }
-                    }
-                    zip_fclose(zf);
-                }
-                ret.insert(name, todo);
+                ret.insert(name, ReadZipEntry(za, i, sb.size));
             }
         }
         zip_close(za);
@@ -425,12 +502,26 @@ QString TrimFileName(const QString &fileName)
  * When @a quiet is not @c true, displays a warning box with the
  * provided @a title and @a message. The title and message are always
  * printed on the console/debug log.
+ *
+ * On a background job's thread, warnings that are not @a quiet are
+ * collected by the job's @a WarningSink and reported once the job
+ * finishes.
  */
 void Warning(const QString &title, const QString &message, const bool quiet, const int level)
 {
+    WarningSink *sink = WarningSink::Current();
+    if (!quiet && sink)
+    {
+        sink->Add(title, message, level);
+        return;
+    }
     DbManager db;
     db.Log(level, QString(), title + ": " + message);
-    if (!IgnoreWarnings && !quiet && (QThread::currentThread() == QApplication::instance()->thread())) //make sure we're in the GUI thread before popping a message box
+#ifdef STIGQTER_CLI
+    //the command-line interface has no message boxes
+    Q_UNUSED(quiet)
+#else
+    if (!IgnoreWarnings && !quiet && (QThread::currentThread() == QCoreApplication::instance()->thread())) //make sure we're in the GUI thread before popping a message box
     {
         int ret = QMessageBox::warning(nullptr, title, message, QMessageBox::Ignore | QMessageBox::Ok);
         //if ignoring messages, move to quiet mode
@@ -439,4 +530,5 @@ void Warning(const QString &title, const QString &message, const bool quiet, con
             IgnoreWarnings = true;
         }
     }
+#endif
 }
@@ -34,6 +34,8 @@ bool DownloadFile(const QUrl &url, QFile *file);
 QString DownloadPage(const QUrl &url);
 QString Excelify(const QString &s);
 int GetCCINumber(QString cci);
+QByteArray GetFileFromZip(const QString &fileName, const QString &entryName);
+QStringList GetFileNamesFromZip(const QString &fileName, const QString &fileNameFilter = QLatin1String(""));
 QMap<QString, QByteArray> GetFilesFromZip(const QString &fileName, const QString &fileNameFilter = QLatin1String(""));
 int GetReleaseNumber(const QString &release);
 QString GetUserAgent();
@@ -0,0 +1,146 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dblistmodel.h"
+
+#include <algorithm>
+
+/**
+ * @class DbListModel
+ * @brief A list of database entries (@a Assets, @a CCIs, or
+ * @a STIGs) as displayed in the main window.
+ *
+ * Only the id and the displayed text of each entry are kept. The rows
+ * are handed to the view a page at a time as it scrolls, so large
+ * lists are displayed without creating an item for every entry.
+ */
+
+static const int pageSize = 500;
+
+/**
+ * @brief DbListModel::DbListModel
+ * @param parent
+ *
+ * Main constructor.
+ */
+DbListModel::DbListModel(QObject *parent) : QAbstractListModel(parent),
+    _fetched(0)
+{
+}
+
+/**
+ * @brief DbListModel::canFetchMore
+ * @param parent
+ * @return @c True when there are rows that have not been shown to
+ * the view.
+ */
+bool DbListModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return false;
+    return _fetched < _rows.count();
+}
+
+/**
+ * @brief DbListModel::fetchMore
+ * @param parent
+ *
+ * Show the next page of rows to the view.
+ */
+void DbListModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid())
+        return;
+    int count = std::min(pageSize, _rows.count() - _fetched);
+    if (count <= 0)
+        return;
+    beginInsertRows(QModelIndex(), _fetched, _fetched + count - 1);
+    _fetched += count;
+    endInsertRows();
+}
+
+/**
+ * @brief DbListModel::rowCount
+ * @param parent
+ * @return The number of rows shown to the view.
+ */
+int DbListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return _fetched;
+}
+
+/**
+ * @brief DbListModel::data
+ * @param index
+ * @param role
+ * @return The displayed text, database id, or filtered text of the
+ * entry at the @a index.
+ */
+QVariant DbListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= _fetched)
+        return QVariant();
+
+    const DbListRow &row = _rows.at(index.row());
+    switch (role)
+    {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return row.text;
+    case IdRole:
+        return row.id;
+    case FilterRole:
+        return row.filter;
+    default:
+        return QVariant();
+    }
+}
+
+/**
+ * @brief DbListModel::FetchAll
+ *
+ * Show every row to the view, such as before the rows are filtered
+ * or all selected.
+ */
+void DbListModel::FetchAll()
+{
+    if (canFetchMore(QModelIndex()))
+    {
+        beginInsertRows(QModelIndex(), _fetched, _rows.count() - 1);
+        _fetched = _rows.count();
+        endInsertRows();
+    }
+}
+
+/**
+ * @brief DbListModel::SetRows
+ * @param rows
+ *
+ * Replace the contents of the model with the provided @a rows. Only
+ * the first page is shown until the view requests more.
+ */
+void DbListModel::SetRows(const QVector<DbListRow> &rows)
+{
+    beginResetModel();
+    _rows = rows;
+    _fetched = std::min(pageSize, _rows.count());
+    endResetModel();
+}
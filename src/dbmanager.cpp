@@ -20,9 +20,12 @@
 #include "dbmanager.h"
 #include "cklcheck.h"
 #include "common.h"
+#include "querystats.h"
+#include "tracerecorder.h"
 
 #include <cstdlib>
 #include <QCryptographicHash>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QSqlQuery>
 #include <QSqlError>
@@ -62,6 +65,8 @@
  * database.
  */
 
+static QString defaultPath; //see DbManager::SetDefaultPath()
+
 /**
  * @brief DbManager::DbManager
  *
@@ -80,6 +85,7 @@ DbManager::DbManager() : DbManager(QString::number(reinterpret_cast<quint64>(QTh
  * application directory for the user is used.
  */
 DbManager::DbManager(const QString& connectionName) : DbManager(
+                                                          !defaultPath.isEmpty() ? defaultPath :
                                                           QFile::exists(QCoreApplication::applicationDirPath() + "/STIGQter.db") ?
                                                               (QCoreApplication::applicationDirPath() + "/STIGQter.db") :
                                                               QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/STIGQter.db",
@@ -169,7 +175,7 @@ DbManager::~DbManager()
         QSqlDatabase db;
         if (CheckDatabase(db))
         {
-            db.commit();
+            Commit(db);
         }
     }
 }
@@ -233,9 +239,9 @@ void DbManager::DelayCommit(bool delay)
         {
             QSqlQuery q(db);
             q.prepare(QStringLiteral("PRAGMA journal_mode = OFF"));
-            q.exec();
+            Exec(q, QStringLiteral("DelayCommit"));
             q.prepare(QStringLiteral("PRAGMA synchronous = OFF"));
-            q.exec();
+            Exec(q, QStringLiteral("DelayCommit"));
         }
     }
     else
@@ -245,10 +251,10 @@ void DbManager::DelayCommit(bool delay)
         {
             QSqlQuery q(db);
             q.prepare(QStringLiteral("PRAGMA journal_mode = ON"));
-            q.exec();
+            Exec(q, QStringLiteral("DelayCommit"));
             q.prepare(QStringLiteral("PRAGMA synchronous = ON"));
-            q.exec();
-            db.commit();
+            Exec(q, QStringLiteral("DelayCommit"));
+            Commit(db);
         }
     }
     _delayCommit = delay;
@@ -290,7 +296,7 @@ bool DbManager::AddAsset(Asset &asset)
         //check if Asset exists in the database
         q.prepare(QStringLiteral("SELECT count(*) FROM Asset WHERE hostName = :hostName"));
         q.bindValue(QStringLiteral(":hostName"), asset.hostName);
-        q.exec();
+        Exec(q, QStringLiteral("AddAsset"));
         if (q.next() && q.value(0).toInt() > 0)
         {
             Warning(QStringLiteral("Asset Already Exists"), "The Asset " + PrintAsset(asset) + " already exists in the database.");
@@ -307,8 +313,8 @@ bool DbManager::AddAsset(Asset &asset)
         q.bindValue(QStringLiteral(":webOrDatabase"), asset.webOrDB);
         q.bindValue(QStringLiteral(":webDBSite"), asset.webDbSite);
         q.bindValue(QStringLiteral(":webDBInstance"), asset.webDbInstance);
-        ret = q.exec();
-        db.commit();
+        ret = Exec(q, QStringLiteral("AddAsset"));
+        Commit(db);
         asset.id = q.lastInsertId().toInt();
         Log(6, QStringLiteral("AddAsset"), q);
     }
@@ -340,7 +346,7 @@ bool DbManager::AddCCI(CCI &cci)
         //check if CCI already exists in the DB
         q.prepare(QStringLiteral("SELECT count(*) FROM CCI WHERE cci = :cci"));
         q.bindValue(QStringLiteral(":cci"), cci.cci);
-        q.exec();
+        Exec(q, QStringLiteral("AddCCI"));
         if (q.next() && q.value(0).toInt() > 0)
         {
             Warning(QStringLiteral("CCI Already Exists"), "The CCI " + PrintCCI(cci) + " already exists in the database.", true);
@@ -351,10 +357,10 @@ bool DbManager::AddCCI(CCI &cci)
         q.bindValue(QStringLiteral(":ControlId"), cci.controlId);
         q.bindValue(QStringLiteral(":CCI"), cci.cci);
         q.bindValue(QStringLiteral(":definition"), cci.definition);
-        ret = q.exec();
+        ret = Exec(q, QStringLiteral("AddCCI"));
         if (!_delayCommit)
         {
-            db.commit();
+            Commit(db);
             cci.id = q.lastInsertId().toInt();
         }
         Log(6, QStringLiteral("AddCCI"), q);
@@ -431,9 +437,9 @@ bool DbManager::AddControl(const QString &control, const QString &title, const Q
                 q.bindValue(QStringLiteral(":enhancement"), enhancement.isEmpty() ? QVariant(QVariant::Int) : enhancement.toInt());
                 q.bindValue(QStringLiteral(":title"), title);
                 q.bindValue(QStringLiteral(":description"), description);
-                ret = q.exec();
+                ret = Exec(q, QStringLiteral("AddControl"));
                 if (!_delayCommit)
-                    db.commit();
+                    Commit(db);
                 Log(6, QStringLiteral("AddControl"), q);
             }
         }
@@ -491,9 +497,9 @@ bool DbManager::AddFamily(const QString &acronym, const QString &description)
         q.prepare(QStringLiteral("INSERT INTO Family (Acronym, Description) VALUES(:acronym, :description)"));
         q.bindValue(QStringLiteral(":acronym"), acronym);
         q.bindValue(QStringLiteral(":description"), Sanitize(description));
-        ret = q.exec();
+        ret = Exec(q, QStringLiteral("AddFamily"));
         if (!_delayCommit)
-            db.commit();
+            Commit(db);
         Log(6, QStringLiteral("AddFamily"), q);
     }
     return ret;
@@ -518,6 +524,7 @@ bool DbManager::AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVec
     QSqlDatabase db;
     bool ret = false;
     bool stigCheckRet = true; //turns "false" if a check fails to be added
+    TraceSpan span(QStringLiteral("AddSTIG"), "db");
 
     if (CheckDatabase(db))
     {
@@ -549,10 +556,10 @@ bool DbManager::AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVec
                 q.bindValue(QStringLiteral(":version"), stig.version);
                 q.bindValue(QStringLiteral(":benchmarkId"), stig.benchmarkId);
                 q.bindValue(QStringLiteral(":fileName"), stig.fileName);
-                ret = q.exec();
+                ret = Exec(q, QStringLiteral("AddSTIG"));
                 stig.id = q.lastInsertId().toInt();
                 //do not delay this commit; the STIG should be added to the DB to prevent inconsistencies with adding the checks.
-                db.commit();
+                Commit(db);
                 Log(6, QStringLiteral("AddSTIG"), q);
             }
         }
@@ -596,7 +603,7 @@ bool DbManager::AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVec
             q.bindValue(QStringLiteral(":IAControls"), c.iaControls);
             q.bindValue(QStringLiteral(":targetKey"), c.targetKey);
             q.bindValue(QStringLiteral(":isRemap"), (c.isRemap || c.cciIds.count() <= 0) ? 1 : 0);
-            bool tmpRet = q.exec();
+            bool tmpRet = Exec(q, QStringLiteral("AddSTIG"));
             stigCheckRet = stigCheckRet && tmpRet;
             if (!tmpRet)
             {
@@ -627,7 +634,7 @@ bool DbManager::AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVec
                     q.prepare(QStringLiteral("INSERT INTO STIGCheckCCI (`STIGCheckId`, `CCIId`) VALUES(:STIGCheckId, :CCIId)"));
                     q.bindValue(QStringLiteral(":STIGCheckId"), STIGCheckId);
                     q.bindValue(QStringLiteral(":CCIId"), cciId);
-                    ret = q.exec() && ret;
+                    ret = Exec(q, QStringLiteral("AddSTIG")) && ret;
                     Log(6, QStringLiteral("AddAsset-CCI"), q);
                 }
 
@@ -636,7 +643,7 @@ bool DbManager::AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVec
                     q.prepare(QStringLiteral("INSERT INTO STIGCheckLegacyId (`STIGCheckId`, `LegacyId`) VALUES(:STIGCheckId, :LegacyId)"));
                     q.bindValue(QStringLiteral(":STIGCheckId"), STIGCheckId);
                     q.bindValue(QStringLiteral(":LegacyId"), legacyId);
-                    ret = q.exec() && ret;
+                    ret = Exec(q, QStringLiteral("AddSTIG")) && ret;
                     Log(6, QStringLiteral("AddAsset-LegacyIds"), q);
                 }
             }
@@ -649,17 +656,21 @@ bool DbManager::AddSTIG(STIG &stig, const QVector<STIGCheck> &checks, const QVec
             q.bindValue(QStringLiteral(":STIGId"), stig.id);
             q.bindValue(QStringLiteral(":path"), supplement.path);
             q.bindValue(QStringLiteral(":contents"), supplement.contents);
-            ret = q.exec() && ret;
+            ret = Exec(q, QStringLiteral("AddSTIG")) && ret;
             Log(6, QStringLiteral("AddAsset-Supplement"), q);
         }
 
+        //make the new STIGChecks searchable
+        if (checks.count() > 0)
+            UpdateSearchIndex(QStringLiteral("WHERE STIGCheck.STIGId = :STIGId"), {std::make_tuple<QString, QVariant>(QStringLiteral(":STIGId"), stig.id)});
+
         //restore the old value of the "delayed commit" feature
         if (!delayed)
         {
             this->DelayCommit(false);
         }
         if (newChecks)
-            db.commit();
+            Commit(db);
     }
     return ret && stigCheckRet;
 }
@@ -693,16 +704,17 @@ bool DbManager::AddSTIGToAsset(const STIG &stig, const Asset &asset)
                 q.prepare(QStringLiteral("INSERT INTO AssetSTIG (`AssetId`, `STIGId`) VALUES(:AssetId, :STIGId)"));
                 q.bindValue(QStringLiteral(":AssetId"), tmpAsset.id);
                 q.bindValue(QStringLiteral(":STIGId"), tmpSTIG.id);
-                ret = q.exec();
+                ret = Exec(q, QStringLiteral("AddSTIGToAsset"));
                 Log(6, QStringLiteral("AddSTIGToAsset"), q);
                 if (ret)
                 {
-                    q.prepare(QStringLiteral("INSERT INTO CKLCheck (AssetId, STIGCheckId, status, findingDetails, comments, severityOverride, severityJustification) SELECT :AssetId, id, :status, '', '', '', '' FROM STIGCheck WHERE STIGId = :STIGId"));
+                    q.prepare(QStringLiteral("INSERT INTO CKLCheck (AssetId, STIGCheckId, status, findingDetails, comments, severityOverride, severityJustification) SELECT :AssetId, id, :status, '', '', :severityOverride, '' FROM STIGCheck WHERE STIGId = :STIGId"));
                     q.bindValue(QStringLiteral(":AssetId"), tmpAsset.id);
                     q.bindValue(QStringLiteral(":status"), Status::NotReviewed);
+                    q.bindValue(QStringLiteral(":severityOverride"), Severity::none);
                     q.bindValue(QStringLiteral(":STIGId"), tmpSTIG.id);
-                    ret = q.exec();
-                    db.commit();
+                    ret = Exec(q, QStringLiteral("AddSTIGToAsset"));
+                    Commit(db);
                     Log(6, QStringLiteral("AddSTIGToAsset-2"), q);
                 }
         }
@@ -743,9 +755,9 @@ bool DbManager::DeleteAsset(const Asset &asset)
             QSqlQuery q(db);
             q.prepare(QStringLiteral("DELETE FROM Asset WHERE id = :AssetId"));
             q.bindValue(QStringLiteral(":AssetId"), asset.id);
-            ret = q.exec();
+            ret = Exec(q, QStringLiteral("DeleteAsset"));
             if (!_delayCommit)
-                db.commit();
+                Commit(db);
             Log(6, QStringLiteral("DeleteAsset"), q);
         }
     }
@@ -769,15 +781,15 @@ bool DbManager::DeleteCCIs()
         ret = true; //assume success until one of the queries fails.
         QSqlQuery q(db);
         q.prepare(QStringLiteral("DELETE FROM Family"));
-        ret = q.exec() && ret; //q.exec() first to avoid short-circuit evaluation
+        ret = Exec(q, QStringLiteral("DeleteCCIs")) && ret; //Exec() first to avoid short-circuit evaluation
         Log(6, QStringLiteral("DeleteCCIs-Family"), q);
         q.prepare(QStringLiteral("DELETE FROM Control"));
-        ret = q.exec() && ret;
+        ret = Exec(q, QStringLiteral("DeleteCCIs")) && ret;
         Log(6, QStringLiteral("DeleteCCIs-Control"), q);
         q.prepare(QStringLiteral("DELETE FROM CCI"));
-        ret = q.exec() && ret;
+        ret = Exec(q, QStringLiteral("DeleteCCIs")) && ret;
         if (!_delayCommit)
-            db.commit();
+            Commit(db);
         Log(6, QStringLiteral("DeleteCCIs-CCI"), q);
     }
     return ret;
@@ -813,9 +825,9 @@ bool DbManager::DeleteEmassImport()
     {
         QSqlQuery q(db);
         q.prepare(QStringLiteral("UPDATE CCI SET isImport = 0, importCompliance = NULL, importDateTested = NULL, importTestedBy = NULL, importTestResults = NULL, importCompliance2 = NULL, importDateTested2 = NULL, importTestedBy2 = NULL, importTestResults2 = NULL, importControlImplementationStatus = NULL, importSecurityControlDesignation = NULL, importInherited = NULL, importApNum = NULL, importImplementationGuidance = NULL, importAssessmentProcedures = NULL"));
-        ret = q.exec();
+        ret = Exec(q, QStringLiteral("DeleteEmassImport"));
         if (!_delayCommit)
-            db.commit();
+            Commit(db);
         Log(6, QStringLiteral("DeleteEmassImport"), q);
     }
     return ret;
@@ -851,24 +863,29 @@ bool DbManager::DeleteSTIG(int id)
         ret = true; //assume success from here.
         q.prepare(QStringLiteral("DELETE FROM STIGCheckCCI WHERE STIGCheckId IN (SELECT id FROM STIGCheck WHERE STIGId = :STIGId)"));
         q.bindValue(QStringLiteral(":STIGId"), id);
-        ret = q.exec() && ret; //q.exec() first toavoid short-circuit evaluation
+        ret = Exec(q, QStringLiteral("DeleteSTIG")) && ret; //Exec() first toavoid short-circuit evaluation
         q.prepare(QStringLiteral("DELETE FROM STIGCheckLegacyId WHERE STIGCheckId IN (SELECT id FROM STIGCheck WHERE STIGId = :STIGId)"));
         q.bindValue(QStringLiteral(":STIGId"), id);
-        ret = q.exec() && ret;
+        ret = Exec(q, QStringLiteral("DeleteSTIG")) && ret;
         Log(6, QStringLiteral("DeleteSTIG-STIGCheckCCI"), q);
+        //the search index is optional; failing to update it does not fail the deletion
+        q.prepare(QStringLiteral("DELETE FROM STIGCheckSearch WHERE rowid IN (SELECT id FROM STIGCheck WHERE STIGId = :STIGId)"));
+        q.bindValue(QStringLiteral(":STIGId"), id);
+        Exec(q, QStringLiteral("DeleteSTIG"));
+        Log(6, QStringLiteral("DeleteSTIG-STIGCheckSearch"), q);
         q.prepare(QStringLiteral("DELETE FROM STIGCheck WHERE STIGId = :STIGId"));
         q.bindValue(QStringLiteral(":STIGId"), id);
-        ret = q.exec() && ret;
+        ret = Exec(q, QStringLiteral("DeleteSTIG")) && ret;
         Log(6, QStringLiteral("DeleteSTIG-STIGCheck"), q);
         q.prepare(QStringLiteral("DELETE FROM Supplement WHERE STIGId = :STIGId"));
         q.bindValue(QStringLiteral(":STIGId"), id);
-        ret = q.exec() && ret;
+        ret = Exec(q, QStringLiteral("DeleteSTIG")) && ret;
         Log(6, QStringLiteral("DeleteSTIG-Supplement"), q);
         q.prepare(QStringLiteral("DELETE FROM STIG WHERE id = :id"));
         q.bindValue(QStringLiteral(":id"), id);
-        ret = q.exec() && ret;
+        ret = Exec(q, QStringLiteral("DeleteSTIG")) && ret;
         if (!_delayCommit)
-            db.commit();
+            Commit(db);
         Log(6, QStringLiteral("DeleteSTIG-STIG"), q);
     }
     return ret;
@@ -910,13 +927,13 @@ bool DbManager::DeleteSTIGFromAsset(const STIG &stig, const Asset &asset)
             q.prepare(QStringLiteral("DELETE FROM AssetSTIG WHERE AssetId = :AssetId AND STIGId = :STIGId"));
             q.bindValue(QStringLiteral(":AssetId"), tmpAsset.id);
             q.bindValue(QStringLiteral(":STIGId"), tmpSTIG.id);
-            ret = q.exec() && ret; //q.exec() first to avoid short-circuit execution
+            ret = Exec(q, QStringLiteral("DeleteSTIGFromAsset")) && ret; //Exec() first to avoid short-circuit execution
             Log(6, QStringLiteral("DeleteSTIGFromAsset-AssetSTIG"), q);
             q.prepare(QStringLiteral("DELETE FROM CKLCheck WHERE AssetId = :AssetId AND STIGCheckId IN (SELECT id FROM STIGCheck WHERE STIGId = :STIGId)"));
             q.bindValue(QStringLiteral(":AssetId"), tmpAsset.id);
             q.bindValue(QStringLiteral(":STIGId"), tmpSTIG.id);
-            ret = q.exec() && ret;
-            db.commit();
+            ret = Exec(q, QStringLiteral("DeleteSTIGFromAsset")) && ret;
+            Commit(db);
             Log(6, QStringLiteral("DeleteSTIGFromAsset-CKLCheck"), q);
         }
     }
@@ -1046,7 +1063,7 @@ QVector<Asset> DbManager::GetAssets(const QString &whereClause, const QVector<st
             std::tie(key, val) = variable;
             q.bindValue(key, val);
         }
-        q.exec();
+        Exec(q, QStringLiteral("GetAssets"));
         while (q.next())
         {
             Asset a;
@@ -1067,6 +1084,49 @@ QVector<Asset> DbManager::GetAssets(const QString &whereClause, const QVector<st
     return ret;
 }
 
+/**
+ * @brief DbManager::GetAssetCount
+ * @return The number of @a Assets.
+ */
+int DbManager::GetAssetCount()
+{
+    QSqlDatabase db;
+    int ret = 0;
+    if (CheckDatabase(db))
+    {
+        QSqlQuery q(db);
+        q.prepare(QStringLiteral("SELECT count(*) FROM Asset"));
+        Exec(q, QStringLiteral("GetAssetCount"));
+        if (q.next())
+            ret = q.value(0).toInt();
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::GetAssetRows
+ * @return The id and displayed name of each @a Asset, without
+ * loading the rest of each @a Asset.
+ */
+QVector<DbListRow> DbManager::GetAssetRows()
+{
+    QSqlDatabase db;
+    QVector<DbListRow> ret;
+    if (CheckDatabase(db))
+    {
+        QSqlQuery q(db);
+        q.prepare(QStringLiteral("SELECT id, hostName FROM Asset ORDER BY LOWER(hostName), hostName"));
+        Exec(q, QStringLiteral("GetAssetRows"));
+        while (q.next())
+        {
+            Asset a;
+            a.hostName = q.value(1).toString();
+            ret.append({q.value(0).toInt(), PrintAsset(a), a.hostName});
+        }
+    }
+    return ret;
+}
+
 /**
  * @overload DbManager::GetAssets(const STIG &stig)
  * @brief DbManager::GetAssets
@@ -1138,7 +1198,7 @@ QVector<CCI> DbManager::GetCCIs(int STIGCheckId)
         QSqlQuery q(db);
         q.prepare(QStringLiteral("SELECT CCIId FROM STIGCheckCCI WHERE STIGCheckCCI.STIGCheckId = :STIGCheckId"));
         q.bindValue(QStringLiteral(":STIGCheckId"), STIGCheckId);
-        q.exec();
+        Exec(q, QStringLiteral("GetCCIs"));
         while (q.next())
         {
             ret.append(GetCCI(q.value(0).toInt()));
@@ -1271,7 +1331,7 @@ QVector<CCI> DbManager::GetCCIs(const QString &whereClause, const QVector<std::t
             std::tie(key, val) = variable;
             q.bindValue(key, val);
         }
-        q.exec();
+        Exec(q, QStringLiteral("GetCCIs"));
         while (q.next())
         {
             CCI c;
@@ -1301,6 +1361,29 @@ QVector<CCI> DbManager::GetCCIs(const QString &whereClause, const QVector<std::t
     return ret;
 }
 
+/**
+ * @brief DbManager::GetCCIRows
+ * @return The id and displayed name of each @a CCI, without loading
+ * the definitions and eMASS import information.
+ */
+QVector<DbListRow> DbManager::GetCCIRows()
+{
+    QSqlDatabase db;
+    QVector<DbListRow> ret;
+    if (CheckDatabase(db))
+    {
+        QSqlQuery q(db);
+        q.prepare(QStringLiteral("SELECT id, cci FROM CCI ORDER BY cci"));
+        Exec(q, QStringLiteral("GetCCIRows"));
+        while (q.next())
+        {
+            QString text = PrintCCI(q.value(1).toInt());
+            ret.append({q.value(0).toInt(), text, text});
+        }
+    }
+    return ret;
+}
+
 /**
  * @brief DbManager::GetCKLCheck
  * @param id
@@ -1368,6 +1451,52 @@ CKLCheck DbManager::GetCKLCheckByDISAId(int assetId, const QString &disaId)
     return check;
 }
 
+/**
+ * @brief DbManager::GetCKLCheckRows
+ * @param asset
+ * @param afterId
+ * @param limit
+ * @return The compact display information of each @a CKLCheck of
+ * the @a Asset.
+ *
+ * The effective @a Severity, rule, and vulnerability number are
+ * joined from the @a STIGCheck so that the checks can be displayed,
+ * sorted, and filtered without loading each @a STIGCheck.
+ *
+ * The checks are ordered by id. To read them in pages, provide the
+ * last id of the previous page as @a afterId and the page size as
+ * @a limit. A negative @a limit returns all remaining checks.
+ */
+QVector<CKLCheckRow> DbManager::GetCKLCheckRows(const Asset &asset, int afterId, int limit)
+{
+    QSqlDatabase db;
+    QVector<CKLCheckRow> ret;
+    if (CheckDatabase(db))
+    {
+        QSqlQuery q(db);
+        //a severityOverride of 0 (Severity::none) defers to the STIGCheck's severity; older databases stored it as ''
+        q.prepare(QStringLiteral("SELECT CKLCheck.id, CKLCheck.STIGCheckId, CKLCheck.status, CKLCheck.severityOverride, STIGCheck.severity, COALESCE(NULLIF(CAST(CKLCheck.severityOverride AS INTEGER), 0), STIGCheck.severity), STIGCheck.rule, STIGCheck.vulnNum FROM CKLCheck JOIN STIGCheck ON CKLCheck.STIGCheckId = STIGCheck.id WHERE CKLCheck.AssetId = :AssetId AND CKLCheck.id > :afterId ORDER BY CKLCheck.id LIMIT :limit"));
+        q.bindValue(QStringLiteral(":AssetId"), asset.id);
+        q.bindValue(QStringLiteral(":afterId"), afterId);
+        q.bindValue(QStringLiteral(":limit"), limit);
+        Exec(q, QStringLiteral("GetCKLCheckRows"));
+        while (q.next())
+        {
+            CKLCheckRow r;
+            r.id = q.value(0).toInt();
+            r.stigCheckId = q.value(1).toInt();
+            r.status = static_cast<Status>(q.value(2).toInt());
+            r.severityOverride = static_cast<Severity>(q.value(3).toInt());
+            r.stigSeverity = static_cast<Severity>(q.value(4).toInt());
+            r.severity = static_cast<Severity>(q.value(5).toInt());
+            r.rule = q.value(6).toString();
+            r.vulnNum = q.value(7).toString();
+            ret.append(r);
+        }
+    }
+    return ret;
+}
+
 /**
  * @overload DbManager::GetCKLChecks(const QString &whereClause, const QVector<std::tuple<QString, QVariant> > &variables)
  * @brief DbManager::GetCKLChecks
@@ -1466,7 +1595,7 @@ QVector<CKLCheck> DbManager::GetCKLChecks(const QString &whereClause, const QVec
             std::tie(key, val) = variable;
             q.bindValue(key, val);
         }
-        q.exec();
+        Exec(q, QStringLiteral("GetCKLChecks"));
         while (q.next())
         {
             CKLCheck c;
@@ -1545,6 +1674,33 @@ STIGCheck DbManager::GetSTIGCheck(const STIGCheck &stigcheck)
     return GetSTIGCheck(stigcheck.GetSTIG(), stigcheck.rule);
 }
 
+/**
+ * @brief DbManager::GetSTIGCheckRules
+ * @param stig
+ * @return The rule and vulnerability number of each @a STIGCheck of
+ * the @a stig, keyed by the @a STIGCheck's id.
+ *
+ * Unlike GetSTIGChecks(), the rest of each @a STIGCheck (including
+ * its @a CCIs and legacy IDs) is not loaded.
+ */
+QHash<int, QPair<QString, QString>> DbManager::GetSTIGCheckRules(const STIG &stig)
+{
+    QSqlDatabase db;
+    QHash<int, QPair<QString, QString>> ret;
+    if (CheckDatabase(db))
+    {
+        QSqlQuery q(db);
+        q.prepare(QStringLiteral("SELECT id, rule, vulnNum FROM STIGCheck WHERE STIGId = :STIGId"));
+        q.bindValue(QStringLiteral(":STIGId"), stig.id);
+        Exec(q, QStringLiteral("GetSTIGCheckRules"));
+        while (q.next())
+        {
+            ret.insert(q.value(0).toInt(), qMakePair(q.value(1).toString(), q.value(2).toString()));
+        }
+    }
+    return ret;
+}
+
 /**
  * @brief DbManager::GetSTIGChecks
  * @param stig
@@ -1631,7 +1787,7 @@ QVector<STIGCheck> DbManager::GetSTIGChecks(const QString &whereClause, const QV
             std::tie(key, val) = variable;
             q.bindValue(key, val);
         }
-        q.exec();
+        Exec(q, QStringLiteral("GetSTIGChecks"));
         while (q.next())
         {
             STIGCheck c;
@@ -1745,7 +1901,7 @@ QVector<STIG> DbManager::GetSTIGs(const QString &whereClause, const QVector<std:
             std::tie(key, val) = variable;
             q.bindValue(key, val);
         }
-        q.exec();
+        Exec(q, QStringLiteral("GetSTIGs"));
         while (q.next())
         {
             STIG s;
@@ -1762,6 +1918,32 @@ QVector<STIG> DbManager::GetSTIGs(const QString &whereClause, const QVector<std:
     return ret;
 }
 
+/**
+ * @brief DbManager::GetSTIGRows
+ * @return The id and displayed name of each @a STIG. The title of
+ * each @a STIG is provided to filter the list.
+ */
+QVector<DbListRow> DbManager::GetSTIGRows()
+{
+    QSqlDatabase db;
+    QVector<DbListRow> ret;
+    if (CheckDatabase(db))
+    {
+        QSqlQuery q(db);
+        q.prepare(QStringLiteral("SELECT id, title, release, version FROM STIG ORDER BY LOWER(title), title"));
+        Exec(q, QStringLiteral("GetSTIGRows"));
+        while (q.next())
+        {
+            STIG s;
+            s.title = q.value(1).toString();
+            s.release = q.value(2).toString();
+            s.version = q.value(3).toInt();
+            ret.append({q.value(0).toInt(), PrintSTIG(s), s.title});
+        }
+    }
+    return ret;
+}
+
 /**
  * @brief DbManager::GetSupplements
  * @param stig
@@ -1777,7 +1959,7 @@ QVector<Supplement> DbManager::GetSupplements(const STIG &stig)
         QString toPrep = QStringLiteral("SELECT id, path, contents FROM Supplement WHERE STIGId = :STIGId");
         q.prepare(toPrep);
         q.bindValue(QStringLiteral(":STIGId"), stig.id);
-        q.exec();
+        Exec(q, QStringLiteral("GetSupplements"));
         while (q.next())
         {
             Supplement s;
@@ -1935,7 +2117,7 @@ QVector<Control> DbManager::GetControls(const QString &whereClause, const QVecto
             std::tie(key, val) = variable;
             q.bindValue(key, val);
         }
-        q.exec();
+        Exec(q, QStringLiteral("GetControls"));
         while (q.next())
         {
             Control c;
@@ -1991,7 +2173,7 @@ QVector<QString> DbManager::GetLegacyIds(int STIGCheckId)
         QSqlQuery q(db);
         q.prepare(QStringLiteral("SELECT LegacyId FROM STIGCheckLegacyId WHERE STIGCheckCCI.STIGCheckId = :STIGCheckId"));
         q.bindValue(QStringLiteral(":STIGCheckId"), STIGCheckId);
-        q.exec();
+        Exec(q, QStringLiteral("GetLegacyIds"));
         while (q.next())
         {
             ret.append(q.value(0).toString());
@@ -2109,7 +2291,7 @@ QVector<Family> DbManager::GetFamilies(const QString &whereClause, const QVector
             std::tie(key, val) = variable;
             q.bindValue(key, val);
         }
-        q.exec();
+        Exec(q, QStringLiteral("GetFamilies"));
         while (q.next())
         {
             Family f;
@@ -2203,7 +2385,7 @@ QString DbManager::GetVariable(const QString &name)
         QSqlQuery q(db);
         q.prepare(QStringLiteral("SELECT value FROM variables WHERE name = :name"));
         q.bindValue(QStringLiteral(":name"), name);
-        q.exec();
+        Exec(q, QStringLiteral("GetVariable"));
         if (q.next())
         {
             ret = q.value(0).toString();
@@ -2224,7 +2406,7 @@ bool DbManager::IsEmassImport()
     {
         QSqlQuery q(db);
         q.prepare(QStringLiteral("SELECT COUNT(*) FROM CCI WHERE isImport > 0"));
-        q.exec();
+        Exec(q, QStringLiteral("IsEmassImport"));
         if (q.next() && q.value(0).toInt() > 0)
         {
             return true;
@@ -2233,6 +2415,16 @@ bool DbManager::IsEmassImport()
     return false;
 }
 
+/**
+ * @brief DbManager::QueryCount
+ * @return The number of queries that have been executed by every
+ * thread since the application started.
+ */
+quint64 DbManager::QueryCount()
+{
+    return QueryStats::Count();
+}
+
 /**
  * @brief DbManager::LoadDB
  * @param path
@@ -2302,6 +2494,50 @@ bool DbManager::Log(int severity, const QString &location, const QString &messag
     return ret;
 }
 
+/**
+ * @brief DbManager::LogBatch
+ * @param location
+ * @param messages
+ * @return true if every log record is written to the database;
+ * otherwise, false.
+ *
+ * Log several events (severity and message) in one transaction.
+ */
+bool DbManager::LogBatch(const QString &location, const QVector<QPair<int, QString>> &messages)
+{
+    bool ret = false;
+    QSqlDatabase db;
+    if (CheckDatabase(db))
+    {
+        bool transaction = db.transaction();
+        QSqlQuery q(db);
+        q.prepare(QStringLiteral("INSERT INTO Log (`when`, `severity`, `location`, `message`, `user`) VALUES(:datetime, :severity, :location, :message, :user)"));
+        //get ISO 8601 datestamp with timezone
+        QString when = QDateTime::currentDateTime().toOffsetFromUtc(QDateTime::currentDateTime().offsetFromUtc()).toString(Qt::ISODate);
+        //logging of username required by STIG rule SV-84059r1_rule
+        QString user = QDir::home().dirName();
+        ret = true;
+        Q_FOREACH (const auto &message, messages)
+        {
+            q.bindValue(QStringLiteral(":datetime"), when);
+            q.bindValue(QStringLiteral(":severity"), message.first);
+            q.bindValue(QStringLiteral(":location"), location);
+            q.bindValue(QStringLiteral(":message"), message.second);
+            q.bindValue(QStringLiteral(":user"), user);
+            ret = q.exec() && ret;
+        }
+        //logging is not logged
+        if (transaction)
+        {
+            if (ret)
+                ret = db.commit();
+            else
+                db.rollback();
+        }
+    }
+    return ret;
+}
+
 /**
  * @brief DbManager::SaveDB
  * @param path
@@ -2325,6 +2561,100 @@ bool DbManager::SaveDB(const QString &path)
     return false;
 }
 
+/**
+ * @brief DbManager::SearchSTIGChecks
+ * @param search
+ * @param limit
+ * @return Up to @a limit @a STIGChecks matching the @a search text,
+ * best matches first.
+ *
+ * Each whitespace-separated word of the @a search must appear in the
+ * STIG title or in the check's rule, vulnerability number, title,
+ * check, fix, or discussion text. A trailing "*" matches any word
+ * starting with the term. When the @a search contains double quotes,
+ * it is passed to the FTS5 query syntax unchanged.
+ */
+QVector<STIGCheckHit> DbManager::SearchSTIGChecks(const QString &search, int limit)
+{
+    QSqlDatabase db;
+    QVector<STIGCheckHit> ret;
+    if (CheckDatabase(db))
+    {
+        QString simplified = search.simplified();
+        if (simplified.isEmpty())
+            return ret;
+        QStringList terms = simplified.split(' ');
+
+        QString match = search;
+        if (!search.contains('"'))
+        {
+            //quote each term so that punctuation (e.g. "V-1234") is not parsed as FTS5 syntax
+            QStringList quoted;
+            Q_FOREACH (QString term, terms)
+            {
+                bool prefix = term.endsWith('*');
+                if (prefix)
+                    term.chop(1);
+                if (!term.isEmpty())
+                    quoted.append('"' + term + '"' + (prefix ? QStringLiteral("*") : QString()));
+            }
+            match = quoted.join(' ');
+        }
+
+        QSqlQuery q(db);
+        //rank rule and vulnerability number hits above STIG titles, and STIG titles above the check content
+        q.prepare(QStringLiteral("SELECT rowid, stigTitle, rule, title, snippet(STIGCheckSearch, -1, '', '', '…', 16) FROM STIGCheckSearch WHERE STIGCheckSearch MATCH :match ORDER BY bm25(STIGCheckSearch, 2.0, 10.0, 10.0, 5.0, 1.0, 1.0, 1.0) LIMIT :limit"));
+        q.bindValue(QStringLiteral(":match"), match);
+        q.bindValue(QStringLiteral(":limit"), limit);
+        if (!Exec(q, QStringLiteral("SearchSTIGChecks")))
+        {
+            //no full-text index is available; fall back to a substring search of the check content
+            Log(6, QStringLiteral("SearchSTIGChecks"), q);
+            QStringList where;
+            for (int i = 0; i < terms.count(); i++)
+            {
+                QString var = ":term" + QString::number(i);
+                where.append("(STIG.title LIKE " + var + " OR STIGCheck.rule LIKE " + var + " OR STIGCheck.vulnNum LIKE " + var + " OR STIGCheck.title LIKE " + var + " OR STIGCheck.`check` LIKE " + var + " OR STIGCheck.fix LIKE " + var + " OR STIGCheck.vulnDiscussion LIKE " + var + ")");
+            }
+            q.prepare("SELECT STIGCheck.id, STIG.title, STIGCheck.rule, STIGCheck.title, '' FROM STIGCheck JOIN STIG ON STIGCheck.STIGId = STIG.id WHERE " + where.join(QStringLiteral(" AND ")) + " ORDER BY STIG.title, STIGCheck.rule LIMIT :limit");
+            for (int i = 0; i < terms.count(); i++)
+            {
+                QString term = terms.at(i);
+                term.remove('"');
+                if (term.endsWith('*'))
+                    term.chop(1);
+                q.bindValue(":term" + QString::number(i), '%' + term + '%');
+            }
+            q.bindValue(QStringLiteral(":limit"), limit);
+            Exec(q, QStringLiteral("SearchSTIGChecks"));
+        }
+        while (q.next())
+        {
+            STIGCheckHit hit;
+            hit.stigCheckId = q.value(0).toInt();
+            hit.stigTitle = q.value(1).toString();
+            hit.rule = q.value(2).toString();
+            hit.title = q.value(3).toString();
+            hit.snippet = q.value(4).toString();
+            ret.append(hit);
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::SetDefaultPath
+ * @param path
+ *
+ * Use the database at @a path instead of the user's database. This
+ * must be set before the first connection is made, such as by tools
+ * that run against a scratch database.
+ */
+void DbManager::SetDefaultPath(const QString &path)
+{
+    defaultPath = path;
+}
+
 /**
  * @brief DbManager::HashDB
  * @return The SHA3_256 hash of the database file
@@ -2371,13 +2701,92 @@ bool DbManager::UpdateAsset(const Asset &asset)
             q.bindValue(QStringLiteral(":webDBSite"), asset.webDbSite.isEmpty() ? nullptr : asset.webDbSite);
             q.bindValue(QStringLiteral(":webDBInstance"), asset.webDbInstance.isEmpty() ? nullptr : asset.webDbInstance);
             q.bindValue(QStringLiteral(":id"), tmpAsset.id);
-            ret = q.exec();
+            ret = Exec(q, QStringLiteral("UpdateAsset"));
             Log(6, QStringLiteral("UpdateAsset"), q);
         }
     }
     return ret;
 }
 
+/**
+ * @brief DbManager::UpdateAssetSTIGs
+ * @param asset
+ * @param addIds
+ * @param removeIds
+ * @return @c True when the STIGs with the ids in @a addIds are added
+ * to the @a Asset and the STIGs with the ids in @a removeIds, along
+ * with their checks, are removed from it. Otherwise, @c false.
+ *
+ * Every change is made in one transaction. When any change cannot be
+ * made, none are.
+ */
+bool DbManager::UpdateAssetSTIGs(const Asset &asset, const QVector<int> &addIds, const QVector<int> &removeIds)
+{
+    QSqlDatabase db;
+    bool ret = false;
+    if (addIds.isEmpty() && removeIds.isEmpty())
+        return true;
+    if (asset.id > 0 && CheckDatabase(db))
+    {
+        bool transaction = db.transaction();
+        QSqlQuery q(db);
+        ret = true;
+
+        //new STIGs start with every check not reviewed
+        QSqlQuery qChecks(db);
+        q.prepare(QStringLiteral("INSERT INTO AssetSTIG (`AssetId`, `STIGId`) VALUES(:AssetId, :STIGId)"));
+        qChecks.prepare(QStringLiteral("INSERT INTO CKLCheck (AssetId, STIGCheckId, status, findingDetails, comments, severityOverride, severityJustification) SELECT :AssetId, id, :status, '', '', :severityOverride, '' FROM STIGCheck WHERE STIGId = :STIGId"));
+        Q_FOREACH (int stigId, addIds)
+        {
+            q.bindValue(QStringLiteral(":AssetId"), asset.id);
+            q.bindValue(QStringLiteral(":STIGId"), stigId);
+            ret = Exec(q, QStringLiteral("UpdateAssetSTIGs"));
+            Log(6, QStringLiteral("UpdateAssetSTIGs-AssetSTIG"), q);
+            if (!ret)
+                break;
+            qChecks.bindValue(QStringLiteral(":AssetId"), asset.id);
+            qChecks.bindValue(QStringLiteral(":status"), Status::NotReviewed);
+            qChecks.bindValue(QStringLiteral(":severityOverride"), Severity::none);
+            qChecks.bindValue(QStringLiteral(":STIGId"), stigId);
+            ret = Exec(qChecks, QStringLiteral("UpdateAssetSTIGs"));
+            Log(6, QStringLiteral("UpdateAssetSTIGs-CKLCheck"), qChecks);
+            if (!ret)
+                break;
+        }
+
+        //removed STIGs take their checks with them
+        if (ret)
+        {
+            q.prepare(QStringLiteral("DELETE FROM AssetSTIG WHERE AssetId = :AssetId AND STIGId = :STIGId"));
+            qChecks.prepare(QStringLiteral("DELETE FROM CKLCheck WHERE AssetId = :AssetId AND STIGCheckId IN (SELECT id FROM STIGCheck WHERE STIGId = :STIGId)"));
+            Q_FOREACH (int stigId, removeIds)
+            {
+                q.bindValue(QStringLiteral(":AssetId"), asset.id);
+                q.bindValue(QStringLiteral(":STIGId"), stigId);
+                ret = Exec(q, QStringLiteral("UpdateAssetSTIGs"));
+                Log(6, QStringLiteral("UpdateAssetSTIGs-DeleteAssetSTIG"), q);
+                if (!ret)
+                    break;
+                qChecks.bindValue(QStringLiteral(":AssetId"), asset.id);
+                qChecks.bindValue(QStringLiteral(":STIGId"), stigId);
+                ret = Exec(qChecks, QStringLiteral("UpdateAssetSTIGs"));
+                Log(6, QStringLiteral("UpdateAssetSTIGs-DeleteCKLCheck"), qChecks);
+                if (!ret)
+                    break;
+            }
+        }
+
+        if (transaction)
+        {
+            if (ret)
+                ret = Commit(db);
+            else
+                db.rollback();
+        }
+    }
+    return ret;
+}
+
 /**
  * @brief DbManager::UpdateCCI
  * @param cci
@@ -2416,7 +2825,7 @@ bool DbManager::UpdateCCI(const CCI &cci)
             q.bindValue(QStringLiteral(":importImplementationGuidance"), cci.isImport ? cci.importImplementationGuidance : nullptr);
             q.bindValue(QStringLiteral(":importAssessmentProcedures"), cci.isImport ? cci.importAssessmentProcedures : nullptr);
             q.bindValue(QStringLiteral(":id"), tmpCCI.id);
-            ret = q.exec();
+            ret = Exec(q, QStringLiteral("UpdateCCI"));
             Log(6, QStringLiteral("UpdateCCI"), q);
         }
     }
@@ -2448,13 +2857,100 @@ bool DbManager::UpdateCKLCheck(const CKLCheck &check)
             q.bindValue(QStringLiteral(":severityOverride"), check.severityOverride);
             q.bindValue(QStringLiteral(":severityJustification"), check.severityJustification);
             q.bindValue(QStringLiteral(":id"), tmpCheck.id);
-            ret = q.exec();
+            ret = Exec(q, QStringLiteral("UpdateCKLCheck"));
             Log(6, QStringLiteral("UpdateCKLCheck"), q);
         }
     }
     return ret;
 }
 
+/**
+ * @brief DbManager::UpdateCKLChecks
+ * @param checks
+ * @return @c True when every @a CKLCheck in @a checks is updated.
+ * Otherwise, @c false.
+ *
+ * The checks are identified by their database ids and written in one
+ * transaction. When any check cannot be written, none are.
+ */
+bool DbManager::UpdateCKLChecks(const QVector<CKLCheck> &checks)
+{
+    QSqlDatabase db;
+    bool ret = false;
+    if (checks.isEmpty())
+        return true;
+    if (CheckDatabase(db))
+    {
+        bool transaction = db.transaction();
+        QSqlQuery q(db);
+        q.prepare(QStringLiteral("UPDATE CKLCheck SET status = :status, findingDetails = :findingDetails, comments = :comments, severityOverride = :severityOverride, severityJustification = :severityJustification WHERE id = :id"));
+        ret = true;
+        Q_FOREACH (const CKLCheck &check, checks)
+        {
+            q.bindValue(QStringLiteral(":status"), check.status);
+            q.bindValue(QStringLiteral(":findingDetails"), check.findingDetails);
+            q.bindValue(QStringLiteral(":comments"), check.comments);
+            q.bindValue(QStringLiteral(":severityOverride"), check.severityOverride);
+            q.bindValue(QStringLiteral(":severityJustification"), check.severityJustification);
+            q.bindValue(QStringLiteral(":id"), check.id);
+            ret = Exec(q, QStringLiteral("UpdateCKLChecks"));
+            Log(6, QStringLiteral("UpdateCKLChecks"), q);
+            if (!ret)
+                break;
+        }
+        if (transaction)
+        {
+            if (ret)
+                ret = Commit(db);
+            else
+                db.rollback();
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::UpdateCKLCheckStatus
+ * @param ids
+ * @param status
+ * @return @c True when the compliance @a status of every @a CKLCheck
+ * in @a ids is updated. Otherwise, @c false.
+ *
+ * The checks are updated with a single statement in one transaction,
+ * so large selections of checks can be set at once.
+ */
+bool DbManager::UpdateCKLCheckStatus(const QVector<int> &ids, Status status)
+{
+    QSqlDatabase db;
+    bool ret = false;
+    if (ids.isEmpty())
+        return true;
+    if (CheckDatabase(db))
+    {
+        QStringList idList;
+        idList.reserve(ids.count());
+        Q_FOREACH (int id, ids)
+        {
+            idList.append(QString::number(id));
+        }
+        bool transaction = db.transaction();
+        QSqlQuery q(db);
+        //the ids are integers, so they are listed directly instead of binding one parameter per check
+        q.prepare("UPDATE CKLCheck SET status = :status WHERE id IN (" + idList.join(',') + ")");
+        q.bindValue(QStringLiteral(":status"), status);
+        ret = Exec(q, QStringLiteral("UpdateCKLCheckStatus"));
+        Log(6, QStringLiteral("UpdateCKLCheckStatus"), q);
+        if (transaction)
+        {
+            if (ret)
+                ret = Commit(db);
+            else
+                db.rollback();
+        }
+    }
+    return ret;
+}
+
 /**
  * @brief DbManager::UpdateSTIG
  * @param stig
@@ -2481,8 +2977,9 @@ bool DbManager::UpdateSTIG(const STIG &stig)
             q.bindValue(QStringLiteral(":benchmarkId"), stig.benchmarkId);
             q.bindValue(QStringLiteral(":fileName"), stig.fileName);
             q.bindValue(QStringLiteral(":id"), stig.id);
-            ret = q.exec();
+            ret = Exec(q, QStringLiteral("UpdateSTIG"));
             Log(6, QStringLiteral("UpdateSTIG"), q);
+            UpdateSearchIndex(QStringLiteral("WHERE STIGCheck.STIGId = :STIGId"), {std::make_tuple<QString, QVariant>(QStringLiteral(":STIGId"), stig.id)});
         }
     }
 
@@ -2533,32 +3030,33 @@ bool DbManager::UpdateSTIGCheck(const STIGCheck &check)
             q.bindValue(QStringLiteral(":targetKey"), check.targetKey);
             q.bindValue(QStringLiteral(":isRemap"), check.isRemap);
             q.bindValue(QStringLiteral(":id"), check.id);
-            ret = q.exec();
+            ret = Exec(q, QStringLiteral("UpdateSTIGCheck"));
             Log(6, QStringLiteral("UpdateSTIGCheck-STIGCheck"), q);
             q.prepare(QStringLiteral("DELETE FROM STIGCheckCCI WHERE STIGCheckId = :STIGCheckId"));
             q.bindValue(QStringLiteral(":STIGCheckId"), tmpCheck.id);
-            ret = q.exec() && ret;
+            ret = Exec(q, QStringLiteral("UpdateSTIGCheck")) && ret;
             Log(6, QStringLiteral("UpdateSTIGCheck-STIGCheckCCI1"), q);
             Q_FOREACH (int cciId, check.cciIds)
             {
                 q.prepare(QStringLiteral("INSERT INTO STIGCheckCCI (`STIGCheckId`, `CCIId`) VALUES(:STIGCheckId, :CCIId)"));
                 q.bindValue(QStringLiteral(":STIGCheckId"), tmpCheck.id);
                 q.bindValue(QStringLiteral(":CCIId"), cciId);
-                ret = q.exec() && ret;
+                ret = Exec(q, QStringLiteral("UpdateSTIGCheck")) && ret;
                 Log(6, QStringLiteral("UpdateSTIGCheck-STIGCheckCCI2"), q);
             }
             q.prepare(QStringLiteral("DELETE FROM STIGCheckLegacyId WHERE STIGCheckId = :STIGCheckId"));
             q.bindValue(QStringLiteral(":STIGCheckId"), tmpCheck.id);
-            ret = q.exec() && ret;
+            ret = Exec(q, QStringLiteral("UpdateSTIGCheck")) && ret;
             Log(6, QStringLiteral("UpdateSTIGCheck-STIGCheckLegacyId1"), q);
             Q_FOREACH (QString legacyId, check.legacyIds)
             {
                 q.prepare(QStringLiteral("INSERT INTO STIGCheckLegacyId (`STIGCheckId`, `LegacyId`) VALUES(:STIGCheckId, :LegacyId)"));
                 q.bindValue(QStringLiteral(":STIGCheckId"), tmpCheck.id);
                 q.bindValue(QStringLiteral(":LegacyId"), legacyId);
-                ret = q.exec() && ret;
+                ret = Exec(q, QStringLiteral("UpdateSTIGCheck")) && ret;
                 Log(6, QStringLiteral("UpdateSTIGCheck-STIGCheckLegacyId2"), q);
             }
+            UpdateSearchIndex(QStringLiteral("WHERE STIGCheck.id = :id"), {std::make_tuple<QString, QVariant>(QStringLiteral(":id"), tmpCheck.id)});
         }
     }
     return ret;
@@ -2581,7 +3079,7 @@ bool DbManager::UpdateVariable(const QString &name, const QString &value)
         q.prepare(QStringLiteral("UPDATE variables SET value = :value WHERE name = :name"));
         q.bindValue(QStringLiteral(":value"), value);
         q.bindValue(QStringLiteral(":name"), name);
-        ret = q.exec();
+        ret = Exec(q, QStringLiteral("UpdateVariable"));
         Log(6, QStringLiteral("UpdateVariable"), q);
     }
     return ret;
@@ -2608,6 +3106,70 @@ bool DbManager::CheckDatabase(QSqlDatabase &db)
     return db.isValid();
 }
 
+/**
+ * @brief DbManager::Commit
+ * @param db
+ * @return The result of committing the @a db's transaction.
+ *
+ * Commits are traced so that time spent waiting on the disk shows up
+ * in the timeline.
+ */
+bool DbManager::Commit(QSqlDatabase &db)
+{
+    TraceSpan span(QStringLiteral("commit"), "sql");
+    return db.commit();
+}
+
+/**
+ * @brief DbManager::Exec
+ * @param query
+ * @param location
+ * @return The result of executing the @a query.
+ *
+ * Execute the @a query and record its latency and the number of rows
+ * it changed under @a location in @a QueryStats. The rows of a SELECT
+ * are not counted: counting them would fetch and cache the whole
+ * result before the caller reads the first row.
+ *
+ * Queries slower than QueryStats::SlowThreshold() are logged with
+ * their query plan. The query is traced as a span named @a location.
+ */
+bool DbManager::Exec(QSqlQuery &query, const QString &location)
+{
+    TraceSpan span(location, "sql");
+    QElapsedTimer timer;
+    timer.start();
+    bool ret = query.exec();
+    qint64 rows = -1;
+    if (ret && !query.isSelect())
+        rows = query.numRowsAffected();
+    qint64 nsecs = timer.nsecsElapsed();
+    QueryStats::Record(location, nsecs, rows);
+
+    int threshold = QueryStats::SlowThreshold();
+    if (threshold > 0 && nsecs >= static_cast<qint64>(threshold) * 1000000)
+    {
+        SlowQuery slow;
+        slow.when = QDateTime::currentDateTime();
+        slow.location = location;
+        slow.ms = static_cast<double>(nsecs) / 1000000.0;
+        slow.query = GetLastExecutedQuery(query);
+        QSqlDatabase db;
+        if (CheckDatabase(db))
+        {
+            QSqlQuery q(db);
+            if (q.exec(QStringLiteral("EXPLAIN QUERY PLAN ") + slow.query))
+            {
+                while (q.next())
+                    slow.plan.append(q.value(QStringLiteral("detail")).toString() + QStringLiteral("\n"));
+            }
+        }
+        QueryStats::RecordSlow(slow);
+        Log(4, location, QStringLiteral("Slow query (") + QString::number(slow.ms, 'f', 1) + QStringLiteral(" ms): ") + slow.query + QStringLiteral("\n") + slow.plan);
+    }
+    return ret;
+}
+
 /**
  * @brief DbManager::UpdateDatabaseFromVersion
  * @param version
@@ -2815,6 +3377,100 @@ bool DbManager::UpdateDatabaseFromVersion(int version)
             ret = UpdateVariable(QStringLiteral("quarterly"), QStringLiteral("https://dl.dod.cyber.mil/wp-content/uploads/stigs/zip/U_SRG-STIG_Library_2020_07v2.zip")) && ret;
             ret = UpdateVariable(QStringLiteral("version"), QStringLiteral("3")) && ret;
         }
+        if (version < 4)
+        {
+            //full-text index of the STIG content; rowid is the STIGCheck id
+            QSqlQuery q(db);
+            q.prepare(QStringLiteral("CREATE VIRTUAL TABLE `STIGCheckSearch` USING fts5("
+                        "stigTitle, "
+                        "rule, "
+                        "vulnNum, "
+                        "title, "
+                        "checkText, "
+                        "fixText, "
+                        "vulnDiscussion, "
+                        "tokenize = 'porter unicode61'"
+                        ")"));
+            if (q.exec())
+                UpdateSearchIndex();
+            else
+                Log(2, QStringLiteral("UpdateDatabaseFromVersion-STIGCheckSearch"), QStringLiteral("FTS5 is unavailable; STIG content will be searched without an index."));
+            db.commit();
+            ret = UpdateVariable(QStringLiteral("version"), QStringLiteral("4")) && ret;
+        }
+        if (version < 5)
+        {
+            //minutes before an unviewed tab is suspended; 0 never suspends
+            QSqlQuery q(db);
+            q.prepare(QStringLiteral("INSERT INTO variables (name, value) VALUES(:name, :value)"));
+            q.bindValue(QStringLiteral(":name"), QStringLiteral("suspendTabMinutes"));
+            q.bindValue(QStringLiteral(":value"), QStringLiteral("30"));
+            ret = q.exec() && ret;
+            db.commit();
+            ret = UpdateVariable(QStringLiteral("version"), QStringLiteral("5")) && ret;
+        }
+        if (version < 6)
+        {
+            //MiB the background jobs try to stay within; 0 is unlimited
+            QSqlQuery q(db);
+            q.prepare(QStringLiteral("INSERT INTO variables (name, value) VALUES(:name, :value)"));
+            q.bindValue(QStringLiteral(":name"), QStringLiteral("memoryBudget"));
+            q.bindValue(QStringLiteral(":value"), QStringLiteral("2048"));
+            ret = q.exec() && ret;
+            db.commit();
+            ret = UpdateVariable(QStringLiteral("version"), QStringLiteral("6")) && ret;
+        }
+        if (version < 7)
+        {
+            //checks were once added with an empty severityOverride; 0 (Severity::none) defers to the STIGCheck's severity
+            QSqlQuery q(db);
+            q.prepare(QStringLiteral("UPDATE CKLCheck SET severityOverride = 0 WHERE severityOverride = '' OR severityOverride IS NULL"));
+            ret = q.exec() && ret;
+            db.commit();
+            ret = UpdateVariable(QStringLiteral("version"), QStringLiteral("7")) && ret;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief DbManager::UpdateSearchIndex
+ * @param whereClause
+ * @param variables
+ * @return @c True when the full-text index is updated. Otherwise,
+ * @c false.
+ *
+ * Rebuilds the full-text index entries of the @a STIGChecks selected
+ * by the optional @a whereClause. SQL parameters are bound by
+ * supplying them in a list of tuples in the @a variables parameter.
+ */
+bool DbManager::UpdateSearchIndex(const QString &whereClause, const QVector<std::tuple<QString, QVariant>> &variables)
+{
+    QSqlDatabase db;
+    bool ret = false;
+    if (CheckDatabase(db))
+    {
+        QString where = (!whereClause.isNull() && !whereClause.isEmpty()) ? " " + whereClause : QString();
+        QSqlQuery q(db);
+        ret = true;
+        Q_FOREACH (const QString &toPrep, QStringList({
+                      "DELETE FROM STIGCheckSearch WHERE rowid IN (SELECT STIGCheck.id FROM STIGCheck" + where + ")",
+                      "INSERT INTO STIGCheckSearch (rowid, stigTitle, rule, vulnNum, title, checkText, fixText, vulnDiscussion) SELECT STIGCheck.id, STIG.title, STIGCheck.rule, STIGCheck.vulnNum, STIGCheck.title, STIGCheck.`check`, STIGCheck.fix, STIGCheck.vulnDiscussion FROM STIGCheck JOIN STIG ON STIGCheck.STIGId = STIG.id" + where
+                  }))
+        {
+            q.prepare(toPrep);
+            for (const auto &variable : variables)
+            {
+                QString key;
+                QVariant val;
+                std::tie(key, val) = variable;
+                q.bindValue(key, val);
+            }
+            ret = Exec(q, QStringLiteral("UpdateSearchIndex")) && ret;
+            Log(6, QStringLiteral("UpdateSearchIndex"), q);
+        }
+        if (!_delayCommit)
+            Commit(db);
     }
     return ret;
 }
@@ -20,7 +20,9 @@
 #ifndef DBMANAGER_H
 #define DBMANAGER_H
 
+#include <QHash>
 #include <QSqlDatabase>
+#include <QPair>
 #include <QString>
 #include <QVector>
 
@@ -35,6 +37,13 @@
 #include "stigcheck.h"
 #include "supplement.h"
 
+struct DbListRow
+{
+    int id; /**< database id */
+    QString text; /**< displayed text */
+    QString filter; /**< text matched when the list is filtered */
+};
+
 class DbManager
 {
 public:
@@ -67,10 +76,13 @@ public:
     Asset GetAsset(int id);
     Asset GetAsset(const QString &hostName);
     Asset GetAsset(const Asset &asset);
+    int GetAssetCount();
+    QVector<DbListRow> GetAssetRows();
     QVector<Asset> GetAssets(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
     QVector<Asset> GetAssets(const STIG &stig);
     CCI GetCCI(int id);
     CCI GetCCI(const CCI &cci, const STIG *stig = nullptr);
+    QVector<DbListRow> GetCCIRows();
     QVector<CCI> GetCCIs(QVector<int> ccis);
     QVector<CCI> GetCCIs(const Control &c);
     QVector<CCI> GetCCIs(int STIGCheckId);
@@ -79,6 +91,7 @@ public:
     CKLCheck GetCKLCheck(int id);
     CKLCheck GetCKLCheck(const CKLCheck &ckl);
     CKLCheck GetCKLCheckByDISAId(int assetId, const QString &disaId);
+    QVector<CKLCheckRow> GetCKLCheckRows(const Asset &asset, int afterId = -1, int limit = -1);
     QVector<CKLCheck> GetCKLChecks(const Asset &asset, const STIG *stig = nullptr);
     QVector<CKLCheck> GetCKLChecks(const CCI &cci);
     QVector<CKLCheck> GetCKLChecks(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
@@ -98,31 +111,43 @@ public:
     STIGCheck GetSTIGCheck(int id);
     STIGCheck GetSTIGCheck(const STIG &stig, const QString &rule);
     STIGCheck GetSTIGCheck(const STIGCheck &stigcheck);
+    QHash<int, QPair<QString, QString>> GetSTIGCheckRules(const STIG &stig);
     QVector<STIGCheck> GetSTIGChecks(const STIG &stig);
     QVector<STIGCheck> GetSTIGChecks(const CCI &cci);
     QVector<STIGCheck> GetSTIGChecks(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
+    QVector<DbListRow> GetSTIGRows();
     QVector<STIG> GetSTIGs(const Asset &asset);
     QVector<STIG> GetSTIGs(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant> > &variables = {});
     QVector<Supplement> GetSupplements(const STIG &stig);
     QString GetVariable(const QString &name);
 
     bool IsEmassImport();
+    static quint64 QueryCount();
 
     bool LoadDB(const QString &path);
     bool Log(int severity, const QString &location, const QString &message);
     bool Log(int severity, const QString &location, const QSqlQuery& query);
+    bool LogBatch(const QString &location, const QVector<QPair<int, QString>> &messages);
     bool SaveDB(const QString &path);
+    QVector<STIGCheckHit> SearchSTIGChecks(const QString &search, int limit = 500);
+    static void SetDefaultPath(const QString &path);
     QByteArray HashDB();
 
     bool UpdateAsset(const Asset &asset);
+    bool UpdateAssetSTIGs(const Asset &asset, const QVector<int> &addIds, const QVector<int> &removeIds);
     bool UpdateCCI(const CCI &cci);
     bool UpdateCKLCheck(const CKLCheck &check);
+    bool UpdateCKLChecks(const QVector<CKLCheck> &checks);
+    bool UpdateCKLCheckStatus(const QVector<int> &ids, Status status);
     bool UpdateSTIG(const STIG &stig);
     bool UpdateSTIGCheck(const STIGCheck &check);
     bool UpdateVariable(const QString &name, const QString &value);
 
 private:
+    static bool Commit(QSqlDatabase &db);
+    bool Exec(QSqlQuery &query, const QString &location);
     bool UpdateDatabaseFromVersion(int version);
+    bool UpdateSearchIndex(const QString &whereClause = QString(), const QVector<std::tuple<QString, QVariant>> &variables = {});
     static bool CheckDatabase(QSqlDatabase &db);
     QString _dbPath;
     bool _delayCommit{};
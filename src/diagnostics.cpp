@@ -0,0 +1,165 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dbmanager.h"
+#include "diagnostics.h"
+#include "querystats.h"
+#include "tracerecorder.h"
+#include "ui_diagnostics.h"
+
+#include <QApplication>
+#include <QClipboard>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QTableWidgetItem>
+
+/**
+ * @class Diagnostics
+ * @brief Displays the latency of the database queries, grouped by
+ * call site, and the slow-query log.
+ *
+ * It also records a timeline of the background jobs, which can be
+ * saved for chrome://tracing or ui.perfetto.dev.
+ */
+
+/**
+ * @brief Diagnostics::Diagnostics
+ * @param parent
+ *
+ * Default constructor.
+ */
+Diagnostics::Diagnostics(QWidget *parent) :
+    QWidget(parent),
+    ui(new Ui::Diagnostics)
+{
+    ui->setupUi(this);
+    this->setWindowTitle(QStringLiteral("Diagnostics"));
+    ui->spinSlow->setValue(QueryStats::SlowThreshold());
+    ui->cbTrace->setChecked(TraceRecorder::IsEnabled());
+    Refresh();
+}
+
+/**
+ * @brief Diagnostics::~Diagnostics
+ *
+ * Destructor.
+ */
+Diagnostics::~Diagnostics()
+{
+    delete ui;
+}
+
+/**
+ * @brief Diagnostics::Copy
+ *
+ * Copy the statistics to the clipboard as plain text.
+ */
+void Diagnostics::Copy()
+{
+    QApplication::clipboard()->setText(QueryStats::ToText());
+}
+
+/**
+ * @brief Diagnostics::Refresh
+ *
+ * Display the current statistics.
+ */
+void Diagnostics::Refresh()
+{
+    QVector<QueryStat> stats = QueryStats::Stats();
+    ui->tableStats->setSortingEnabled(false);
+    ui->tableStats->setRowCount(stats.count());
+    for (int i = 0; i < stats.count(); i++)
+    {
+        const QueryStat &s = stats.at(i);
+        auto *location = new QTableWidgetItem(s.location);
+        ui->tableStats->setItem(i, 0, location);
+        QVector<QVariant> values{s.count, s.rows, s.totalMs, s.p50Ms, s.p95Ms, s.p99Ms, s.maxMs};
+        for (int j = 0; j < values.count(); j++)
+        {
+            auto *item = new QTableWidgetItem();
+            //numbers sort by value rather than as text
+            item->setData(Qt::DisplayRole, values.at(j));
+            item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            ui->tableStats->setItem(i, j + 1, item);
+        }
+    }
+    ui->tableStats->setSortingEnabled(true);
+    ui->tableStats->resizeColumnsToContents();
+
+    QString slow;
+    Q_FOREACH (const SlowQuery &s, QueryStats::SlowQueries())
+    {
+        slow.append(s.when.toString(Qt::ISODate) + QStringLiteral(" ") + s.location + QStringLiteral(" took ") + QString::number(s.ms, 'f', 1) + QStringLiteral(" ms\n") + s.query + QStringLiteral("\n") + s.plan + QStringLiteral("\n"));
+    }
+    ui->txtSlow->setPlainText(slow);
+    ui->lblQueries->setText(QString::number(QueryStats::Count()) + QStringLiteral(" queries, ") + QString::number(TraceRecorder::Count()) + QStringLiteral(" trace spans"));
+}
+
+/**
+ * @brief Diagnostics::Reset
+ *
+ * Forget the recorded statistics, slow queries, and trace.
+ */
+void Diagnostics::Reset()
+{
+    QueryStats::Reset();
+    TraceRecorder::Reset();
+    Refresh();
+}
+
+/**
+ * @brief Diagnostics::SetSlowThreshold
+ * @param ms
+ *
+ * Log queries that take at least @a ms milliseconds, or none when
+ * @a ms is 0.
+ */
+void Diagnostics::SetSlowThreshold(int ms)
+{
+    QueryStats::SetSlowThreshold(ms);
+}
+
+/**
+ * @brief Diagnostics::SetTracing
+ * @param enabled
+ *
+ * Start or stop recording the timeline of the background jobs.
+ */
+void Diagnostics::SetTracing(bool enabled)
+{
+    TraceRecorder::SetEnabled(enabled);
+}
+
+/**
+ * @brief Diagnostics::WriteTrace
+ *
+ * Save the recorded timeline as Chrome trace event JSON.
+ */
+void Diagnostics::WriteTrace()
+{
+    DbManager db;
+    QString fn = QFileDialog::getSaveFileName(this, QStringLiteral("Save Trace"), db.GetVariable(QStringLiteral("lastdir")), QStringLiteral("Chrome Trace (*.json)"));
+
+    if (fn.isNull() || fn.isEmpty())
+        return; // cancel button pressed
+
+    db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(fn).absolutePath());
+    TraceRecorder::Write(fn);
+}
@@ -0,0 +1,49 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <QWidget>
+
+namespace Ui {
+class Diagnostics;
+}
+
+class Diagnostics : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit Diagnostics(QWidget *parent = nullptr);
+    ~Diagnostics();
+
+private Q_SLOTS:
+    void Copy();
+    void Refresh();
+    void Reset();
+    void SetSlowThreshold(int ms);
+    void SetTracing(bool enabled);
+    void WriteTrace();
+
+private:
+    Ui::Diagnostics *ui;
+};
+
+#endif // DIAGNOSTICS_H
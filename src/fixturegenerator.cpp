@@ -0,0 +1,404 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cci.h"
+#include "common.h"
+#include "control.h"
+#include "dbmanager.h"
+#include "fixturegenerator.h"
+
+#include <QDir>
+#include <QFile>
+#include <QStringList>
+#include <QXmlStreamWriter>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <zip.h>
+
+/**
+ * @class FixtureGenerator
+ * @brief Synthetic, but well-formed, STIG content for measuring
+ * STIGQter at scale without downloading anything.
+ *
+ * The same seed always produces the same content, so measurements
+ * can be compared between versions.
+ */
+
+/**
+ * @brief FixtureGenerator::FixtureGenerator
+ * @param seed
+ *
+ * Main constructor.
+ */
+FixtureGenerator::FixtureGenerator(quint32 seed) :
+    _random(seed),
+    _ccis(0),
+    _statusWeights({1, 0, 0, 0})
+{
+}
+
+/**
+ * @brief FixtureGenerator::AddCCIs
+ * @param count
+ * @return The number of CCIs added to the database.
+ *
+ * Add a family of twenty controls and @a count CCIs mapped to them
+ * so that the generated rules have CCIs to reference.
+ */
+int FixtureGenerator::AddCCIs(int count)
+{
+    DbManager db;
+    db.AddFamily(QStringLiteral("AC"), QStringLiteral("Access Control"));
+    for (int i = 1; i <= 20; i++)
+        db.AddControl(QStringLiteral("AC-") + QString::number(i), QStringLiteral("SYNTHETIC CONTROL ") + QString::number(i), Words(12));
+
+    int ret = 0;
+    for (int i = 1; i <= count; i++)
+    {
+        CCI c;
+        c.cci = i;
+        c.controlId = db.GetControl(QStringLiteral("AC-") + QString::number((i % 20) + 1)).id;
+        c.definition = Words(16);
+        if (db.AddCCI(c))
+            ret++;
+    }
+    _ccis = count;
+    return ret;
+}
+
+/**
+ * @brief FixtureGenerator::AddAssets
+ * @param count
+ * @param stigsPerAsset
+ * @return The number of checks whose status was set.
+ *
+ * Add @a count Assets, map @a stigsPerAsset of the imported STIGs to
+ * each of them in turn, and give every check a status drawn from the
+ * weights of SetStatusWeights().
+ */
+int FixtureGenerator::AddAssets(int count, int stigsPerAsset)
+{
+    DbManager db;
+    QVector<STIG> stigs = db.GetSTIGs();
+    if (stigs.isEmpty())
+        return 0;
+    stigsPerAsset = std::min(stigsPerAsset, stigs.count());
+
+    int ret = 0;
+    for (int i = 1; i <= count; i++)
+    {
+        Asset a;
+        a.hostName = QStringLiteral("SYNTHETIC-") + QString::number(i).rightJustified(5, '0');
+        a.hostIP = QStringLiteral("10.%1.%2.%3").arg((i >> 16) & 0xff).arg((i >> 8) & 0xff).arg(i & 0xff);
+        a.hostMAC = QStringLiteral("02:00:00:%1:%2:%3").arg((i >> 16) & 0xff, 2, 16, QChar('0')).arg((i >> 8) & 0xff, 2, 16, QChar('0')).arg(i & 0xff, 2, 16, QChar('0'));
+        a.hostFQDN = a.hostName.toLower() + QStringLiteral(".synthetic.local");
+        a.assetType = QStringLiteral("Computing");
+        a.webOrDB = false;
+        if (!db.AddAsset(a))
+            continue;
+        for (int j = 0; j < stigsPerAsset; j++)
+            db.AddSTIGToAsset(stigs.at((i - 1 + j) % stigs.count()), a);
+
+        QVector<CKLCheck> checks = a.GetCKLChecks();
+        for (CKLCheck &c : checks)
+        {
+            c.status = RandomStatus();
+            if (c.status != Status::NotReviewed)
+                c.findingDetails = Words(12);
+        }
+        if (db.UpdateCKLChecks(checks))
+            ret += checks.count();
+    }
+    return ret;
+}
+
+/**
+ * @brief FixtureGenerator::SetStatusWeights
+ * @param notReviewed
+ * @param open
+ * @param notAFinding
+ * @param notApplicable
+ *
+ * Set the relative share of each status given to the checks of
+ * generated Assets. By default, every check is Not Reviewed.
+ */
+void FixtureGenerator::SetStatusWeights(int notReviewed, int open, int notAFinding, int notApplicable)
+{
+    _statusWeights = {std::max(notReviewed, 0), std::max(open, 0), std::max(notAFinding, 0), std::max(notApplicable, 0)};
+}
+
+/**
+ * @brief FixtureGenerator::STIGXML
+ * @param index
+ * @param rules
+ * @return The XCCDF benchmark of the STIG numbered @a index with
+ * @a rules checks.
+ */
+QByteArray FixtureGenerator::STIGXML(int index, int rules)
+{
+    QByteArray ret;
+    QXmlStreamWriter stream(&ret);
+    stream.setAutoFormatting(true);
+    stream.writeStartDocument();
+    stream.writeStartElement(QStringLiteral("Benchmark"));
+    stream.writeDefaultNamespace(QStringLiteral("http://checklists.nist.gov/xccdf/1.1"));
+    stream.writeAttribute(QStringLiteral("id"), QStringLiteral("Synthetic_STIG_") + QString::number(index));
+    stream.writeTextElement(QStringLiteral("title"), QStringLiteral("Synthetic STIG ") + QString::number(index));
+    stream.writeTextElement(QStringLiteral("description"), Words(20));
+    stream.writeStartElement(QStringLiteral("plain-text"));
+    stream.writeAttribute(QStringLiteral("id"), QStringLiteral("release-info"));
+    stream.writeCharacters(QStringLiteral("Release: 1 Benchmark Date: 01 Jan 2020"));
+    stream.writeEndElement(); //plain-text
+    stream.writeTextElement(QStringLiteral("version"), QStringLiteral("1"));
+    stream.writeStartElement(QStringLiteral("Profile"));
+    stream.writeAttribute(QStringLiteral("id"), QStringLiteral("MAC-1_Classified"));
+    stream.writeTextElement(QStringLiteral("title"), QStringLiteral("I - Mission Critical Classified"));
+    stream.writeEndElement(); //Profile
+
+    static const QStringList severities{QStringLiteral("high"), QStringLiteral("medium"), QStringLiteral("medium"), QStringLiteral("low")};
+    for (int i = 0; i < rules; i++)
+    {
+        //vulnerability numbers are unique across every generated STIG
+        QString vulnNum = QString::number(index * 100000 + i + 1);
+        stream.writeStartElement(QStringLiteral("Group"));
+        stream.writeAttribute(QStringLiteral("id"), QStringLiteral("V-") + vulnNum);
+        stream.writeTextElement(QStringLiteral("title"), QStringLiteral("SRG-OS-") + vulnNum);
+        stream.writeStartElement(QStringLiteral("Rule"));
+        stream.writeAttribute(QStringLiteral("id"), QStringLiteral("SV-") + vulnNum + QStringLiteral("r1_rule"));
+        stream.writeAttribute(QStringLiteral("severity"), severities.at(static_cast<int>(_random.bounded(severities.count()))));
+        stream.writeAttribute(QStringLiteral("weight"), QStringLiteral("10.0"));
+        stream.writeTextElement(QStringLiteral("version"), QStringLiteral("SYN-") + vulnNum);
+        stream.writeTextElement(QStringLiteral("title"), Words(10));
+        stream.writeTextElement(QStringLiteral("description"), QStringLiteral("<VulnDiscussion>") + Words(60) + QStringLiteral("</VulnDiscussion><FalsePositives></FalsePositives><FalseNegatives></FalseNegatives><Documentable>false</Documentable><Mitigations></Mitigations><SeverityOverrideGuidance></SeverityOverrideGuidance><PotentialImpacts></PotentialImpacts><ThirdPartyTools></ThirdPartyTools><MitigationControl></MitigationControl><Responsibility>System Administrator</Responsibility><IAControls></IAControls>"));
+        if (_ccis > 0)
+        {
+            stream.writeStartElement(QStringLiteral("ident"));
+            stream.writeAttribute(QStringLiteral("system"), QStringLiteral("http://cyber.mil/cci"));
+            stream.writeCharacters(QStringLiteral("CCI-") + QString::number(_random.bounded(_ccis) + 1).rightJustified(6, '0'));
+            stream.writeEndElement(); //ident
+        }
+        stream.writeTextElement(QStringLiteral("fixtext"), Words(30));
+        stream.writeStartElement(QStringLiteral("check"));
+        stream.writeAttribute(QStringLiteral("system"), QStringLiteral("C-") + vulnNum + QStringLiteral("r1_chk"));
+        stream.writeStartElement(QStringLiteral("check-content-ref"));
+        stream.writeAttribute(QStringLiteral("name"), QStringLiteral("M"));
+        stream.writeAttribute(QStringLiteral("href"), QStringLiteral("Synthetic_STIG.xml"));
+        stream.writeEndElement(); //check-content-ref
+        stream.writeTextElement(QStringLiteral("check-content"), Words(40));
+        stream.writeEndElement(); //check
+        stream.writeEndElement(); //Rule
+        stream.writeEndElement(); //Group
+    }
+
+    stream.writeEndElement(); //Benchmark
+    stream.writeEndDocument();
+    return ret;
+}
+
+/**
+ * @brief FixtureGenerator::WriteSTIG
+ * @param dir
+ * @param index
+ * @param rules
+ * @return The path of the STIG .zip file written to @a dir, or an
+ * empty string when it could not be written.
+ *
+ * The .zip file is laid out like the ones DISA publishes so that it
+ * can be imported as-is.
+ */
+QString FixtureGenerator::WriteSTIG(const QString &dir, int index, int rules)
+{
+    QString baseName = QStringLiteral("U_Synthetic_STIG_") + QString::number(index) + QStringLiteral("_V1R1");
+    QString ret = QDir(dir).filePath(baseName + QStringLiteral("_STIG.zip"));
+    QByteArray contents = STIGXML(index, rules);
+
+    int err = 0;
+    struct zip *z = zip_open(ret.toStdString().c_str(), ZIP_CREATE | ZIP_TRUNCATE, &err);
+    if (!z)
+        return QString();
+
+    //libzip takes ownership of the copy and frees it once it is written
+    void *buf = malloc(static_cast<size_t>(contents.size()));
+    memcpy(buf, contents.constData(), static_cast<size_t>(contents.size()));
+    zip_source_t *source = zip_source_buffer(z, buf, static_cast<zip_uint64_t>(contents.size()), 1);
+    if (!source)
+    {
+        free(buf);
+        zip_discard(z);
+        return QString();
+    }
+    if (zip_file_add(z, (baseName + QStringLiteral("_Manual-xccdf.xml")).toUtf8().constData(), source, ZIP_FL_OVERWRITE | ZIP_FL_ENC_UTF_8) < 0)
+    {
+        zip_source_free(source);
+        zip_discard(z);
+        return QString();
+    }
+    if (zip_close(z) != 0)
+    {
+        zip_discard(z);
+        return QString();
+    }
+    return ret;
+}
+
+/**
+ * @brief FixtureGenerator::WriteXCCDFResults
+ * @param dir
+ * @param asset
+ * @param stig
+ * @return The path of the XCCDF results file written to @a dir, or an
+ * empty string when it could not be written.
+ *
+ * Write the checks of @a asset against @a stig the way an SCAP
+ * scanner reports them: a TestResult with one rule-result per rule.
+ */
+QString FixtureGenerator::WriteXCCDFResults(const QString &dir, const Asset &asset, const STIG &stig)
+{
+    DbManager db;
+    if (_cciNumbers.isEmpty())
+    {
+        Q_FOREACH (const CCI &c, db.GetCCIs())
+            _cciNumbers.insert(c.id, c.cci);
+    }
+    if (!_stigChecks.contains(stig.id))
+        _stigChecks.insert(stig.id, db.GetSTIGChecks(stig));
+    QHash<int, const STIGCheck*> stigChecks;
+    for (const STIGCheck &sc : _stigChecks[stig.id])
+        stigChecks.insert(sc.id, &sc);
+
+    QString ret = QDir(dir).filePath(PrintAsset(asset) + "_" + SanitizeFile(stig.title) + "_V" + QString::number(stig.version) + "R" + QString::number(GetReleaseNumber(stig.release)) + "_XCCDF-Results.xml");
+    QFile file(ret);
+    if (!file.open(QIODevice::WriteOnly))
+        return QString();
+
+    //timestamps are fixed so that the same seed writes the same file
+    static const QString timestamp = QStringLiteral("2020-01-01T00:00:00");
+    QXmlStreamWriter stream(&file);
+    stream.setAutoFormatting(true);
+    stream.writeStartDocument();
+    stream.writeStartElement(QStringLiteral("Benchmark"));
+    stream.writeDefaultNamespace(QStringLiteral("http://checklists.nist.gov/xccdf/1.1"));
+    stream.writeAttribute(QStringLiteral("id"), stig.benchmarkId);
+    stream.writeTextElement(QStringLiteral("title"), stig.title);
+    stream.writeTextElement(QStringLiteral("version"), QString::number(stig.version));
+    stream.writeStartElement(QStringLiteral("TestResult"));
+    stream.writeAttribute(QStringLiteral("id"), stig.benchmarkId + QStringLiteral("_testresult_") + asset.hostName);
+    stream.writeAttribute(QStringLiteral("start-time"), timestamp);
+    stream.writeAttribute(QStringLiteral("end-time"), timestamp);
+    stream.writeTextElement(QStringLiteral("title"), stig.title + QStringLiteral(" results for ") + asset.hostName);
+    stream.writeTextElement(QStringLiteral("target"), asset.hostName);
+    stream.writeTextElement(QStringLiteral("target-address"), asset.hostIP);
+    stream.writeStartElement(QStringLiteral("target-facts"));
+    stream.writeStartElement(QStringLiteral("fact"));
+    stream.writeAttribute(QStringLiteral("name"), QStringLiteral("urn:scap:fact:asset:identifier:fqdn"));
+    stream.writeAttribute(QStringLiteral("type"), QStringLiteral("string"));
+    stream.writeCharacters(asset.hostFQDN);
+    stream.writeEndElement(); //fact
+    stream.writeStartElement(QStringLiteral("fact"));
+    stream.writeAttribute(QStringLiteral("name"), QStringLiteral("urn:scap:fact:asset:identifier:mac"));
+    stream.writeAttribute(QStringLiteral("type"), QStringLiteral("string"));
+    stream.writeCharacters(asset.hostMAC);
+    stream.writeEndElement(); //fact
+    stream.writeEndElement(); //target-facts
+
+    Q_FOREACH (const CKLCheck &c, asset.GetCKLChecks(&stig))
+    {
+        const STIGCheck *sc = stigChecks.value(c.stigCheckId, nullptr);
+        if (!sc)
+            continue;
+        QString result;
+        switch (c.status)
+        {
+        case Status::Open:
+            result = QStringLiteral("fail");
+            break;
+        case Status::NotAFinding:
+            result = QStringLiteral("pass");
+            break;
+        case Status::NotApplicable:
+            result = QStringLiteral("notapplicable");
+            break;
+        default:
+            result = QStringLiteral("notchecked");
+            break;
+        }
+        stream.writeStartElement(QStringLiteral("rule-result"));
+        stream.writeAttribute(QStringLiteral("idref"), sc->rule);
+        stream.writeAttribute(QStringLiteral("severity"), GetSeverity(sc->severity, false));
+        stream.writeAttribute(QStringLiteral("time"), timestamp);
+        stream.writeAttribute(QStringLiteral("weight"), QString::number(sc->weight, 'f', 1));
+        stream.writeTextElement(QStringLiteral("result"), result);
+        Q_FOREACH (int cciId, sc->cciIds)
+        {
+            stream.writeStartElement(QStringLiteral("ident"));
+            stream.writeAttribute(QStringLiteral("system"), QStringLiteral("http://cyber.mil/cci"));
+            stream.writeCharacters(PrintCCI(_cciNumbers.value(cciId)));
+            stream.writeEndElement(); //ident
+        }
+        stream.writeEndElement(); //rule-result
+    }
+
+    stream.writeEndElement(); //TestResult
+    stream.writeEndElement(); //Benchmark
+    stream.writeEndDocument();
+    return ret;
+}
+
+/**
+ * @brief FixtureGenerator::RandomStatus
+ * @return A status drawn from the weights of SetStatusWeights().
+ */
+Status FixtureGenerator::RandomStatus()
+{
+    int total = 0;
+    Q_FOREACH (int weight, _statusWeights)
+        total += weight;
+    if (total <= 0)
+        return Status::NotReviewed;
+    int pick = static_cast<int>(_random.bounded(total));
+    for (int i = 0; i < _statusWeights.count(); i++)
+    {
+        if (pick < _statusWeights.at(i))
+            return static_cast<Status>(i);
+        pick -= _statusWeights.at(i);
+    }
+    return Status::NotReviewed;
+}
+
+/**
+ * @brief FixtureGenerator::Words
+ * @param count
+ * @return @a count pseudo-random words of filler text.
+ */
+QString FixtureGenerator::Words(int count)
+{
+    static const QStringList words{
+        QStringLiteral("the"), QStringLiteral("system"), QStringLiteral("must"), QStringLiteral("configure"),
+        QStringLiteral("audit"), QStringLiteral("account"), QStringLiteral("password"), QStringLiteral("policy"),
+        QStringLiteral("access"), QStringLiteral("control"), QStringLiteral("service"), QStringLiteral("enforce"),
+        QStringLiteral("verify"), QStringLiteral("setting"), QStringLiteral("registry"), QStringLiteral("file"),
+        QStringLiteral("permission"), QStringLiteral("administrator"), QStringLiteral("network"), QStringLiteral("encryption")
+    };
+    QStringList ret;
+    for (int i = 0; i < count; i++)
+        ret.append(words.at(static_cast<int>(_random.bounded(words.count()))));
+    return ret.join(' ');
+}
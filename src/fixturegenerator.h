@@ -0,0 +1,55 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FIXTUREGENERATOR_H
+#define FIXTUREGENERATOR_H
+
+#include "asset.h"
+#include "cklcheck.h"
+#include "stig.h"
+#include "stigcheck.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QRandomGenerator>
+#include <QString>
+#include <QVector>
+
+class FixtureGenerator
+{
+public:
+    explicit FixtureGenerator(quint32 seed = 1);
+    int AddCCIs(int count);
+    int AddAssets(int count, int stigsPerAsset);
+    void SetStatusWeights(int notReviewed, int open, int notAFinding, int notApplicable);
+    QByteArray STIGXML(int index, int rules);
+    QString WriteSTIG(const QString &dir, int index, int rules);
+    QString WriteXCCDFResults(const QString &dir, const Asset &asset, const STIG &stig);
+
+private:
+    Status RandomStatus();
+    QString Words(int count);
+    QRandomGenerator _random;
+    int _ccis; //number of CCIs the rules may reference
+    QVector<int> _statusWeights; //indexed by Status
+    QHash<int, int> _cciNumbers; //CCI database id to CCI number
+    QHash<int, QVector<STIGCheck>> _stigChecks; //STIG database id to its checks
+};
+
+#endif // FIXTUREGENERATOR_H
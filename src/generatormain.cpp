@@ -0,0 +1,152 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "dbmanager.h"
+#include "fixturegenerator.h"
+#include "workercklexport.h"
+#include "workerstigadd.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+
+#include <cstdlib>
+#include <iostream>
+
+[[maybe_unused]] bool IgnoreWarnings = true; //see common.h; there is no one to show warnings to
+
+/**
+ * @brief PrintWarning
+ * @param title
+ * @param message
+ *
+ * Report a warning raised by a worker on stderr.
+ */
+static void PrintWarning(const QString &title, const QString &message)
+{
+    std::cerr << title.toStdString() << ": " << message.toStdString() << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("stigqter-generator"));
+    QCoreApplication::setApplicationVersion(VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Write synthetic STIGs, CKLs, XCCDF results, and a populated STIGQter.db for load testing."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument(QStringLiteral("directory"), QStringLiteral("Empty directory to write the generated package to."));
+    QCommandLineOption assets(QStringLiteral("assets"), QStringLiteral("Number of Assets."), QStringLiteral("count"), QStringLiteral("500"));
+    QCommandLineOption stigs(QStringLiteral("stigs"), QStringLiteral("Number of STIGs."), QStringLiteral("count"), QStringLiteral("20"));
+    QCommandLineOption stigsPerAsset(QStringLiteral("stigs-per-asset"), QStringLiteral("STIGs mapped to each Asset."), QStringLiteral("count"), QStringLiteral("12"));
+    QCommandLineOption rules(QStringLiteral("rules"), QStringLiteral("Rules in each STIG."), QStringLiteral("count"), QStringLiteral("200"));
+    QCommandLineOption ccis(QStringLiteral("ccis"), QStringLiteral("Number of CCIs."), QStringLiteral("count"), QStringLiteral("500"));
+    QCommandLineOption statuses(QStringLiteral("statuses"), QStringLiteral("Relative share of each check status."), QStringLiteral("status=weight,…"), QStringLiteral("not_reviewed=10,open=15,notafinding=60,not_applicable=15"));
+    QCommandLineOption seed(QStringLiteral("seed"), QStringLiteral("Seed of the generated content."), QStringLiteral("seed"), QStringLiteral("1"));
+    parser.addOptions({assets, stigs, stigsPerAsset, rules, ccis, statuses, seed});
+    parser.process(a);
+
+    if (parser.positionalArguments().count() != 1)
+        parser.showHelp(EXIT_FAILURE);
+    QDir dir(parser.positionalArguments().first());
+    if (!QDir().mkpath(dir.path()) || !dir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot).isEmpty())
+    {
+        std::cerr << "The directory " << dir.path().toStdString() << " must be writable and empty." << std::endl;
+        return EXIT_FAILURE;
+    }
+    dir.mkpath(QStringLiteral("stigs"));
+    dir.mkpath(QStringLiteral("ckls"));
+    dir.mkpath(QStringLiteral("xccdf"));
+    DbManager::SetDefaultPath(dir.filePath(QStringLiteral("STIGQter.db")));
+    qInstallMessageHandler(MessageHandler);
+
+    QVector<int> weights(4, 0); //indexed by Status
+    Q_FOREACH (const QString &pair, parser.value(statuses).split(','))
+    {
+        if (pair.trimmed().isEmpty())
+            continue;
+        QStringList parts = pair.split('=');
+        bool ok = false;
+        int weight = parts.count() == 2 ? parts.at(1).trimmed().toInt(&ok) : 0;
+        if (!ok || weight < 0)
+        {
+            std::cerr << "Unable to parse the status weight " << pair.toStdString() << std::endl;
+            return EXIT_FAILURE;
+        }
+        weights[GetStatus(parts.at(0).trimmed())] += weight;
+    }
+
+    FixtureGenerator generator(parser.value(seed).toUInt());
+    generator.SetStatusWeights(weights.at(Status::NotReviewed), weights.at(Status::Open), weights.at(Status::NotAFinding), weights.at(Status::NotApplicable));
+
+    std::cerr << "Adding CCIs…" << std::endl;
+    generator.AddCCIs(parser.value(ccis).toInt());
+
+    std::cerr << "Writing STIGs…" << std::endl;
+    QStringList stigFiles;
+    for (int i = 1; i <= parser.value(stigs).toInt(); i++)
+    {
+        QString stigFile = generator.WriteSTIG(dir.filePath(QStringLiteral("stigs")), i, parser.value(rules).toInt());
+        if (stigFile.isEmpty())
+        {
+            std::cerr << "Unable to write STIG " << i << std::endl;
+            return EXIT_FAILURE;
+        }
+        stigFiles.append(stigFile);
+    }
+    {
+        WorkerSTIGAdd w;
+        QObject::connect(&w, &Worker::ThrowWarning, PrintWarning);
+        w.AddSTIGs(stigFiles);
+        w.process();
+    }
+
+    std::cerr << "Adding Assets…" << std::endl;
+    int checks = generator.AddAssets(parser.value(assets).toInt(), parser.value(stigsPerAsset).toInt());
+
+    std::cerr << "Writing CKLs…" << std::endl;
+    {
+        WorkerCKLExport w;
+        QObject::connect(&w, &Worker::ThrowWarning, PrintWarning);
+        w.SetExportDir(dir.filePath(QStringLiteral("ckls")));
+        w.process();
+    }
+
+    std::cerr << "Writing XCCDF results…" << std::endl;
+    int results = 0;
+    DbManager db;
+    Q_FOREACH (const Asset &asset, db.GetAssets())
+    {
+        Q_FOREACH (const STIG &s, asset.GetSTIGs())
+        {
+            if (generator.WriteXCCDFResults(dir.filePath(QStringLiteral("xccdf")), asset, s).isEmpty())
+                std::cerr << "Unable to write the XCCDF results of " << PrintSTIG(s).toStdString() << " for " << PrintAsset(asset).toStdString() << std::endl;
+            else
+                results++;
+        }
+    }
+
+    int ckls = QDir(dir.filePath(QStringLiteral("ckls"))).entryList({QStringLiteral("*.ckl")}, QDir::Files).count();
+    std::cerr << "Wrote " << stigFiles.count() << " STIGs, " << ckls << " checklists, " << results << " XCCDF results, and " << checks << " checks to " << dir.path().toStdString() << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,363 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "jobscheduler.h"
+#include "tracerecorder.h"
+
+#include <algorithm>
+
+/**
+ * @class JobScheduler
+ * @brief Runs @a Workers on a bounded pool of threads.
+ *
+ * Each job has a class that describes what it needs from the
+ * database. A @a DatabaseWriter runs alone; @a ReadOnly jobs run
+ * alongside each other; @a CPUOnly jobs run whenever a thread is
+ * free. Jobs that use the database start in the order that they were
+ * submitted, so a waiting writer is not starved by later readers.
+ *
+ * The pool's threads are kept for the life of the scheduler, which
+ * also keeps their database connections open between jobs.
+ *
+ * Jobs may be cancelled or paused. A waiting job is discarded when it
+ * is cancelled; a running job stops at its worker's next check.
+ *
+ * Each @a Worker's signals are relayed with the job's id so that
+ * several jobs can report their progress at once. Progress and
+ * status are coalesced by a @a ProgressReporter and published 20
+ * times per second. Warnings are collected by a @a WarningSink and
+ * reported once, when the job finishes, along with the job's
+ * @a MemoryUsage. The process's memory is sampled four times per
+ * second while jobs run.
+ */
+
+/**
+ * @brief JobScheduler::JobScheduler
+ * @param maxThreads
+ * @param parent
+ *
+ * Main constructor. At most @a maxThreads jobs run at once. When
+ * @a maxThreads is less than 1, the number of processor cores is used
+ * (but no fewer than two threads).
+ */
+JobScheduler::JobScheduler(int maxThreads, QObject *parent) : QObject(parent),
+    _maxThreads(maxThreads > 0 ? maxThreads : std::max(2, QThread::idealThreadCount())),
+    _nextId(1)
+{
+    _memoryTimer.setInterval(250);
+    connect(&_memoryTimer, &QTimer::timeout, this, &JobScheduler::SampleMemory);
+}
+
+/**
+ * @brief JobScheduler::~JobScheduler
+ *
+ * Jobs that have not started are discarded. The running jobs are
+ * cancelled, and the destructor waits on them to stop.
+ */
+JobScheduler::~JobScheduler()
+{
+    Q_FOREACH (const Job &job, _queue)
+    {
+        delete job.worker;
+        delete job.warnings;
+        delete job.memory;
+    }
+    _queue.clear();
+    Q_FOREACH (const Job &job, _running)
+        job.worker->Cancel();
+    Q_FOREACH (QThread *thread, _threads)
+    {
+        thread->quit();
+        thread->wait();
+    }
+    //the threads have stopped, so their workers can be deleted here
+    Q_FOREACH (const Job &job, _running)
+    {
+        delete job.worker;
+        job.warnings->Close();
+        delete job.warnings;
+        delete job.memory;
+    }
+    _running.clear();
+    qDeleteAll(_threads);
+    _threads.clear();
+    _idle.clear();
+}
+
+/**
+ * @brief JobScheduler::Cancel
+ * @param id
+ *
+ * Stop job @a id. A job that has not started is discarded right
+ * away; a running job finishes once its worker stops.
+ */
+void JobScheduler::Cancel(int id)
+{
+    for (int i = 0; i < _queue.count(); i++)
+    {
+        if (_queue.at(i).id == id)
+        {
+            Job job = _queue.takeAt(i);
+            delete job.worker;
+            delete job.reporter;
+            delete job.warnings;
+            delete job.memory;
+            Q_EMIT JobFinished(id);
+            StartNext();
+            if (!IsBusy())
+                Q_EMIT Idle();
+            return;
+        }
+    }
+    Q_FOREACH (const Job &job, _running)
+    {
+        if (job.id == id)
+            job.worker->Cancel();
+    }
+}
+
+/**
+ * @brief JobScheduler::IsBusy
+ * @return @c True when a job is waiting or running.
+ */
+bool JobScheduler::IsBusy() const
+{
+    return !_queue.isEmpty() || !_running.isEmpty();
+}
+
+/**
+ * @brief JobScheduler::IsWriting
+ * @return @c True when a @a DatabaseWriter is waiting or running.
+ */
+bool JobScheduler::IsWriting() const
+{
+    auto isWriter = [](const Job &job) { return job.jobClass == DatabaseWriter; };
+    return std::any_of(_queue.constBegin(), _queue.constEnd(), isWriter) || std::any_of(_running.constBegin(), _running.constEnd(), isWriter);
+}
+
+/**
+ * @brief JobScheduler::MaxThreads
+ * @return The number of jobs that may run at once.
+ */
+int JobScheduler::MaxThreads() const
+{
+    return _maxThreads;
+}
+
+/**
+ * @brief JobScheduler::SetPaused
+ * @param id
+ * @param paused
+ *
+ * Pause or resume job @a id. A paused job still holds its thread.
+ */
+void JobScheduler::SetPaused(int id, bool paused)
+{
+    Q_FOREACH (const Job &job, _queue + _running)
+    {
+        if (job.id == id)
+            job.worker->SetPaused(paused);
+    }
+}
+
+/**
+ * @brief JobScheduler::Submit
+ * @param worker
+ * @param jobClass
+ * @return The id of the new job.
+ *
+ * Queue the @a worker to run on the pool. The scheduler takes
+ * ownership of the @a worker and deletes it once it finishes. Queued
+ * jobs are started once control returns to the event loop, so the
+ * caller can connect to JobStarted() with the returned id.
+ *
+ * Warnings raised by the @a worker, whether emitted or passed to
+ * Warning() on its thread, are collected in the job's @a WarningSink.
+ */
+int JobScheduler::Submit(Worker *worker, JobClass jobClass)
+{
+    int id = _nextId++;
+    auto *reporter = new ProgressReporter(20, this);
+    reporter->Attach(worker);
+    connect(reporter, &ProgressReporter::initialize, this, [this, id](int max, int val) { Q_EMIT JobInitialize(id, max, val); });
+    connect(reporter, &ProgressReporter::progress, this, [this, id](int val) { Q_EMIT JobProgress(id, val); });
+    connect(reporter, &ProgressReporter::updateStatus, this, [this, id](const QString &status) { Q_EMIT JobStatus(id, status); });
+    auto *warnings = new WarningSink(QString::fromUtf8(worker->metaObject()->className()));
+    connect(worker, &Worker::ThrowWarning, worker, [warnings](const QString &title, const QString &message) { warnings->Add(title, message); }, Qt::DirectConnection);
+    _queue.append({id, worker, jobClass, nullptr, reporter, warnings, new MemoryUsage()});
+    QMetaObject::invokeMethod(this, [this]() { StartNext(); }, Qt::QueuedConnection);
+    return id;
+}
+
+/**
+ * @brief JobScheduler::CanStart
+ * @param jobClass
+ * @param writerWaiting
+ * @return @c True when a job of @a jobClass may start now.
+ *
+ * When @a writerWaiting, an earlier @a DatabaseWriter has not started
+ * yet, so later jobs that use the database wait behind it.
+ */
+bool JobScheduler::CanStart(JobClass jobClass, bool writerWaiting) const
+{
+    switch (jobClass)
+    {
+    case DatabaseWriter:
+        return !writerWaiting && std::none_of(_running.constBegin(), _running.constEnd(), [](const Job &job) { return job.jobClass != CPUOnly; });
+    case ReadOnly:
+        return !writerWaiting && std::none_of(_running.constBegin(), _running.constEnd(), [](const Job &job) { return job.jobClass == DatabaseWriter; });
+    default:
+        return true;
+    }
+}
+
+/**
+ * @brief JobScheduler::Finished
+ * @param id
+ *
+ * Report the finished job's warnings, return its thread to the pool,
+ * and start the jobs that were waiting on it.
+ *
+ * This is queued by the job's thread after the worker's process()
+ * returns and the thread no longer refers to the job's
+ * @a WarningSink or @a MemoryUsage, so both can be deleted here.
+ */
+void JobScheduler::Finished(int id)
+{
+    WarningSink *warnings = nullptr;
+    MemoryUsage *memory = nullptr;
+    for (int i = 0; i < _running.count(); i++)
+    {
+        if (_running.at(i).id == id)
+        {
+            Job job = _running.takeAt(i);
+            //the final progress is published before the job is reported as finished
+            disconnect(job.worker, nullptr, job.reporter, nullptr);
+            job.reporter->Stop();
+            job.reporter->deleteLater();
+            //deleted by its thread, which is idle now
+            job.worker->deleteLater();
+            _idle.append(job.thread);
+            warnings = job.warnings;
+            memory = job.memory;
+            break;
+        }
+    }
+    if (warnings)
+    {
+        warnings->Close();
+        if (warnings->Count() > 0)
+            Q_EMIT JobWarnings(id, warnings);
+        delete warnings;
+    }
+    if (memory)
+    {
+        memory->Sample(MemoryMonitor::Resident());
+        Q_EMIT JobMemory(id, memory);
+        delete memory;
+    }
+    if (_running.isEmpty())
+        _memoryTimer.stop();
+    Q_EMIT JobFinished(id);
+    StartNext();
+    if (!IsBusy())
+        Q_EMIT Idle();
+}
+
+/**
+ * @brief JobScheduler::SampleMemory
+ *
+ * Record the process's resident memory against every running job.
+ */
+void JobScheduler::SampleMemory()
+{
+    qint64 resident = MemoryMonitor::Resident();
+    Q_FOREACH (const Job &job, _running)
+        job.memory->Sample(resident);
+}
+
+/**
+ * @brief JobScheduler::Start
+ * @param job
+ *
+ * Run the @a job on an idle thread, starting a new one if the pool
+ * is not full.
+ */
+void JobScheduler::Start(Job job)
+{
+    if (!_idle.isEmpty())
+    {
+        job.thread = _idle.takeLast();
+    }
+    else
+    {
+        job.thread = new QThread();
+        job.thread->setObjectName(QStringLiteral("JobScheduler-") + QString::number(_threads.count() + 1));
+        _threads.append(job.thread);
+        job.thread->start();
+    }
+    job.worker->moveToThread(job.thread);
+    _running.append(job);
+    job.reporter->Start();
+    job.memory->Sample(MemoryMonitor::Resident());
+    _memoryTimer.start();
+    Q_EMIT JobStarted(job.id);
+    //Warning() and tracked memory on the job's thread count toward the job
+    Worker *worker = job.worker;
+    WarningSink *warnings = job.warnings;
+    MemoryUsage *memory = job.memory;
+    int id = job.id;
+    QMetaObject::invokeMethod(worker, [this, id, worker, warnings, memory]() {
+        {
+            TraceSpan span(QString::fromLatin1(worker->metaObject()->className()), "job");
+            WarningSink::SetCurrent(warnings);
+            MemoryUsage::SetCurrent(memory);
+            worker->process();
+            MemoryUsage::SetCurrent(nullptr);
+            WarningSink::SetCurrent(nullptr);
+        }
+        //the job is finished once process() has returned, not when the worker emits finished()
+        QMetaObject::invokeMethod(this, [this, id]() { Finished(id); }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
+}
+
+/**
+ * @brief JobScheduler::StartNext
+ *
+ * Start every waiting job that may run now, in the order that they
+ * were submitted.
+ */
+void JobScheduler::StartNext()
+{
+    bool writerWaiting = false;
+    for (int i = 0; i < _queue.count() && _running.count() < _maxThreads;)
+    {
+        JobClass jobClass = _queue.at(i).jobClass;
+        if (CanStart(jobClass, writerWaiting))
+        {
+            Start(_queue.takeAt(i));
+        }
+        else
+        {
+            if (jobClass == DatabaseWriter)
+                writerWaiting = true;
+            i++;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef JOBSCHEDULER_H
+#define JOBSCHEDULER_H
+
+#include "memorymonitor.h"
+#include "progressreporter.h"
+#include "warningsink.h"
+#include "worker.h"
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QThread>
+#include <QTimer>
+#include <QVector>
+
+class JobScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum JobClass
+    {
+        DatabaseWriter, /**< changes the database; runs alone */
+        ReadOnly, /**< reads the database alongside other readers */
+        CPUOnly /**< does not use the database */
+    };
+
+    JobScheduler(const JobScheduler &scheduler) = delete;
+    explicit JobScheduler(int maxThreads = 0, QObject *parent = nullptr);
+    ~JobScheduler() override;
+    void Cancel(int id);
+    bool IsBusy() const;
+    bool IsWriting() const;
+    int MaxThreads() const;
+    void SetPaused(int id, bool paused);
+    int Submit(Worker *worker, JobClass jobClass);
+
+Q_SIGNALS:
+    void Idle();
+    void JobFinished(int id);
+    void JobInitialize(int id, int max, int val);
+    void JobMemory(int id, const MemoryUsage *memory);
+    void JobProgress(int id, int val);
+    void JobStarted(int id);
+    void JobStatus(int id, const QString &status);
+    void JobWarnings(int id, const WarningSink *warnings);
+
+private:
+    struct Job
+    {
+        int id;
+        Worker *worker;
+        JobClass jobClass;
+        QThread *thread;
+        ProgressReporter *reporter;
+        WarningSink *warnings;
+        MemoryUsage *memory;
+    };
+    bool CanStart(JobClass jobClass, bool writerWaiting) const;
+    void Finished(int id);
+    void SampleMemory();
+    void Start(Job job);
+    void StartNext();
+    int _maxThreads;
+    int _nextId;
+    QList<Job> _queue;
+    QList<Job> _running;
+    QVector<QThread*> _threads;
+    QVector<QThread*> _idle;
+    QTimer _memoryTimer;
+};
+
+#endif // JOBSCHEDULER_H
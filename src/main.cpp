@@ -20,6 +20,7 @@
 #include "assetview.h"
 #include "common.h"
 #include "dbmanager.h"
+#include "querystats.h"
 #include "stigqter.h"
 #include "workercklimport.h"
 #include "workerstigdelete.h"
@@ -181,6 +182,8 @@ int main(int argc, char *argv[])
         //std::cout << "Test " << ++onTest << ": Close Application" << std::endl;
         //w.close();
 
+        std::cout << "Query Statistics" << std::endl << QueryStats::ToText().toStdString();
+
         std::cout << "Tests complete!" << std::endl;
         exit(EXIT_SUCCESS);
     }
@@ -0,0 +1,325 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "memorymonitor.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+#if defined(Q_OS_WIN)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#elif defined(Q_OS_UNIX)
+#include <unistd.h>
+#endif
+
+/**
+ * @class MemoryMonitor
+ * @brief Samples the process's resident memory and compares it to a
+ * memory budget.
+ *
+ * Workers that can process their data in pieces ask for a ChunkSize()
+ * that fits in what is left of the budget, and back off when the
+ * process is OverBudget(). Large buffers are counted with Track() so
+ * that each job's share of the memory can be reported.
+ *
+ * A budget of 0 is unlimited.
+ */
+
+namespace {
+
+std::atomic<qint64> budget(0);
+std::atomic<qint64> peakResident(0);
+std::atomic<qint64> tracked(0);
+thread_local MemoryUsage *currentUsage = nullptr;
+
+void UpdatePeak(std::atomic<qint64> &peak, qint64 value)
+{
+    qint64 old = peak.load(std::memory_order_relaxed);
+    while ((value > old) && !peak.compare_exchange_weak(old, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+QString MiB(qint64 bytes)
+{
+    return QString::number(bytes / (1024 * 1024)) + QStringLiteral(" MiB");
+}
+
+}
+
+/**
+ * @class MemoryUsage
+ * @brief The memory used by one background job.
+ *
+ * While a job runs, its usage is the thread's current usage, and
+ * MemoryMonitor::Track() counts toward it.
+ */
+
+/**
+ * @brief MemoryUsage::MemoryUsage
+ *
+ * Default constructor.
+ */
+MemoryUsage::MemoryUsage() :
+    _tracked(0),
+    _peakTracked(0),
+    _peakResident(0)
+{
+}
+
+/**
+ * @brief MemoryUsage::PeakResident
+ * @return The most resident memory the process used while the job
+ * ran, in bytes.
+ */
+qint64 MemoryUsage::PeakResident() const
+{
+    return _peakResident;
+}
+
+/**
+ * @brief MemoryUsage::PeakTracked
+ * @return The most memory the job's tracked buffers held at once, in
+ * bytes.
+ */
+qint64 MemoryUsage::PeakTracked() const
+{
+    return _peakTracked;
+}
+
+/**
+ * @brief MemoryUsage::Sample
+ * @param resident
+ *
+ * The process used @a resident bytes while the job ran.
+ */
+void MemoryUsage::Sample(qint64 resident)
+{
+    UpdatePeak(_peakResident, resident);
+}
+
+/**
+ * @brief MemoryUsage::Track
+ * @param bytes
+ *
+ * The job allocated (or, when negative, released) @a bytes.
+ */
+void MemoryUsage::Track(qint64 bytes)
+{
+    UpdatePeak(_peakTracked, _tracked += bytes);
+}
+
+/**
+ * @brief MemoryUsage::Tracked
+ * @return The bytes the job's tracked buffers hold now.
+ */
+qint64 MemoryUsage::Tracked() const
+{
+    return _tracked;
+}
+
+/**
+ * @brief MemoryUsage::Current
+ * @return The usage of the job running on this thread, or
+ * @c nullptr.
+ */
+MemoryUsage* MemoryUsage::Current()
+{
+    return currentUsage;
+}
+
+/**
+ * @brief MemoryUsage::SetCurrent
+ * @param usage
+ *
+ * Count the memory tracked on this thread toward @a usage, or toward
+ * no job when @a usage is @c nullptr.
+ */
+void MemoryUsage::SetCurrent(MemoryUsage *usage)
+{
+    currentUsage = usage;
+}
+
+/**
+ * @brief MemoryMonitor::Available
+ * @return The bytes left in the budget, which may be negative.
+ */
+qint64 MemoryMonitor::Available()
+{
+    qint64 limit = budget;
+    if (limit <= 0)
+        return std::numeric_limits<qint64>::max();
+    return limit - Resident();
+}
+
+/**
+ * @brief MemoryMonitor::Budget
+ * @return The memory budget in bytes, or 0 when there is none.
+ */
+qint64 MemoryMonitor::Budget()
+{
+    return budget;
+}
+
+/**
+ * @brief MemoryMonitor::ChunkSize
+ * @param itemBytes
+ * @param preferred
+ * @param minimum
+ * @return The number of items of about @a itemBytes each to hold in
+ * memory at once.
+ *
+ * A chunk may use a quarter of what is left of the budget, but never
+ * more than @a preferred or fewer than @a minimum items.
+ */
+int MemoryMonitor::ChunkSize(qint64 itemBytes, int preferred, int minimum)
+{
+    qint64 available = Available();
+    if (available == std::numeric_limits<qint64>::max())
+        return preferred;
+    qint64 items = std::max(available, static_cast<qint64>(0)) / 4 / std::max(itemBytes, static_cast<qint64>(1));
+    return static_cast<int>(std::max(static_cast<qint64>(minimum), std::min(items, static_cast<qint64>(preferred))));
+}
+
+/**
+ * @brief MemoryMonitor::Fits
+ * @param bytes
+ * @return @c True when @a bytes more fit in the budget.
+ */
+bool MemoryMonitor::Fits(qint64 bytes)
+{
+    return bytes <= Available();
+}
+
+/**
+ * @brief MemoryMonitor::OverBudget
+ * @return @c True when the process uses more than the budget.
+ */
+bool MemoryMonitor::OverBudget()
+{
+    return Available() < 0;
+}
+
+/**
+ * @brief MemoryMonitor::PeakResident
+ * @return The most resident memory sampled, in bytes.
+ */
+qint64 MemoryMonitor::PeakResident()
+{
+    return std::max(peakResident.load(), Resident());
+}
+
+/**
+ * @brief MemoryMonitor::Resident
+ * @return The resident memory (working set) of the process in bytes,
+ * or 0 when it cannot be read on this platform.
+ */
+qint64 MemoryMonitor::Resident()
+{
+    qint64 ret = 0;
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        ret = static_cast<qint64>(counters.WorkingSetSize);
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS)
+        ret = static_cast<qint64>(info.resident_size);
+#elif defined(Q_OS_UNIX)
+    //the second field of statm is the resident set, in pages
+    FILE *statm = fopen("/proc/self/statm", "r");
+    if (statm)
+    {
+        long long size = 0;
+        long long resident = 0;
+        if (fscanf(statm, "%lld %lld", &size, &resident) == 2)
+            ret = static_cast<qint64>(resident) * sysconf(_SC_PAGESIZE);
+        fclose(statm);
+    }
+#endif
+    UpdatePeak(peakResident, ret);
+    return ret;
+}
+
+/**
+ * @brief MemoryMonitor::SetBudget
+ * @param bytes
+ *
+ * Keep the process within @a bytes, or within no limit when @a bytes
+ * is 0.
+ */
+void MemoryMonitor::SetBudget(qint64 bytes)
+{
+    budget = std::max(bytes, static_cast<qint64>(0));
+}
+
+/**
+ * @brief MemoryMonitor::Track
+ * @param bytes
+ *
+ * A worker allocated (or, when negative, released) a buffer of
+ * @a bytes. It counts toward the job running on this thread.
+ */
+void MemoryMonitor::Track(qint64 bytes)
+{
+    tracked += bytes;
+    if (currentUsage)
+        currentUsage->Track(bytes);
+}
+
+/**
+ * @brief MemoryMonitor::Tracked
+ * @return The bytes held by the tracked buffers of every job.
+ */
+qint64 MemoryMonitor::Tracked()
+{
+    return tracked;
+}
+
+/**
+ * @brief MemoryMonitor::ToJson
+ * @return The memory use and budget, in bytes.
+ */
+QJsonObject MemoryMonitor::ToJson()
+{
+    return {{QStringLiteral("resident"), Resident()},
+            {QStringLiteral("peakResident"), PeakResident()},
+            {QStringLiteral("tracked"), Tracked()},
+            {QStringLiteral("budget"), Budget()}};
+}
+
+/**
+ * @brief MemoryMonitor::ToText
+ * @return The memory use and budget for the status bar.
+ */
+QString MemoryMonitor::ToText()
+{
+    QString ret = QStringLiteral("Memory: ") + MiB(Resident()) + QStringLiteral(" (peak ") + MiB(PeakResident()) + QStringLiteral(")");
+    if (Budget() > 0)
+        ret.append(QStringLiteral(" of ") + MiB(Budget()));
+    return ret;
+}
@@ -0,0 +1,65 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MEMORYMONITOR_H
+#define MEMORYMONITOR_H
+
+#include <QJsonObject>
+#include <QString>
+
+#include <atomic>
+
+class MemoryUsage
+{
+public:
+    MemoryUsage(const MemoryUsage &usage) = delete;
+    MemoryUsage();
+    qint64 PeakResident() const;
+    qint64 PeakTracked() const;
+    void Sample(qint64 resident);
+    void Track(qint64 bytes);
+    qint64 Tracked() const;
+
+    static MemoryUsage* Current();
+    static void SetCurrent(MemoryUsage *usage);
+
+private:
+    std::atomic<qint64> _tracked;
+    std::atomic<qint64> _peakTracked;
+    std::atomic<qint64> _peakResident;
+};
+
+class MemoryMonitor
+{
+public:
+    static qint64 Available();
+    static qint64 Budget();
+    static int ChunkSize(qint64 itemBytes, int preferred, int minimum = 1);
+    static bool Fits(qint64 bytes);
+    static bool OverBudget();
+    static qint64 PeakResident();
+    static qint64 Resident();
+    static void SetBudget(qint64 bytes);
+    static void Track(qint64 bytes);
+    static qint64 Tracked();
+    static QJsonObject ToJson();
+    static QString ToText();
+};
+
+#endif // MEMORYMONITOR_H
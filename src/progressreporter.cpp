@@ -0,0 +1,164 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "progressreporter.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+
+/**
+ * @class ProgressReporter
+ * @brief Coalesces a @a Worker's progress and status into a fixed
+ * number of updates per second.
+ *
+ * Workers report progress once per item, and a queued signal for
+ * each item floods the receiving thread's event loop. The reporter is
+ * connected directly to the @a Worker's signals, so reporting only
+ * updates a counter on the @a Worker's thread. A timer on the
+ * reporter's own thread publishes the latest state when it changes.
+ */
+
+/**
+ * @brief ProgressReporter::ProgressReporter
+ * @param hz
+ * @param parent
+ *
+ * Main constructor. The state is published at most @a hz times per
+ * second.
+ */
+ProgressReporter::ProgressReporter(int hz, QObject *parent) : QObject(parent),
+    _max(0),
+    _value(0),
+    _generation(0),
+    _statusChanged(false),
+    _publishedGeneration(0),
+    _publishedValue(0)
+{
+    _timer.setInterval(1000 / std::max(hz, 1));
+    connect(&_timer, &QTimer::timeout, this, &ProgressReporter::Flush);
+}
+
+/**
+ * @brief ProgressReporter::Attach
+ * @param worker
+ *
+ * Collect the @a worker's progress and status. The connections are
+ * direct, so no events are queued while the @a worker runs.
+ */
+void ProgressReporter::Attach(Worker *worker)
+{
+    connect(worker, &Worker::initialize, this, &ProgressReporter::Initialize, Qt::DirectConnection);
+    connect(worker, &Worker::progress, this, &ProgressReporter::Progress, Qt::DirectConnection);
+    connect(worker, &Worker::updateStatus, this, &ProgressReporter::Status, Qt::DirectConnection);
+}
+
+/**
+ * @brief ProgressReporter::Flush
+ *
+ * Publish the state that changed since the last update.
+ */
+void ProgressReporter::Flush()
+{
+    unsigned int generation = _generation;
+    int val = _value;
+    if (generation != _publishedGeneration)
+    {
+        _publishedGeneration = generation;
+        Q_EMIT initialize(_max, val);
+    }
+    else if (val != _publishedValue)
+    {
+        Q_EMIT progress(val);
+    }
+    _publishedValue = val;
+
+    QString status;
+    {
+        QMutexLocker lock(&_mutex);
+        if (!_statusChanged)
+            return;
+        status = _status;
+        _statusChanged = false;
+    }
+    Q_EMIT updateStatus(status);
+}
+
+/**
+ * @brief ProgressReporter::Start
+ *
+ * Start publishing updates.
+ */
+void ProgressReporter::Start()
+{
+    _timer.start();
+}
+
+/**
+ * @brief ProgressReporter::Stop
+ *
+ * Stop publishing updates after publishing the final state.
+ */
+void ProgressReporter::Stop()
+{
+    _timer.stop();
+    Flush();
+}
+
+/**
+ * @brief ProgressReporter::Initialize
+ * @param max
+ * @param val
+ *
+ * The work now has @a max steps and is at step @a val.
+ */
+void ProgressReporter::Initialize(int max, int val)
+{
+    _max = max;
+    _value = val;
+    _generation++;
+}
+
+/**
+ * @brief ProgressReporter::Progress
+ * @param val
+ *
+ * The work is at step @a val. A negative @a val advances the work by
+ * one step.
+ */
+void ProgressReporter::Progress(int val)
+{
+    if (val < 0)
+        _value++;
+    else
+        _value = val;
+}
+
+/**
+ * @brief ProgressReporter::Status
+ * @param status
+ *
+ * Only the latest @a status is published.
+ */
+void ProgressReporter::Status(const QString &status)
+{
+    QMutexLocker lock(&_mutex);
+    _status = status;
+    _statusChanged = true;
+}
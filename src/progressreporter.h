@@ -0,0 +1,66 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROGRESSREPORTER_H
+#define PROGRESSREPORTER_H
+
+#include "worker.h"
+
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <atomic>
+
+class ProgressReporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    ProgressReporter(const ProgressReporter &reporter) = delete;
+    explicit ProgressReporter(int hz = 20, QObject *parent = nullptr);
+    void Attach(Worker *worker);
+    void Flush();
+    void Start();
+    void Stop();
+
+    //called on the worker's thread
+    void Initialize(int max, int val);
+    void Progress(int val);
+    void Status(const QString &status);
+
+Q_SIGNALS:
+    void initialize(int max, int val);
+    void progress(int val);
+    void updateStatus(const QString &status);
+
+private:
+    std::atomic<int> _max;
+    std::atomic<int> _value;
+    std::atomic<unsigned int> _generation;
+    QMutex _mutex;
+    QString _status;
+    bool _statusChanged;
+    unsigned int _publishedGeneration;
+    int _publishedValue;
+    QTimer _timer;
+};
+
+#endif // PROGRESSREPORTER_H
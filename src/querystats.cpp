@@ -0,0 +1,272 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "querystats.h"
+
+#include <QHash>
+#include <QJsonArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+/**
+ * @class QueryStats
+ * @brief Latency of the queries DbManager executes, grouped by the
+ * DbManager function that executed them.
+ *
+ * Every thread records into the same statistics. Percentiles are
+ * computed from a fixed-size random sample of each call site's
+ * latencies so that memory does not grow with the number of queries.
+ * Queries slower than SlowThreshold() are kept, with their query
+ * plan, in a short list of the most recent ones.
+ */
+
+namespace {
+
+constexpr int maxSamples = 4096; //latencies kept per call site
+constexpr int maxSlowQueries = 100;
+
+struct Samples
+{
+    quint64 count = 0;
+    qint64 rows = 0;
+    qint64 totalNs = 0;
+    qint64 maxNs = 0;
+    QVector<qint64> sample; //reservoir of latencies, in nanoseconds
+};
+
+QMutex mutex;
+QHash<QString, Samples> samples;
+QVector<SlowQuery> slowQueries;
+std::atomic<quint64> queryCount(0);
+std::atomic<int> slowThreshold(250);
+
+double Percentile(const QVector<qint64> &sorted, double p)
+{
+    if (sorted.isEmpty())
+        return 0;
+    int index = std::max(0, static_cast<int>(std::ceil(p * sorted.count())) - 1);
+    return static_cast<double>(sorted.at(std::min(index, sorted.count() - 1))) / 1000000.0;
+}
+
+}
+
+/**
+ * @brief QueryStats::Record
+ * @param location
+ * @param nsecs
+ * @param rows
+ *
+ * Record that the query executed at @a location took @a nsecs and
+ * changed @a rows. A negative @a rows (such as for a SELECT) is not
+ * counted.
+ */
+void QueryStats::Record(const QString &location, qint64 nsecs, qint64 rows)
+{
+    queryCount++;
+    QMutexLocker lock(&mutex);
+    Samples &s = samples[location];
+    s.count++;
+    s.rows += std::max(rows, static_cast<qint64>(0));
+    s.totalNs += nsecs;
+    s.maxNs = std::max(s.maxNs, nsecs);
+    if (s.sample.count() < maxSamples)
+    {
+        s.sample.append(nsecs);
+    }
+    else
+    {
+        //keep each latency with equal probability
+        quint64 replace = QRandomGenerator::global()->generate64() % s.count;
+        if (replace < maxSamples)
+            s.sample[static_cast<int>(replace)] = nsecs;
+    }
+}
+
+/**
+ * @brief QueryStats::RecordSlow
+ * @param slowQuery
+ *
+ * Keep the @a slowQuery, dropping the oldest one when the list is
+ * full.
+ */
+void QueryStats::RecordSlow(const SlowQuery &slowQuery)
+{
+    QMutexLocker lock(&mutex);
+    if (slowQueries.count() >= maxSlowQueries)
+        slowQueries.removeFirst();
+    slowQueries.append(slowQuery);
+}
+
+/**
+ * @brief QueryStats::Count
+ * @return The number of queries recorded by every thread since the
+ * application started.
+ */
+quint64 QueryStats::Count()
+{
+    return queryCount;
+}
+
+/**
+ * @brief QueryStats::Stats
+ * @return The statistics of each call site, slowest in total first.
+ */
+QVector<QueryStat> QueryStats::Stats()
+{
+    QVector<QueryStat> ret;
+    QMutexLocker lock(&mutex);
+    for (auto it = samples.constBegin(); it != samples.constEnd(); ++it)
+    {
+        QVector<qint64> sorted = it.value().sample;
+        std::sort(sorted.begin(), sorted.end());
+        ret.append({it.key(),
+                    it.value().count,
+                    it.value().rows,
+                    static_cast<double>(it.value().totalNs) / 1000000.0,
+                    Percentile(sorted, 0.50),
+                    Percentile(sorted, 0.95),
+                    Percentile(sorted, 0.99),
+                    static_cast<double>(it.value().maxNs) / 1000000.0});
+    }
+    lock.unlock();
+    std::sort(ret.begin(), ret.end(), [](const QueryStat &left, const QueryStat &right) {
+        return left.totalMs > right.totalMs;
+    });
+    return ret;
+}
+
+/**
+ * @brief QueryStats::SlowQueries
+ * @return The most recent queries that took longer than
+ * SlowThreshold(), oldest first.
+ */
+QVector<SlowQuery> QueryStats::SlowQueries()
+{
+    QMutexLocker lock(&mutex);
+    return slowQueries;
+}
+
+/**
+ * @brief QueryStats::SlowThreshold
+ * @return The number of milliseconds after which a query is logged
+ * as slow, or 0 when slow queries are not logged.
+ */
+int QueryStats::SlowThreshold()
+{
+    return slowThreshold;
+}
+
+/**
+ * @brief QueryStats::SetSlowThreshold
+ * @param ms
+ *
+ * Log queries that take at least @a ms milliseconds. A value of 0
+ * turns the slow-query log off.
+ */
+void QueryStats::SetSlowThreshold(int ms)
+{
+    slowThreshold = std::max(ms, 0);
+}
+
+/**
+ * @brief QueryStats::Reset
+ *
+ * Forget every recorded query. The total of Count() is kept.
+ */
+void QueryStats::Reset()
+{
+    QMutexLocker lock(&mutex);
+    samples.clear();
+    slowQueries.clear();
+}
+
+/**
+ * @brief QueryStats::ToJson
+ * @return The statistics of each call site and the slow queries.
+ */
+QJsonObject QueryStats::ToJson()
+{
+    QJsonArray stats;
+    Q_FOREACH (const QueryStat &s, Stats())
+    {
+        stats.append(QJsonObject{{QStringLiteral("location"), s.location},
+                                 {QStringLiteral("count"), static_cast<qint64>(s.count)},
+                                 {QStringLiteral("rows"), s.rows},
+                                 {QStringLiteral("totalMs"), s.totalMs},
+                                 {QStringLiteral("p50Ms"), s.p50Ms},
+                                 {QStringLiteral("p95Ms"), s.p95Ms},
+                                 {QStringLiteral("p99Ms"), s.p99Ms},
+                                 {QStringLiteral("maxMs"), s.maxMs}});
+    }
+    QJsonArray slow;
+    Q_FOREACH (const SlowQuery &s, SlowQueries())
+    {
+        slow.append(QJsonObject{{QStringLiteral("when"), s.when.toString(Qt::ISODate)},
+                                {QStringLiteral("location"), s.location},
+                                {QStringLiteral("ms"), s.ms},
+                                {QStringLiteral("query"), s.query},
+                                {QStringLiteral("plan"), s.plan}});
+    }
+    return QJsonObject{{QStringLiteral("queries"), static_cast<qint64>(Count())},
+                       {QStringLiteral("slowThresholdMs"), SlowThreshold()},
+                       {QStringLiteral("locations"), stats},
+                       {QStringLiteral("slowQueries"), slow}};
+}
+
+/**
+ * @brief QueryStats::ToText
+ * @return A plain-text table of the statistics of each call site
+ * followed by the slow queries.
+ */
+QString QueryStats::ToText()
+{
+    QString ret = QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8\n")
+            .arg(QStringLiteral("Location"), -36)
+            .arg(QStringLiteral("Count"), 9)
+            .arg(QStringLiteral("Rows"), 10)
+            .arg(QStringLiteral("Total ms"), 11)
+            .arg(QStringLiteral("p50 ms"), 9)
+            .arg(QStringLiteral("p95 ms"), 9)
+            .arg(QStringLiteral("p99 ms"), 9)
+            .arg(QStringLiteral("Max ms"), 9);
+    Q_FOREACH (const QueryStat &s, Stats())
+    {
+        ret.append(QStringLiteral("%1 %2 %3 %4 %5 %6 %7 %8\n")
+                   .arg(s.location, -36)
+                   .arg(s.count, 9)
+                   .arg(s.rows, 10)
+                   .arg(s.totalMs, 11, 'f', 1)
+                   .arg(s.p50Ms, 9, 'f', 3)
+                   .arg(s.p95Ms, 9, 'f', 3)
+                   .arg(s.p99Ms, 9, 'f', 3)
+                   .arg(s.maxMs, 9, 'f', 3));
+    }
+    Q_FOREACH (const SlowQuery &s, SlowQueries())
+    {
+        ret.append(QStringLiteral("\n") + s.when.toString(Qt::ISODate) + QStringLiteral(" ") + s.location + QStringLiteral(" took ") + QString::number(s.ms, 'f', 1) + QStringLiteral(" ms\n") + s.query + QStringLiteral("\n") + s.plan);
+        if (!s.plan.endsWith('\n'))
+            ret.append('\n');
+    }
+    return ret;
+}
@@ -0,0 +1,64 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef QUERYSTATS_H
+#define QUERYSTATS_H
+
+#include <QDateTime>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+struct QueryStat
+{
+    QString location; /**< DbManager call site */
+    quint64 count; /**< number of executed queries */
+    qint64 rows; /**< rows changed; SELECT results are not counted */
+    double totalMs;
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    double maxMs;
+};
+
+struct SlowQuery
+{
+    QDateTime when;
+    QString location; /**< DbManager call site */
+    double ms;
+    QString query; /**< SQL with the bound values */
+    QString plan; /**< EXPLAIN QUERY PLAN output */
+};
+
+class QueryStats
+{
+public:
+    static void Record(const QString &location, qint64 nsecs, qint64 rows);
+    static void RecordSlow(const SlowQuery &slowQuery);
+    static quint64 Count();
+    static QVector<QueryStat> Stats();
+    static QVector<SlowQuery> SlowQueries();
+    static int SlowThreshold();
+    static void SetSlowThreshold(int ms);
+    static void Reset();
+    static QJsonObject ToJson();
+    static QString ToText();
+};
+
+#endif // QUERYSTATS_H
@@ -0,0 +1,191 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "dbmanager.h"
+#include "searchview.h"
+#include "stigcheck.h"
+
+#include <iostream>
+
+#include "ui_searchview.h"
+
+/**
+ * @class SearchView
+ * @brief Full-text search of the content of every imported @a STIG.
+ *
+ * Matching @a STIGChecks are listed from the best match to the worst,
+ * and the selected @a STIGCheck is displayed beside the results.
+ */
+
+/**
+ * @brief SearchView::SearchView
+ * @param parent
+ *
+ * Main Constructor
+ */
+SearchView::SearchView(QWidget *parent) : TabViewWidget (parent),
+    ui(new Ui::SearchView)
+{
+    ui->setupUi(this);
+
+    ui->splitter->setStretchFactor(0, 1);
+    ui->splitter->setStretchFactor(1, 2);
+
+    //search once the user stops typing; see SearchChanged()
+    _timer.setSingleShot(true);
+    connect(&_timer, SIGNAL(timeout()), this, SLOT(SearchHelper()));
+}
+
+/**
+ * @brief SearchView::~SearchView
+ *
+ * Destructor.
+ */
+SearchView::~SearchView()
+{
+    delete ui;
+}
+
+/**
+ * @brief SearchView::DisableInput
+ *
+ * Prevent user interaction while background processes are busy.
+ */
+void SearchView::DisableInput()
+{
+    ui->txtSearch->setEnabled(false);
+}
+
+/**
+ * @brief SearchView::EnableInput
+ *
+ * Enable all controls when background worker finishes.
+ */
+void SearchView::EnableInput()
+{
+    ui->txtSearch->setEnabled(true);
+}
+
+/**
+ * @brief SearchView::GetTabType
+ * @return Indication that this is a search tab
+ */
+TabType SearchView::GetTabType()
+{
+    return TabType::search;
+}
+
+/**
+ * @brief SearchView::Search
+ * @param search
+ *
+ * Display the @a STIGChecks matching the @a search text.
+ */
+void SearchView::Search(const QString &search)
+{
+    DbManager db;
+    ui->lstResults->clear();
+    ui->txtCheck->clear();
+    QVector<STIGCheckHit> hits = db.SearchSTIGChecks(search);
+    Q_FOREACH (const STIGCheckHit &hit, hits)
+    {
+        auto *i = new QListWidgetItem(hit.rule + QStringLiteral(": ") + hit.title); //memory managed by ui->lstResults container
+        i->setToolTip(hit.stigTitle + (hit.snippet.isEmpty() ? QString() : QStringLiteral("\n\n") + hit.snippet));
+        i->setData(Qt::UserRole, hit.stigCheckId);
+        ui->lstResults->addItem(i);
+    }
+    int count = hits.count();
+    ui->lblResults->setText(QString::number(count) + QStringLiteral(" result") + Pluralize(count));
+}
+
+#ifdef USE_TESTS
+/**
+ * @brief SearchView::RunTests
+ *
+ * Run interface tests.
+ */
+void SearchView::RunTests()
+{
+    int onTest = 0;
+
+    //search the STIG content
+    std::cout << "\t\tTest " << onTest++ << ": Search" << std::endl;
+    Search(QStringLiteral("FIPS 140"));
+
+    //view each result
+    std::cout << "\t\tTest " << onTest++ << ": Select Results" << std::endl;
+    for (int i = 0; i < ui->lstResults->count(); ++i)
+    {
+        ui->lstResults->setCurrentRow(i);
+    }
+
+    //search FTS5 syntax and prefixes
+    std::cout << "\t\tTest " << onTest++ << ": Search Syntax" << std::endl;
+    Search(QStringLiteral("\"audit log\""));
+    Search(QStringLiteral("passw* V-"));
+
+    //clear the search
+    std::cout << "\t\tTest " << onTest++ << ": Clear Search" << std::endl;
+    Search(QString());
+}
+#endif
+
+/**
+ * @brief SearchView::SearchChanged
+ *
+ * Detects when the user has changed the search text and been idle
+ * for a while.
+ */
+void SearchView::SearchChanged()
+{
+    _timer.start(250);
+}
+
+/**
+ * @brief SearchView::SearchHelper
+ *
+ * Search for the text entered by the user.
+ */
+void SearchView::SearchHelper()
+{
+    Search(ui->txtSearch->text());
+}
+
+/**
+ * @brief SearchView::SelectResult
+ *
+ * Display the selected @a STIGCheck.
+ */
+void SearchView::SelectResult()
+{
+    QList<QListWidgetItem*> selectedItems = ui->lstResults->selectedItems();
+    if (selectedItems.count() > 0)
+    {
+        DbManager db;
+        STIGCheck sc = db.GetSTIGCheck(selectedItems.first()->data(Qt::UserRole).toInt());
+        QString html = QStringLiteral("<h3>") + PrintSTIG(sc.GetSTIG()).toHtmlEscaped() + QStringLiteral("</h3>");
+        html.append(QStringLiteral("<h4>") + sc.rule.toHtmlEscaped() + QStringLiteral(" (") + sc.vulnNum.toHtmlEscaped() + QStringLiteral(") ") + GetSeverity(sc.severity).toHtmlEscaped() + QStringLiteral("</h4>"));
+        html.append(QStringLiteral("<p><b>") + sc.title.toHtmlEscaped() + QStringLiteral("</b></p>"));
+        html.append(QStringLiteral("<h4>Discussion</h4><p style=\"white-space: pre-wrap\">") + sc.vulnDiscussion.toHtmlEscaped() + QStringLiteral("</p>"));
+        html.append(QStringLiteral("<h4>Check</h4><p style=\"white-space: pre-wrap\">") + sc.check.toHtmlEscaped() + QStringLiteral("</p>"));
+        html.append(QStringLiteral("<h4>Fix</h4><p style=\"white-space: pre-wrap\">") + sc.fix.toHtmlEscaped() + QStringLiteral("</p>"));
+        ui->txtCheck->setHtml(html);
+    }
+}
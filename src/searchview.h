@@ -0,0 +1,58 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEARCHVIEW_H
+#define SEARCHVIEW_H
+
+#include <QTimer>
+#include <QWidget>
+
+#include "tabviewwidget.h"
+
+namespace Ui {
+class SearchView;
+}
+
+class SearchView : public TabViewWidget
+{
+    Q_OBJECT
+
+public:
+    SearchView(const SearchView &sv) = delete;
+    explicit SearchView(QWidget *parent = nullptr);
+    ~SearchView() override;
+    void DisableInput() override;
+    void EnableInput() override;
+    TabType GetTabType() override;
+    void Search(const QString &search);
+#ifdef USE_TESTS
+    void RunTests() override;
+#endif
+
+private Q_SLOTS:
+    void SearchChanged();
+    void SearchHelper();
+    void SelectResult();
+
+private:
+    Ui::SearchView *ui;
+    QTimer _timer;
+};
+
+#endif // SEARCHVIEW_H
@@ -38,6 +38,15 @@ enum Severity
 Severity GetSeverity(const QString &severity);
 QString GetSeverity(Severity severity, bool cat = true); //cat levels or low/mod/high
 
+struct STIGCheckHit
+{
+    int stigCheckId; /**< STIGCheck database id */
+    QString stigTitle;
+    QString rule;
+    QString title;
+    QString snippet; /**< matching excerpt of the STIGCheck content */
+};
+
 class STIGCheck : public QObject
 {
     Q_OBJECT
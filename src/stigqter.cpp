@@ -20,6 +20,8 @@
 #include "assetview.h"
 #include "common.h"
 #include "help.h"
+#include "memorymonitor.h"
+#include "searchview.h"
 #include "stigedit.h"
 #include "stigqter.h"
 #include "workerassetadd.h"
@@ -50,6 +52,7 @@
 #include <QStandardPaths>
 #include <QThread>
 
+#include <algorithm>
 #include <iostream>
 
 /**
@@ -96,6 +99,16 @@ STIGQter::STIGQter(QWidget *parent) :
     //set the title bar
     this->setWindowTitle(QStringLiteral("STIGQter ") + VERSION);
 
+    //the Assets, CCIs, and STIGs are listed through lightweight models
+    ui->lstAssets->setModel(&_assetModel);
+    ui->lstCCIs->setModel(&_cciModel);
+    _stigProxy.setSourceModel(&_stigModel);
+    _stigProxy.setFilterRole(DbListModel::FilterRole);
+    _stigProxy.setFilterCaseSensitivity(Qt::CaseInsensitive);
+    ui->lstSTIGs->setModel(&_stigProxy);
+    connect(ui->lstAssets->selectionModel(), SIGNAL(selectionChanged(QItemSelection, QItemSelection)), this, SLOT(SelectAsset()));
+    connect(ui->lstSTIGs->selectionModel(), SIGNAL(selectionChanged(QItemSelection, QItemSelection)), this, SLOT(SelectSTIG()));
+
     //make sure that the initial data are populated and active
     Display();
 
@@ -105,8 +118,21 @@ STIGQter::STIGQter(QWidget *parent) :
     //set keyboard shortcuts
     _shortcuts.append(new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_S), this, SLOT(Save())));
 
+    /*
+     * Tabs that have not been viewed for a while are suspended to
+     * release their memory; see SuspendTabs().
+     */
+    connect(&_timerSuspend, SIGNAL(timeout()), this, SLOT(SuspendTabs()));
+    _timerSuspend.start(60000);
+
     //display path to database file
     DbManager db;
+
+    //keep the background jobs within the memory budget and show how much is used
+    MemoryMonitor::SetBudget(db.GetVariable(QStringLiteral("memoryBudget")).toLongLong() * 1024 * 1024);
+    connect(&_timerMemory, SIGNAL(timeout()), this, SLOT(UpdateMemory()));
+    _timerMemory.start(1000);
+    UpdateMemory();
     ui->lblDBLoc->setText(QStringLiteral("DB: ") + db.GetDBPath());
 
     //remember if we're indexing STIG checks
@@ -114,17 +140,24 @@ STIGQter::STIGQter(QWidget *parent) :
     ui->cbRemapCM6->setChecked(db.GetVariable("remapCM6").startsWith(QStringLiteral("y"), Qt::CaseInsensitive));
     UpdateRemapButton();
 
-    //check version number
-    auto *t = new QThread;
-    auto *c = new WorkerCheckVersion();
-    c->moveToThread(t);
-    connect(t, SIGNAL(started()), c, SLOT(process()));
-    connect(c, SIGNAL(finished()), t, SLOT(quit()));
-    connect(c, SIGNAL(ThrowWarning(QString, QString)), this, SLOT(ShowMessage(QString, QString)));
-    threads.append(t);
-    workers.append(c);
-
-    t->start(); //WorkerCheckVersion()
+    //background jobs report through the scheduler
+    connect(&_scheduler, SIGNAL(JobFinished(int)), this, SLOT(CompletedJob(int)));
+    connect(&_scheduler, SIGNAL(JobInitialize(int, int, int)), this, SLOT(JobInitialize(int, int, int)));
+    connect(&_scheduler, SIGNAL(JobProgress(int, int)), this, SLOT(JobProgress(int, int)));
+    connect(&_scheduler, &JobScheduler::JobStatus, this, [this](int id, const QString &status) {
+        if (_jobProgress.contains(id))
+            StatusChange(status);
+    });
+    connect(&_scheduler, &JobScheduler::JobMemory, this, [this](int, const MemoryUsage *memory) {
+        ui->lblMemory->setToolTip(QStringLiteral("The last background task peaked at ") + QString::number(memory->PeakResident() / (1024 * 1024)) + QStringLiteral(" MiB resident with ") + QString::number(memory->PeakTracked() / (1024 * 1024)) + QStringLiteral(" MiB in tracked buffers."));
+    });
+    //one report of each job's warnings, once it finishes
+    connect(&_scheduler, &JobScheduler::JobWarnings, this, [this](int, const WarningSink *warnings) {
+        ShowMessage(warnings->Title(), warnings->Summary());
+    });
+
+    //check version number; it does not hold up the rest of the interface
+    _scheduler.Submit(new WorkerCheckVersion(), JobScheduler::CPUOnly);
 }
 
 /**
@@ -134,7 +167,11 @@ STIGQter::STIGQter(QWidget *parent) :
  */
 STIGQter::~STIGQter()
 {
-    CleanThreads();
+    //the scheduler waits on its running jobs when it is destroyed
+    disconnect(&_scheduler, nullptr, this, nullptr);
+    disconnect(ui->lstAssets->selectionModel(), nullptr, this, nullptr);
+    disconnect(ui->lstSTIGs->selectionModel(), nullptr, this, nullptr);
+    disconnect(ui->tabDB, nullptr, this, nullptr);
     delete ui;
     Q_FOREACH (QShortcut *shortcut, _shortcuts)
         delete shortcut;
@@ -153,20 +190,41 @@ bool STIGQter::isProcessingEnabled()
 }
 
 /**
- * @brief STIGQter::ConnectThreads
+ * @brief STIGQter::Scheduler
+ * @return The @a JobScheduler that runs the background workers.
+ */
+JobScheduler* STIGQter::Scheduler()
+{
+    return &_scheduler;
+}
+
+/**
+ * @brief STIGQter::StartJob
  * @param worker
+ * @param jobClass
+ * @return The id of the job.
  *
- * Connect STIGQter input/output to the worker and its thread
+ * Run the @a worker in the background and show its progress. Only
+ * jobs that change the database lock the interface; read-only jobs
+ * run alongside editing and alongside each other.
  */
-QThread* STIGQter::ConnectThreads(Worker *worker)
+int STIGQter::StartJob(Worker *worker, JobScheduler::JobClass jobClass)
 {
-    DisableInput();
-    auto *t = worker->ConnectThreads(this);
-
-    threads.append(t);
-    workers.append(worker);
+    //workers read the database, so the tabs' edits are written first
+    SaveChanges();
+    if (jobClass == JobScheduler::DatabaseWriter)
+        DisableInput();
+    ui->btnQuit->setEnabled(false);
 
-    return t;
+    int id = _scheduler.Submit(worker, jobClass);
+    //the job may not report its size until it starts
+    _jobProgress.insert(id, qMakePair(0, 0));
+    if (ui->btnPause->isChecked())
+        _scheduler.SetPaused(id, true);
+    ui->btnCancel->setEnabled(true);
+    ui->btnPause->setEnabled(true);
+    ShowProgress();
+    return id;
 }
 
 #ifdef USE_TESTS
@@ -228,6 +286,7 @@ void STIGQter::RunTests()
 
     // create asset
     std::cout << "\tTest " << step++ << ": Creating Asset \"TEST\"" << std::endl;
+    _stigModel.FetchAll();
     ui->lstSTIGs->selectAll();
     AddAsset(QStringLiteral("TEST"));
     ProcEvents();
@@ -303,6 +362,17 @@ void STIGQter::RunTests()
     Load(QStringLiteral("tests/test.stigqter"));
     ProcEvents();
 
+    //search STIG content (tested with the other tabs)
+    std::cout << "\tTest " << step++ << ": Opening STIG Search" << std::endl;
+    SearchSTIGs();
+    ProcEvents();
+
+    //suspend idle tabs
+    std::cout << "\tTest " << step++ << ": Suspend Idle Tabs" << std::endl;
+    SetSuspendTime(30);
+    SuspendTabs();
+    ProcEvents();
+
     // open all assets
     std::cout << "\tTest " << step++ << ": Opening Assets" << std::endl;
     {
@@ -310,18 +380,10 @@ void STIGQter::RunTests()
         {
             ui->lstAssets->clearSelection();
             ProcEvents();
+            _assetModel.FetchAll();
             ui->lstAssets->selectAll();
             ProcEvents();
 
-            for (int i = 0; i < ui->lstAssets->count(); i++)
-            {
-                auto a = ui->lstAssets->item(i);
-                if (!a->isSelected())
-                    a->setSelected(true);
-            }
-
-            ProcEvents();
-
             OpenCKL();
             ProcEvents();
         }
@@ -360,11 +422,28 @@ void STIGQter::RunTests()
     ExportHTML(QStringLiteral("tests"));
     ProcEvents();
 
+    // export HTML archive
+    std::cout << "\tTest " << step++ << ": HTML Checklist Archive" << std::endl;
+    ExportHTMLArchive(QStringLiteral("tests/html.zip"));
+    ProcEvents();
+
+    // cancel a paused export
+    std::cout << "\tTest " << step++ << ": Cancel HTML Checklist Archive" << std::endl;
+    ExportHTMLArchive(QStringLiteral("tests/cancelled.zip"));
+    ui->btnPause->setChecked(true);
+    CancelJobs();
+    ProcEvents();
+
     // export CMRS
     std::cout << "\tTest " << step++ << ": Export CMRS" << std::endl;
     ExportCMRS(QStringLiteral("tests/cmrs.xml"));
     ProcEvents();
 
+    // export compressed CMRS
+    std::cout << "\tTest " << step++ << ": Export Compressed CMRS" << std::endl;
+    ExportCMRS(QStringLiteral("tests/cmrs.xml.gz"));
+    ProcEvents();
+
     // export eMASS
     std::cout << "\tTest " << step++ << ": Export eMASS TR" << std::endl;
     ExportEMASS(QStringLiteral("tests/emass.xlsx"));
@@ -378,6 +457,15 @@ void STIGQter::RunTests()
         a->close();
         ProcEvents();
     }
+
+    // diagnostics screen
+    std::cout << "\tTest " << step++ << ": Diagnostics Screen" << std::endl;
+    {
+        auto d = ShowDiagnostics();
+        ProcEvents();
+        d->close();
+        ProcEvents();
+    }
 }
 #endif
 
@@ -395,7 +483,17 @@ void STIGQter::UpdateCCIs()
     //Create thread to download CCIs and keep GUI active
     auto *c = new WorkerCCIAdd();
 
-    ConnectThreads(c)->start();
+    StartJob(c, JobScheduler::DatabaseWriter);
+}
+
+/**
+ * @brief STIGQter::UpdateMemory
+ *
+ * Display the memory in use and the memory budget.
+ */
+void STIGQter::UpdateMemory()
+{
+    ui->lblMemory->setText(MemoryMonitor::ToText());
 }
 
 /**
@@ -405,9 +503,10 @@ void STIGQter::UpdateCCIs()
  */
 void STIGQter::OpenCKL()
 {
-    Q_FOREACH(QListWidgetItem *i, ui->lstAssets->selectedItems())
+    DbManager db;
+    Q_FOREACH (int id, SelectedIds(ui->lstAssets))
     {
-        auto a = i->data(Qt::UserRole).value<Asset>();
+        auto a = db.GetAsset(id);
         QString assetName = PrintAsset(a);
         for (int j = 0; j < ui->tabDB->count(); j++)
         {
@@ -424,6 +523,20 @@ void STIGQter::OpenCKL()
     }
 }
 
+/**
+ * @brief STIGQter::PauseJobs
+ * @param paused
+ *
+ * Pause or resume the background jobs. Paused jobs stop at their
+ * next check and use no processor time until they are resumed.
+ */
+void STIGQter::PauseJobs(bool paused)
+{
+    Q_FOREACH (int id, _jobProgress.keys())
+        _scheduler.SetPaused(id, paused);
+    ui->btnPause->setText(paused ? QStringLiteral("Resume") : QStringLiteral("Pause"));
+}
+
 /**
  * @brief STIGQter::RemapChanged
  * @param checkState
@@ -475,6 +588,7 @@ void STIGQter::RenameTab(int index, QString title)
  */
 bool STIGQter::Reset(bool checkOnly)
 {
+    SaveChanges();
     if (lastSaveLocation.isNull() || lastSaveLocation.isEmpty())
     {
         if (checkOnly)
@@ -542,6 +656,7 @@ void STIGQter::Save()
 
     if (!lastSaveLocation.isNull() && !lastSaveLocation.isEmpty())
     {
+        SaveChanges();
         DbManager db;
         db.SaveDB(lastSaveLocation);
     }
@@ -586,39 +701,25 @@ void STIGQter::SelectAsset()
  */
 void STIGQter::closeEvent(QCloseEvent *event)
 {
+    //write the edits that are still queued in the open tabs
+    SaveChanges();
     event->setAccepted(Reset(true));
 }
 
 /**
- * @brief STIGQter::CleanThreads
- * When the program closes, wait on all background threads to finish
- * processing.
- */
-void STIGQter::CleanThreads()
-{
-    while (!threads.isEmpty())
-    {
-        auto *t = threads.takeFirst();
-        t->wait();
-        delete t;
-    }
-    Q_FOREACH (const QObject *o, workers)
-    {
-        delete o;
-    }
-    workers.clear();
-}
-
-/**
- * @brief STIGQter::CompletedThread
+ * @brief STIGQter::CompletedJob
+ * @param id
  *
- * When a background thread completes, this function is signaled to
+ * When a background job completes, this function is signaled to
  * update UI elements with the new data.
  */
-void STIGQter::CompletedThread()
+void STIGQter::CompletedJob(int id)
 {
-    EnableInput();
-    CleanThreads();
+    if (!_jobProgress.remove(id))
+        return;
+    //input stays locked until every queued database change is done
+    if (!_scheduler.IsWriting())
+        EnableInput();
     if (_updatedCCIs)
     {
         DisplayCCIs();
@@ -634,10 +735,18 @@ void STIGQter::CompletedThread()
         DisplayAssets();
         _updatedAssets = false;
     }
-    //when maximum <= 0, the progress bar loops
-    if (ui->progressBar->maximum() <= 0)
-        ui->progressBar->setMaximum(1);
-    ui->progressBar->setValue(ui->progressBar->maximum());
+    if (_jobProgress.isEmpty())
+    {
+        ui->btnCancel->setEnabled(false);
+        ui->btnPause->setChecked(false);
+        ui->btnPause->setEnabled(false);
+        //when maximum <= 0, the progress bar loops
+        if (ui->progressBar->maximum() <= 0)
+            ui->progressBar->setMaximum(1);
+        ui->progressBar->setValue(ui->progressBar->maximum());
+    }
+    else
+        ShowProgress();
 }
 
 /**
@@ -666,18 +775,18 @@ void STIGQter::AddAsset(const QString &name)
                                           QDir::home().dirName(), &ok);
     if (ok)
     {
-        DisableInput();
         _updatedAssets = true;
         auto *a = new WorkerAssetAdd();
         Asset tmpAsset;
         tmpAsset.hostName = asset;
-        Q_FOREACH(QListWidgetItem *i, ui->lstSTIGs->selectedItems())
+        DbManager db;
+        Q_FOREACH (int id, SelectedIds(ui->lstSTIGs))
         {
-            a->AddSTIG(i->data(Qt::UserRole).value<STIG>());
+            a->AddSTIG(db.GetSTIG(id));
         }
         a->AddAsset(tmpAsset);
 
-        ConnectThreads(a)->start();
+        StartJob(a, JobScheduler::DatabaseWriter);
     }
 }
 
@@ -698,13 +807,26 @@ void STIGQter::AddSTIGs()
 
     db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(fileNames[0]).absolutePath());
 
-    DisableInput();
     _updatedSTIGs = true;
     auto *s = new WorkerSTIGAdd();
     s->AddSTIGs(fileNames);
     s->SetEnableSupplements(ui->cbIncludeSupplements->isChecked());
 
-    ConnectThreads(s)->start();
+    StartJob(s, JobScheduler::DatabaseWriter);
+}
+
+/**
+ * @brief STIGQter::CancelJobs
+ *
+ * Stop the background jobs. Each job undoes its partial changes to
+ * the database before it finishes.
+ */
+void STIGQter::CancelJobs()
+{
+    StatusChange(QStringLiteral("Cancelling…"));
+    //cancelling a waiting job finishes it right away, which changes the list
+    Q_FOREACH (int id, _jobProgress.keys())
+        _scheduler.Cancel(id);
 }
 
 /**
@@ -716,7 +838,12 @@ void STIGQter::AddSTIGs()
 void STIGQter::CloseTab(int index)
 {
     if (ui->tabDB->count() > index)
+    {
+        auto *tmpTabView = dynamic_cast<TabViewWidget*>(ui->tabDB->widget(index));
+        if (tmpTabView)
+            tmpTabView->SaveChanges();
         ui->tabDB->removeTab(index);
+    }
     for (int j = 1; j < ui->tabDB->count(); j++)
     {
         //reset the tab indices for the tabs that were not closed
@@ -734,13 +861,12 @@ void STIGQter::CloseTab(int index)
  */
 void STIGQter::DeleteCCIs()
 {
-    DisableInput();
     _updatedCCIs = true;
 
     //Create thread to download CCIs and keep GUI active
     auto *c = new WorkerCCIDelete();
 
-    ConnectThreads(c)->start();
+    StartJob(c, JobScheduler::DatabaseWriter);
 }
 
 /**
@@ -763,17 +889,15 @@ void STIGQter::DeleteEmass()
  */
 void STIGQter::DeleteSTIGs()
 {
-    DisableInput();
     _updatedSTIGs = true;
 
     auto *s = new WorkerSTIGDelete();
-    Q_FOREACH (QListWidgetItem *i, ui->lstSTIGs->selectedItems())
+    Q_FOREACH (int id, SelectedIds(ui->lstSTIGs))
     {
-        STIG stig = i->data(Qt::UserRole).value<STIG>();
-        s->AddId(stig.id);
+        s->AddId(id);
     }
 
-    ConnectThreads(s)->start();
+    StartJob(s, JobScheduler::DatabaseWriter);
 }
 
 /**
@@ -797,14 +921,13 @@ void STIGQter::Display()
  */
 void STIGQter::DownloadSTIGs()
 {
-    DisableInput();
     _updatedSTIGs = true;
 
     //Create thread to download CCIs and keep GUI active
     auto *s = new WorkerSTIGDownload();
     s->SetEnableSupplements(ui->cbIncludeSupplements->isChecked());
 
-    ConnectThreads(s)->start();
+    StartJob(s, JobScheduler::DatabaseWriter);
 }
 
 /**
@@ -819,9 +942,10 @@ void STIGQter::EditSTIG()
 
     //buffer the STIGs before opening them
     QVector<STIG> stigs;
-    Q_FOREACH(QListWidgetItem *i, ui->lstSTIGs->selectedItems())
+    DbManager db;
+    Q_FOREACH (int id, SelectedIds(ui->lstSTIGs))
     {
-        stigs.append(i->data(Qt::UserRole).value<STIG>());
+        stigs.append(db.GetSTIG(id));
     }
 
     //open each buffered STIG
@@ -846,6 +970,28 @@ void STIGQter::EditSTIG()
     ui->tabDB->setCurrentIndex(currentIndex);
 }
 
+/**
+ * @brief STIGQter::SearchSTIGs
+ *
+ * Opens the full-text search of the imported STIG content.
+ */
+void STIGQter::SearchSTIGs()
+{
+    for (int j = 1; j < ui->tabDB->count(); j++)
+    {
+        auto *tmpTabView = dynamic_cast<TabViewWidget*>(ui->tabDB->widget(j));
+        if (tmpTabView && (tmpTabView->GetTabType() == TabType::search))
+        {
+            ui->tabDB->setCurrentIndex(j);
+            return;
+        }
+    }
+    auto *sv = new SearchView(this);
+    int index = ui->tabDB->addTab(sv, QStringLiteral("Search"));
+    sv->SetTabIndex(index);
+    ui->tabDB->setCurrentIndex(index);
+}
+
 /**
  * @brief STIGQter::ExportCKLs
  * @param dir
@@ -859,12 +1005,11 @@ void STIGQter::ExportCKLs(const QString &dir)
 
     if (!dirName.isNull() && !dirName.isEmpty())
     {
-        DisableInput();
         db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(dirName).absolutePath());
         auto *f = new WorkerCKLExport();
         f->SetExportDir(dirName);
 
-        ConnectThreads(f)->start();
+        StartJob(f, JobScheduler::ReadOnly);
     }
 }
 
@@ -876,17 +1021,16 @@ void STIGQter::ExportCKLs(const QString &dir)
 void STIGQter::ExportCMRS(const QString &fileName)
 {
     DbManager db;
-    QString fn = !fileName.isEmpty() ? fileName : QFileDialog::getSaveFileName(this, QStringLiteral("Save CMRS Report"), db.GetVariable(QStringLiteral("lastdir")), QStringLiteral("CMRS XML (*.xml)"));
+    QString fn = !fileName.isEmpty() ? fileName : QFileDialog::getSaveFileName(this, QStringLiteral("Save CMRS Report"), db.GetVariable(QStringLiteral("lastdir")), QStringLiteral("CMRS XML (*.xml);;Compressed CMRS XML (*.xml.gz)"));
 
     if (fn.isNull() || fn.isEmpty())
         return; // cancel button pressed
 
-    DisableInput();
     db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(fn).absolutePath());
     auto *f = new WorkerCMRSExport();
     f->SetExportPath(fn);
 
-    ConnectThreads(f)->start();
+    StartJob(f, JobScheduler::ReadOnly);
 }
 
 /**
@@ -902,12 +1046,11 @@ void STIGQter::ExportEMASS(const QString &fileName)
     if (fn.isNull() || fn.isEmpty())
         return; // cancel button pressed
 
-    DisableInput();
     db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(fn).absolutePath());
     auto *f = new WorkerEMASSReport();
     f->SetReportName(fn);
 
-    ConnectThreads(f)->start();
+    StartJob(f, JobScheduler::ReadOnly);
 }
 
 /**
@@ -923,15 +1066,36 @@ void STIGQter::ExportHTML(const QString &dir)
 
     if (!dirName.isNull() && !dirName.isEmpty())
     {
-        DisableInput();
         db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(dirName).absolutePath());
         auto *f = new WorkerHTML();
         f->SetDir(dirName);
 
-        ConnectThreads(f)->start();
+        StartJob(f, JobScheduler::ReadOnly);
     }
 }
 
+/**
+ * @brief STIGQter::ExportHTMLArchive
+ * @param fileName
+ *
+ * Instantiates an instance of WorkerHTML to export the HTML
+ * checklists into a single zip archive.
+ */
+void STIGQter::ExportHTMLArchive(const QString &fileName)
+{
+    DbManager db;
+    QString fn = !fileName.isEmpty() ? fileName : QFileDialog::getSaveFileName(this, QStringLiteral("Save HTML Archive"), db.GetVariable(QStringLiteral("lastdir")), QStringLiteral("Zip Archive (*.zip)"));
+
+    if (fn.isNull() || fn.isEmpty())
+        return; // cancel button pressed
+
+    db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(fn).absolutePath());
+    auto *f = new WorkerHTML();
+    f->SetArchive(fn);
+
+    StartJob(f, JobScheduler::ReadOnly);
+}
+
 /**
  * @brief STIGQter::FilterSTIGs
  * @param text
@@ -942,13 +1106,15 @@ void STIGQter::FilterSTIGs(const QString &text)
 {
     if (text.length() > 2)
     {
+        //every STIG is filtered, not only those scrolled into view
         _isFiltered = true;
-        DisplaySTIGs(text);
+        _stigModel.FetchAll();
+        _stigProxy.setFilterFixedString(text);
     }
     else if (_isFiltered)
     {
         _isFiltered = false;
-        DisplaySTIGs();
+        _stigProxy.setFilterFixedString(QString());
     }
 }
 
@@ -968,11 +1134,10 @@ void STIGQter::FindingsReport(const QString &fileName)
         return; // cancel button pressed
 
     db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(fn).absolutePath());
-    DisableInput();
     auto *f = new WorkerFindingsReport();
     f->SetReportName(fn);
 
-    ConnectThreads(f)->start();
+    StartJob(f, JobScheduler::ReadOnly);
 }
 
 /**
@@ -991,12 +1156,11 @@ void STIGQter::ImportCKLs(const QStringList &fileNames)
         return; // cancel button pressed
 
     db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(fn[0]).absolutePath());
-    DisableInput();
     _updatedAssets = true;
     auto *c = new WorkerCKLImport();
     c->AddCKLs(fn);
 
-    ConnectThreads(c)->start();
+    StartJob(c, JobScheduler::DatabaseWriter);
 }
 
 /**
@@ -1013,12 +1177,11 @@ void STIGQter::ImportEMASS(const QString &fileName)
     if (fn.isNull() || fn.isEmpty())
         return; // cancel button pressed
 
-    DisableInput();
     db.UpdateVariable(QStringLiteral("lastdir"), QFileInfo(fn).absolutePath());
     auto *c = new WorkerImportEMASS();
     c->SetReportName(fn);
 
-    ConnectThreads(c)->start();
+    StartJob(c, JobScheduler::DatabaseWriter);
 }
 
 /**
@@ -1034,6 +1197,11 @@ void STIGQter::Load(const QString &fileName)
 
     if (!fn.isNull() && !fn.isEmpty())
     {
+        if (!_jobProgress.isEmpty())
+        {
+            Warning(QStringLiteral("Unable to Load"), QStringLiteral("Wait for the background tasks to finish before loading another file."));
+            return;
+        }
         while (ui->tabDB->count() > 1)
             ui->tabDB->removeTab(1);
         db.LoadDB(fn);
@@ -1066,13 +1234,12 @@ void STIGQter::MapUnmapped(bool confirm)
     QMessageBox::StandardButton reply = confirm ? QMessageBox::Yes : QMessageBox::question(this, QStringLiteral("Non-Standard CKLs"), QStringLiteral("This feature will map all unmapped STIG checks, STIG checks from other system categorizations, and incorrectly mapped STIG checks to ") + cciStr + QStringLiteral(". CKL files generated will no longer be consistent with STIGViewer and other tools. Are you sure you want to proceed?"), QMessageBox::Yes|QMessageBox::No);
     if (reply == QMessageBox::Yes)
     {
-        DisableInput();
         _updatedCCIs = true;
 
         //Create thread to download CCIs and keep GUI active
         auto *c = new WorkerMapUnmapped();
 
-        ConnectThreads(c)->start();
+        StartJob(c, JobScheduler::DatabaseWriter);
     }
 }
 
@@ -1084,7 +1251,65 @@ void STIGQter::MapUnmapped(bool confirm)
 void STIGQter::SelectSTIG()
 {
     //select STIGs to create checklists
-    ui->btnCreateCKL->setEnabled(ui->lstSTIGs->selectedItems().count() > 0);
+    ui->btnCreateCKL->setEnabled(ui->lstSTIGs->selectionModel()->hasSelection());
+}
+
+/**
+ * @brief STIGQter::SetMemoryBudget
+ * @param megabytes
+ *
+ * Set how many @a megabytes (MiB) the background tasks try to stay
+ * within. When @a megabytes is negative, the user is prompted for it;
+ * 0 is unlimited.
+ */
+void STIGQter::SetMemoryBudget(int megabytes)
+{
+    DbManager db;
+    if (megabytes < 0)
+    {
+        bool ok = false;
+        megabytes = QInputDialog::getInt(this, QStringLiteral("Memory Budget"), QStringLiteral("MiB of memory that background tasks try to stay within (0 for unlimited):"), db.GetVariable(QStringLiteral("memoryBudget")).toInt(), 0, 1048576, 256, &ok);
+        if (!ok)
+            return;
+    }
+    db.UpdateVariable(QStringLiteral("memoryBudget"), QString::number(megabytes));
+    MemoryMonitor::SetBudget(static_cast<qint64>(megabytes) * 1024 * 1024);
+    UpdateMemory();
+}
+
+/**
+ * @brief STIGQter::SetSuspendTime
+ * @param minutes
+ *
+ * Set how many @a minutes a tab may go unviewed before it is
+ * suspended. When @a minutes is negative, the user is prompted for
+ * it; 0 never suspends tabs.
+ */
+void STIGQter::SetSuspendTime(int minutes)
+{
+    DbManager db;
+    if (minutes < 0)
+    {
+        bool ok = false;
+        minutes = QInputDialog::getInt(this, QStringLiteral("Suspend Idle Tabs"), QStringLiteral("Minutes before an unviewed tab is suspended (0 to never suspend):"), db.GetVariable(QStringLiteral("suspendTabMinutes")).toInt(), 0, 10080, 1, &ok);
+        if (!ok)
+            return;
+    }
+    db.UpdateVariable(QStringLiteral("suspendTabMinutes"), QString::number(minutes));
+}
+
+/**
+ * @brief STIGQter::ShowDiagnostics
+ *
+ * Display the @a Diagnostics screen with the latency of the database
+ * queries.
+ */
+Diagnostics* STIGQter::ShowDiagnostics()
+{
+    Diagnostics *d = new Diagnostics();
+    d->setAttribute(Qt::WA_DeleteOnClose); //clean up after itself (no explicit "delete" needed)
+    d->show();
+    return d;
 }
 
 /**
@@ -1125,6 +1350,53 @@ void STIGQter::SupplementsChanged(int checkState)
     db.UpdateVariable(QStringLiteral("indexSupplements"), checkState == Qt::Checked ? QStringLiteral("y") : QStringLiteral("n"));
 }
 
+/**
+ * @brief STIGQter::SuspendTabs
+ *
+ * Suspend the tabs that have not been viewed for longer than the
+ * configured number of minutes so that the memory used by the open
+ * tabs stays bounded. Suspended tabs are reloaded when they are
+ * viewed again.
+ */
+void STIGQter::SuspendTabs()
+{
+    //the displayed tab is in use
+    auto *current = dynamic_cast<TabViewWidget*>(ui->tabDB->currentWidget());
+    if (current)
+        current->Viewed();
+
+    if (!isProcessingEnabled())
+        return;
+
+    DbManager db;
+    qint64 idle = db.GetVariable(QStringLiteral("suspendTabMinutes")).toLongLong() * 60000;
+    if (idle <= 0)
+        return;
+
+    for (int i = 1; i < ui->tabDB->count(); i++)
+    {
+        auto *tmpTabView = dynamic_cast<TabViewWidget*>(ui->tabDB->widget(i));
+        if (tmpTabView && tmpTabView != current && tmpTabView->IdleTime() > idle)
+            tmpTabView->Suspend();
+    }
+}
+
+/**
+ * @brief STIGQter::TabChanged
+ * @param index
+ *
+ * Reload the newly displayed tab if it was suspended.
+ */
+void STIGQter::TabChanged(int index)
+{
+    auto *tmpTabView = dynamic_cast<TabViewWidget*>(ui->tabDB->widget(index));
+    if (tmpTabView)
+    {
+        tmpTabView->Resume();
+        tmpTabView->Viewed();
+    }
+}
+
 /**
  * @brief STIGQter::EnableInput
  *
@@ -1167,8 +1439,8 @@ void STIGQter::EnableInput()
     ui->btnMapUnmapped->setEnabled(isImport);
     ui->cbIncludeSupplements->setEnabled(true);
     ui->cbRemapCM6->setEnabled(true);
-    ui->btnOpenCKL->setEnabled(ui->lstAssets->selectedItems().count() > 0);
-    ui->btnQuit->setEnabled(true);
+    ui->btnOpenCKL->setEnabled(ui->lstAssets->selectionModel()->hasSelection());
+    ui->btnQuit->setEnabled(_jobProgress.isEmpty());
     ui->menubar->setEnabled(true);
     ui->txtSTIGSearch->setEnabled(true);
     ui->tabDB->setEnabled(true);
@@ -1201,10 +1473,10 @@ void STIGQter::UpdateRemapButton()
 void STIGQter::UpdateSTIGs()
 {
     ui->lstCKLs->clear();
-    Q_FOREACH (QListWidgetItem *i, ui->lstAssets->selectedItems())
+    DbManager db;
+    Q_FOREACH (int id, SelectedIds(ui->lstAssets))
     {
-        auto a = i->data(Qt::UserRole).value<Asset>();
-        Q_FOREACH (const STIG &s, a.GetSTIGs())
+        Q_FOREACH (const STIG &s, db.GetSTIGs(db.GetAsset(id)))
         {
             ui->lstCKLs->addItem(PrintSTIG(s));
         }
@@ -1212,36 +1484,78 @@ void STIGQter::UpdateSTIGs()
 }
 
 /**
- * @brief STIGQter::Initialize
+ * @brief STIGQter::JobInitialize
+ * @param id
  * @param max
  * @param val
  *
- * Initializes the progress bar so that it has @a max steps and is
- * currently at step @a val.
+ * Job @a id has @a max steps and is currently at step @a val.
  */
-void STIGQter::Initialize(int max, int val)
+void STIGQter::JobInitialize(int id, int max, int val)
 {
-    ui->progressBar->reset();
-    ui->progressBar->setMaximum(max);
-    ui->progressBar->setValue(val);
+    auto it = _jobProgress.find(id);
+    if (it == _jobProgress.end())
+        return;
+    it.value() = qMakePair(max, val);
+    ShowProgress();
 }
 
 /**
- * @brief STIGQter::Progress
+ * @brief STIGQter::JobProgress
+ * @param id
  * @param val
  *
- * Sets the progress bar to display that it is at step @a val. If a
- * negative number is given, it increments the progress bar by one
- * step.
+ * Job @a id is at step @a val. If a negative number is given, the
+ * job is one step further along.
+ */
+void STIGQter::JobProgress(int id, int val)
+{
+    auto it = _jobProgress.find(id);
+    if (it == _jobProgress.end())
+        return;
+    it.value().second = val < 0 ? it.value().second + 1 : val;
+    ShowProgress();
+}
+
+/**
+ * @brief STIGQter::ShowProgress
+ *
+ * Display the combined progress of the running jobs. While any job
+ * has not reported its size, the progress bar loops.
  */
-void STIGQter::Progress(int val)
+void STIGQter::ShowProgress()
 {
-    if (val < 0)
+    int max = 0;
+    int val = 0;
+    bool unknown = false;
+    Q_FOREACH (const auto &progress, _jobProgress)
     {
-        ui->progressBar->setValue(ui->progressBar->value() + 1);
+        if (progress.first <= 0)
+            unknown = true;
+        max += progress.first;
+        val += std::min(progress.second, progress.first);
     }
-    else
-        ui->progressBar->setValue(val);
+    ui->progressBar->setMaximum(unknown ? 0 : max);
+    ui->progressBar->setValue(unknown ? 0 : val);
+}
+
+/**
+ * @brief STIGQter::SaveChanges
+ * @return @c True when every tab's changes have been written to the
+ * database. Otherwise, @c false.
+ *
+ * Write the changes that the open tabs have not yet saved.
+ */
+bool STIGQter::SaveChanges()
+{
+    bool ret = true;
+    for (int i = 1; i < ui->tabDB->count(); i++)
+    {
+        auto *tmpTabView = dynamic_cast<TabViewWidget*>(ui->tabDB->widget(i));
+        if (tmpTabView && !tmpTabView->SaveChanges())
+            ret = false;
+    }
+    return ret;
 }
 
 /**
@@ -1284,15 +1598,8 @@ void STIGQter::DisableInput()
  */
 void STIGQter::DisplayAssets()
 {
-    ui->lstAssets->clear();
     DbManager db;
-    Q_FOREACH(const Asset &a, db.GetAssets())
-    {
-        auto *tmpItem = new QListWidgetItem(); //memory managed by ui->lstAssets container
-        tmpItem->setData(Qt::UserRole, QVariant::fromValue<Asset>(a));
-        tmpItem->setText(PrintAsset(a));
-        ui->lstAssets->addItem(tmpItem);
-    }
+    _assetModel.SetRows(db.GetAssetRows());
 }
 
 /**
@@ -1302,41 +1609,38 @@ void STIGQter::DisplayAssets()
  */
 void STIGQter::DisplayCCIs()
 {
-    ui->lstCCIs->clear();
     DbManager db;
-    Q_FOREACH(const CCI &c, db.GetCCIs())
-    {
-        auto *tmpItem = new QListWidgetItem(); //memory managed by ui->lstCCIs container
-        tmpItem->setData(Qt::UserRole, QVariant::fromValue<CCI>(c));
-        tmpItem->setText(PrintCCI(c));
-        ui->lstCCIs->addItem(tmpItem);
-    }
+    _cciModel.SetRows(db.GetCCIRows());
 }
 
 /**
  * @brief STIGQter::DisplaySTIGs
- * @param search
  *
  * Show the list of @a STIGs to the user. This represents the global
  * @a STIG list in the database representing all @a STIGs that have
  * been imported, not only the @a STIGs for a particular @a Asset.
+ * The list is filtered by FilterSTIGs().
  */
-void STIGQter::DisplaySTIGs(const QString &search)
+void STIGQter::DisplaySTIGs()
 {
-    ui->lstSTIGs->clear();
     DbManager db;
-    Q_FOREACH(const STIG &s, db.GetSTIGs())
-    {
-        //check to see if the filter is applied
-        if (!search.isEmpty())
-        {
-            if (!s.title.contains(search, Qt::CaseInsensitive))
-                continue;
-        }
+    _stigModel.SetRows(db.GetSTIGRows());
+    if (_isFiltered)
+        _stigModel.FetchAll();
+}
 
-        auto *tmpItem = new QListWidgetItem(); //memory managed by ui->lstSTIGs container
-        tmpItem->setData(Qt::UserRole, QVariant::fromValue<STIG>(s));
-        tmpItem->setText(PrintSTIG(s));
-        ui->lstSTIGs->addItem(tmpItem);
+/**
+ * @brief STIGQter::SelectedIds
+ * @param view
+ * @return The database ids of the entries selected in one of the
+ * main window's lists.
+ */
+QVector<int> STIGQter::SelectedIds(const QAbstractItemView *view)
+{
+    QVector<int> ret;
+    Q_FOREACH (const QModelIndex &i, view->selectionModel()->selectedIndexes())
+    {
+        ret.append(i.data(DbListModel::IdRole).toInt());
     }
+    return ret;
 }
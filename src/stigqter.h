@@ -20,12 +20,19 @@
 #ifndef STIGQTER_H
 #define STIGQTER_H
 
+#include <QAbstractItemView>
+#include <QHash>
 #include <QMainWindow>
 #include <QSettings>
 #include <QShortcut>
+#include <QSortFilterProxyModel>
+#include <QTimer>
 
+#include "dblistmodel.h"
 #include "dbmanager.h"
+#include "diagnostics.h"
 #include "help.h"
+#include "jobscheduler.h"
 #include "worker.h"
 
 namespace Ui {
@@ -40,8 +47,9 @@ public:
     explicit STIGQter(QWidget *parent = nullptr);
     ~STIGQter();
     bool isProcessingEnabled();
-    QThread* ConnectThreads(Worker *worker);
     void Display();
+    JobScheduler* Scheduler();
+    int StartJob(Worker *worker, JobScheduler::JobClass jobClass);
     void UpdateSTIGs();
 #ifdef USE_TESTS
     void ProcEvents();
@@ -50,11 +58,12 @@ public:
 
 private Q_SLOTS:
 
-    void CompletedThread();
+    void CompletedJob(int id);
 
     Help* About();
     void AddAsset(const QString &name = QString());
     void AddSTIGs();
+    void CancelJobs();
     void CloseTab(int index);
     void DeleteCCIs();
     void DeleteEmass();
@@ -65,6 +74,7 @@ private Q_SLOTS:
     void ExportCMRS(const QString &fileName = QString());
     void ExportEMASS(const QString &fileName = QString());
     void ExportHTML(const QString &dir = QString());
+    void ExportHTMLArchive(const QString &fileName = QString());
     void FilterSTIGs(const QString &text);
     void FindingsReport(const QString &fileName = QString());
     void ImportCKLs(const QStringList &fileNames = {});
@@ -72,37 +82,53 @@ private Q_SLOTS:
     void Load(const QString &fileName = QString());
     void MapUnmapped(bool confirm = false);
     void OpenCKL();
+    void PauseJobs(bool paused);
     void RemapChanged(int checkState);
     void RenameTab(int index, QString title);
     bool Reset(bool checkOnly = false);
     void Save();
     void SaveAs(const QString &fileName = QString());
+    void SearchSTIGs();
     void SelectAsset();
     void SelectSTIG();
+    void SetMemoryBudget(int megabytes = -1);
+    void SetSuspendTime(int minutes = -1);
+    Diagnostics* ShowDiagnostics();
     void StatusChange(const QString &status);
     void ShowMessage(const QString &title, const QString &message);
     void SupplementsChanged(int checkState);
+    void SuspendTabs();
+    void TabChanged(int index);
     void UpdateCCIs();
+    void UpdateMemory();
 
-    void Initialize(int max, int val = 0);
-    void Progress(int val);
+    void JobInitialize(int id, int max, int val = 0);
+    void JobProgress(int id, int val);
 
 private:
     Ui::STIGQter *ui;
-    QList<QThread *> threads;
-    QList<Worker *> workers;
+    JobScheduler _scheduler;
+    QHash<int, QPair<int, int>> _jobProgress;
     bool _updatedAssets;
     bool _updatedCCIs;
     bool _updatedSTIGs;
     QString lastSaveLocation;
     QList<QShortcut*> _shortcuts;
+    DbListModel _assetModel;
+    DbListModel _cciModel;
+    DbListModel _stigModel;
+    QSortFilterProxyModel _stigProxy;
+    QTimer _timerMemory;
+    QTimer _timerSuspend;
     void closeEvent(QCloseEvent *event);
-    void CleanThreads();
     void DisableInput();
     void DisplayAssets();
     void DisplayCCIs();
-    void DisplaySTIGs(const QString &search = QString());
+    void DisplaySTIGs();
     void EnableInput();
+    bool SaveChanges();
+    void ShowProgress();
+    QVector<int> SelectedIds(const QAbstractItemView *view);
     void UpdateRemapButton();
     bool _isFiltered;
 };
@@ -33,6 +33,7 @@ TabViewWidget::TabViewWidget(QWidget *parent) : QWidget(parent),
 {
     connect(this, SIGNAL(CloseTab(int)), _parent, SLOT(CloseTab(int)));
     connect(this, SIGNAL(RenameTab(int, QString)), _parent, SLOT(RenameTab(int, QString)));
+    _lastViewed.start();
 }
 
 /**
@@ -48,7 +49,7 @@ void TabViewWidget::SetTabIndex(int index)
 
 /**
  * @brief TabViewWidget::GetTabType
- * @return What type of tab this is (main, Asset, or STIG)
+ * @return What type of tab this is (main, Asset, STIG, or search)
  */
 TabType TabViewWidget::GetTabType()
 {
@@ -73,6 +74,56 @@ void TabViewWidget::EnableInput()
 {
 }
 
+/**
+ * @brief TabViewWidget::SaveChanges
+ * @return @c True when all of the tab's changes are in the database.
+ *
+ * Override this function to write changes the tab has not yet saved
+ */
+bool TabViewWidget::SaveChanges()
+{
+    return true;
+}
+
+/**
+ * @brief TabViewWidget::Resume
+ *
+ * Override this function to reload what the tab released when it
+ * was suspended
+ */
+void TabViewWidget::Resume()
+{
+}
+
+/**
+ * @brief TabViewWidget::Suspend
+ *
+ * Override this function to release the memory of a tab that has not
+ * been viewed for a while
+ */
+void TabViewWidget::Suspend()
+{
+}
+
+/**
+ * @brief TabViewWidget::IdleTime
+ * @return The number of milliseconds since the tab was last viewed.
+ */
+qint64 TabViewWidget::IdleTime() const
+{
+    return _lastViewed.elapsed();
+}
+
+/**
+ * @brief TabViewWidget::Viewed
+ *
+ * Record that the user is viewing this tab.
+ */
+void TabViewWidget::Viewed()
+{
+    _lastViewed.restart();
+}
+
 #ifdef USE_TESTS
 /**
  * @brief TabViewWidget::ProcEvents
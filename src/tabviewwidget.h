@@ -20,12 +20,14 @@
 #ifndef TABVIEWWIDGET_H
 #define TABVIEWWIDGET_H
 
+#include <QElapsedTimer>
 #include <QWidget>
 
 #include "stigqter.h"
 
 enum TabType
 {
+    search = 3,
     stig = 2,
     asset = 1,
     root = 0
@@ -40,6 +42,11 @@ public:
     virtual TabType GetTabType();
     virtual void DisableInput();
     virtual void EnableInput();
+    virtual bool SaveChanges();
+    virtual void Resume();
+    virtual void Suspend();
+    qint64 IdleTime() const;
+    void Viewed();
 #ifdef USE_TESTS
     void ProcEvents();
     virtual void RunTests();
@@ -48,6 +55,7 @@ public:
 protected:
     int _tabIndex;
     STIGQter *_parent;
+    QElapsedTimer _lastViewed;
 
 Q_SIGNALS:
     void CloseTab(int);
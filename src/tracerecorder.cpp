@@ -0,0 +1,348 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "tracerecorder.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+#include <algorithm>
+#include <atomic>
+
+/**
+ * @class TraceRecorder
+ * @brief Records timed spans of work for a Chrome/Perfetto timeline.
+ *
+ * Each thread appends its spans to its own buffer, so recording takes
+ * no lock. A buffer is a list of fixed-size chunks; a chunk's events
+ * are never changed once they are counted, so Write() can read them
+ * while the threads keep recording. The file is in the Chrome trace
+ * event format, which chrome://tracing and ui.perfetto.dev open.
+ *
+ * Recording is off until SetEnabled() turns it on, and a @a TraceSpan
+ * costs one atomic read while it is off.
+ */
+
+namespace {
+
+constexpr int chunkSize = 4096; //events per chunk
+constexpr int maxEvents = 4000000; //later events are dropped
+
+struct TraceEvent
+{
+    QString name;
+    const char *category = nullptr;
+    qint64 startNs = 0;
+    qint64 durationNs = 0;
+};
+
+struct TraceChunk
+{
+    TraceEvent events[chunkSize];
+    std::atomic<int> count{0};
+    std::atomic<TraceChunk*> next{nullptr};
+};
+
+struct TraceThread
+{
+    int tid;
+    QString name;
+    TraceChunk *first;
+    TraceChunk *last; //only used by the recording thread
+};
+
+struct Registry
+{
+    ~Registry()
+    {
+        Q_FOREACH (TraceThread *thread, threads)
+        {
+            TraceChunk *chunk = thread->first;
+            while (chunk)
+            {
+                TraceChunk *next = chunk->next;
+                delete chunk;
+                chunk = next;
+            }
+            delete thread;
+        }
+    }
+    QMutex mutex; //guards the list of threads, not their events
+    QVector<TraceThread*> threads;
+};
+
+Registry registry;
+std::atomic<bool> enabled(false);
+std::atomic<int> eventCount(0);
+std::atomic<qint64> since(0);
+thread_local TraceThread *currentThread = nullptr;
+
+const QElapsedTimer& Clock()
+{
+    static QElapsedTimer clock = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock;
+}
+
+TraceThread* RegisterThread()
+{
+    auto *thread = new TraceThread();
+    thread->first = new TraceChunk();
+    thread->last = thread->first;
+    thread->name = QThread::currentThread()->objectName();
+    QMutexLocker lock(&registry.mutex);
+    thread->tid = registry.threads.count() + 1;
+    if (thread->name.isEmpty())
+    {
+        if (QCoreApplication::instance() && (QThread::currentThread() == QCoreApplication::instance()->thread()))
+            thread->name = QStringLiteral("Main");
+        else
+            thread->name = QStringLiteral("Thread ") + QString::number(thread->tid);
+    }
+    registry.threads.append(thread);
+    return thread;
+}
+
+}
+
+/**
+ * @brief TraceRecorder::Count
+ * @return The number of spans recorded since the last Reset().
+ */
+int TraceRecorder::Count()
+{
+    int ret = 0;
+    qint64 start = since;
+    QVector<TraceThread*> threads;
+    {
+        QMutexLocker lock(&registry.mutex);
+        threads = registry.threads;
+    }
+    Q_FOREACH (TraceThread *thread, threads)
+    {
+        for (TraceChunk *chunk = thread->first; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+        {
+            int count = chunk->count.load(std::memory_order_acquire);
+            ret += static_cast<int>(std::count_if(chunk->events, chunk->events + count, [start](const TraceEvent &event) { return event.startNs >= start; }));
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief TraceRecorder::IsEnabled
+ * @return @c True when spans are being recorded.
+ */
+bool TraceRecorder::IsEnabled()
+{
+    return enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief TraceRecorder::Now
+ * @return Nanoseconds since the recorder's clock started.
+ */
+qint64 TraceRecorder::Now()
+{
+    return Clock().nsecsElapsed();
+}
+
+/**
+ * @brief TraceRecorder::Record
+ * @param name
+ * @param category
+ * @param startNs
+ * @param durationNs
+ *
+ * Record that the work @a name started at @a startNs (see Now()) and
+ * took @a durationNs on this thread. The @a category must be a string
+ * literal.
+ */
+void TraceRecorder::Record(const QString &name, const char *category, qint64 startNs, qint64 durationNs)
+{
+    if (eventCount.fetch_add(1, std::memory_order_relaxed) >= maxEvents)
+        return;
+    if (!currentThread)
+        currentThread = RegisterThread();
+    TraceChunk *chunk = currentThread->last;
+    int count = chunk->count.load(std::memory_order_relaxed);
+    if (count == chunkSize)
+    {
+        chunk = new TraceChunk();
+        currentThread->last->next.store(chunk, std::memory_order_release);
+        currentThread->last = chunk;
+        count = 0;
+    }
+    TraceEvent &event = chunk->events[count];
+    event.name = name;
+    event.category = category;
+    event.startNs = startNs;
+    event.durationNs = durationNs;
+    //publish the event to Write()
+    chunk->count.store(count + 1, std::memory_order_release);
+}
+
+/**
+ * @brief TraceRecorder::Reset
+ *
+ * Leave the spans recorded so far out of the next trace. Their
+ * memory is kept, since other threads may be reading it.
+ */
+void TraceRecorder::Reset()
+{
+    since = Now();
+}
+
+/**
+ * @brief TraceRecorder::SetEnabled
+ * @param enable
+ *
+ * Start or stop recording spans.
+ */
+void TraceRecorder::SetEnabled(bool enable)
+{
+    Now(); //start the clock
+    enabled = enable;
+}
+
+/**
+ * @brief TraceRecorder::Write
+ * @param fileName
+ * @return @c True when the trace is written to @a fileName.
+ * Otherwise, @c false.
+ *
+ * Write the recorded spans as Chrome trace event JSON. Each thread is
+ * named so that the pipeline's stages can be told apart.
+ */
+bool TraceRecorder::Write(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly))
+    {
+        Warning(QStringLiteral("Unable to Open File"), "The file " + fileName + " could not be opened for writing.");
+        return false;
+    }
+
+    qint64 pid = QCoreApplication::applicationPid();
+    qint64 start = since;
+    bool first = true;
+    auto writeEvent = [&file, &first](const QJsonObject &event) {
+        if (!first)
+            file.write(",\n");
+        first = false;
+        file.write(QJsonDocument(event).toJson(QJsonDocument::Compact));
+    };
+
+    file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    writeEvent({{QStringLiteral("name"), QStringLiteral("process_name")},
+                {QStringLiteral("ph"), QStringLiteral("M")},
+                {QStringLiteral("pid"), pid},
+                {QStringLiteral("args"), QJsonObject{{QStringLiteral("name"), QCoreApplication::applicationName()}}}});
+    QVector<TraceThread*> threads;
+    {
+        QMutexLocker lock(&registry.mutex);
+        threads = registry.threads;
+    }
+    Q_FOREACH (TraceThread *thread, threads)
+    {
+        writeEvent({{QStringLiteral("name"), QStringLiteral("thread_name")},
+                    {QStringLiteral("ph"), QStringLiteral("M")},
+                    {QStringLiteral("pid"), pid},
+                    {QStringLiteral("tid"), thread->tid},
+                    {QStringLiteral("args"), QJsonObject{{QStringLiteral("name"), thread->name}}}});
+        for (TraceChunk *chunk = thread->first; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+        {
+            int count = chunk->count.load(std::memory_order_acquire);
+            for (int i = 0; i < count; i++)
+            {
+                const TraceEvent &event = chunk->events[i];
+                if (event.startNs < start)
+                    continue;
+                //timestamps are in microseconds
+                writeEvent({{QStringLiteral("name"), event.name},
+                            {QStringLiteral("cat"), QString::fromLatin1(event.category)},
+                            {QStringLiteral("ph"), QStringLiteral("X")},
+                            {QStringLiteral("ts"), static_cast<double>(event.startNs) / 1000.0},
+                            {QStringLiteral("dur"), static_cast<double>(event.durationNs) / 1000.0},
+                            {QStringLiteral("pid"), pid},
+                            {QStringLiteral("tid"), thread->tid}});
+            }
+        }
+    }
+    file.write("\n]}\n");
+    file.close();
+    return file.error() == QFile::NoError;
+}
+
+/**
+ * @class TraceSpan
+ * @brief Records the time from its construction to its destruction
+ * with the @a TraceRecorder.
+ */
+
+/**
+ * @brief TraceSpan::TraceSpan
+ * @param name
+ * @param category
+ *
+ * Main constructor. The @a category must be a string literal.
+ */
+TraceSpan::TraceSpan(const QString &name, const char *category) :
+    _category(category),
+    _start(-1)
+{
+    if (TraceRecorder::IsEnabled())
+    {
+        _name = name;
+        _start = TraceRecorder::Now();
+    }
+}
+
+/**
+ * @brief TraceSpan::~TraceSpan
+ *
+ * Record the span.
+ */
+TraceSpan::~TraceSpan()
+{
+    End();
+}
+
+/**
+ * @brief TraceSpan::End
+ *
+ * Record the span now rather than when it is destructed.
+ */
+void TraceSpan::End()
+{
+    if (_start >= 0)
+        TraceRecorder::Record(_name, _category, _start, TraceRecorder::Now() - _start);
+    _start = -1;
+}
@@ -0,0 +1,51 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QString>
+
+class TraceRecorder
+{
+public:
+    static int Count();
+    static bool IsEnabled();
+    static qint64 Now();
+    static void Record(const QString &name, const char *category, qint64 startNs, qint64 durationNs);
+    static void Reset();
+    static void SetEnabled(bool enable);
+    static bool Write(const QString &fileName);
+};
+
+class TraceSpan
+{
+public:
+    TraceSpan(const TraceSpan &span) = delete;
+    explicit TraceSpan(const QString &name, const char *category = "worker");
+    ~TraceSpan();
+    void End();
+
+private:
+    QString _name;
+    const char *_category;
+    qint64 _start;
+};
+
+#endif // TRACERECORDER_H
@@ -0,0 +1,212 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dbmanager.h"
+#include "warningsink.h"
+
+#include <QMutexLocker>
+#include <QStringList>
+
+/**
+ * @class WarningSink
+ * @brief Collects the warnings raised during one background job.
+ *
+ * A job may raise the same warning thousands of times. The sink
+ * keeps each distinct warning (by title and message) once and counts
+ * its occurrences. The first occurrence of each warning is written to
+ * the log in batches, and the job's warnings are reported together
+ * once it finishes.
+ *
+ * While a job runs, its sink is the thread's current sink, and
+ * Warning() adds to it rather than logging and displaying each
+ * warning on its own.
+ */
+
+static thread_local WarningSink *currentSink = nullptr;
+
+/**
+ * @brief WarningSink::WarningSink
+ * @param location
+ * @param batchSize
+ *
+ * Main constructor. The warnings are logged under @a location,
+ * @a batchSize at a time.
+ */
+WarningSink::WarningSink(const QString &location, int batchSize) :
+    _location(location),
+    _batchSize(batchSize),
+    _count(0)
+{
+}
+
+/**
+ * @brief WarningSink::Add
+ * @param title
+ * @param message
+ * @param level
+ *
+ * Record a warning. This is safe to call from any thread.
+ */
+void WarningSink::Add(const QString &title, const QString &message, int level)
+{
+    QVector<QPair<int, QString>> rows;
+    {
+        QMutexLocker lock(&_mutex);
+        _count++;
+        auto key = qMakePair(title, message);
+        auto it = _index.constFind(key);
+        if (it != _index.constEnd())
+        {
+            _entries[it.value()].count++;
+            return;
+        }
+        _index.insert(key, _entries.count());
+        _entries.append({title, message, level, 1});
+        _pending.append(qMakePair(level, title + ": " + message));
+        if (_pending.count() < _batchSize)
+            return;
+        rows.swap(_pending);
+    }
+    //the database is written outside of the lock
+    Flush(rows);
+}
+
+/**
+ * @brief WarningSink::Close
+ *
+ * Write the remaining warnings to the log, including how often the
+ * repeated warnings occurred.
+ */
+void WarningSink::Close()
+{
+    QVector<QPair<int, QString>> rows;
+    {
+        QMutexLocker lock(&_mutex);
+        rows.swap(_pending);
+        Q_FOREACH (const WarningEntry &entry, _entries)
+        {
+            if (entry.count > 1)
+                rows.append(qMakePair(entry.level, entry.title + ": " + entry.message + " (" + QString::number(entry.count) + " times)"));
+        }
+    }
+    Flush(rows);
+}
+
+/**
+ * @brief WarningSink::Count
+ * @return The number of warnings, counting repeats.
+ */
+int WarningSink::Count() const
+{
+    QMutexLocker lock(&_mutex);
+    return _count;
+}
+
+/**
+ * @brief WarningSink::Distinct
+ * @return The number of different warnings.
+ */
+int WarningSink::Distinct() const
+{
+    QMutexLocker lock(&_mutex);
+    return _entries.count();
+}
+
+/**
+ * @brief WarningSink::Entries
+ * @return The different warnings in the order that they were first
+ * raised.
+ */
+QVector<WarningEntry> WarningSink::Entries() const
+{
+    QMutexLocker lock(&_mutex);
+    return _entries;
+}
+
+/**
+ * @brief WarningSink::Summary
+ * @param maxEntries
+ * @return A human-readable report of the warnings that lists at most
+ * @a maxEntries of them.
+ */
+QString WarningSink::Summary(int maxEntries) const
+{
+    QMutexLocker lock(&_mutex);
+    if (_entries.count() == 1)
+    {
+        const WarningEntry &entry = _entries.constFirst();
+        return entry.message + (entry.count > 1 ? " (" + QString::number(entry.count) + " times)" : QString());
+    }
+    QStringList lines;
+    for (int i = 0; (i < _entries.count()) && (i < maxEntries); i++)
+    {
+        const WarningEntry &entry = _entries.at(i);
+        lines.append(entry.title + ": " + entry.message + (entry.count > 1 ? " (" + QString::number(entry.count) + " times)" : QString()));
+    }
+    if (_entries.count() > maxEntries)
+        lines.append("…and " + QString::number(_entries.count() - maxEntries) + " more. See the log for the full list.");
+    return lines.join(QStringLiteral("\n"));
+}
+
+/**
+ * @brief WarningSink::Title
+ * @return The title of the report of the warnings.
+ */
+QString WarningSink::Title() const
+{
+    QMutexLocker lock(&_mutex);
+    if (_entries.count() == 1)
+        return _entries.constFirst().title;
+    return QString::number(_count) + QStringLiteral(" Warnings");
+}
+
+/**
+ * @brief WarningSink::Current
+ * @return The sink of the job running on this thread, or @c nullptr.
+ */
+WarningSink* WarningSink::Current()
+{
+    return currentSink;
+}
+
+/**
+ * @brief WarningSink::SetCurrent
+ * @param sink
+ *
+ * Collect the warnings raised on this thread in @a sink, or stop
+ * collecting them when @a sink is @c nullptr.
+ */
+void WarningSink::SetCurrent(WarningSink *sink)
+{
+    currentSink = sink;
+}
+
+/**
+ * @brief WarningSink::Flush
+ * @param rows
+ *
+ * Write the @a rows to the log in one transaction.
+ */
+void WarningSink::Flush(const QVector<QPair<int, QString>> &rows)
+{
+    if (rows.isEmpty())
+        return;
+    DbManager db;
+    db.LogBatch(_location, rows);
+}
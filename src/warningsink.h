@@ -0,0 +1,64 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WARNINGSINK_H
+#define WARNINGSINK_H
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+struct WarningEntry
+{
+    QString title; /**< category */
+    QString message; /**< key within the category */
+    int level;
+    int count; /**< number of occurrences */
+};
+
+class WarningSink
+{
+public:
+    WarningSink(const WarningSink &sink) = delete;
+    explicit WarningSink(const QString &location = QString(), int batchSize = 500);
+    void Add(const QString &title, const QString &message, int level = 5);
+    void Close();
+    int Count() const;
+    int Distinct() const;
+    QVector<WarningEntry> Entries() const;
+    QString Summary(int maxEntries = 20) const;
+    QString Title() const;
+
+    static WarningSink* Current();
+    static void SetCurrent(WarningSink *sink);
+
+private:
+    void Flush(const QVector<QPair<int, QString>> &rows);
+    mutable QMutex _mutex;
+    QString _location;
+    int _batchSize;
+    int _count;
+    QHash<QPair<QString, QString>, int> _index;
+    QVector<WarningEntry> _entries;
+    QVector<QPair<int, QString>> _pending;
+};
+
+#endif // WARNINGSINK_H
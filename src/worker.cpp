@@ -18,7 +18,7 @@
  */
 
 #include "dbmanager.h"
-#include "stigqter.h"
+#include "memorymonitor.h"
 #include "worker.h"
 
 #include <QThread>
@@ -26,6 +26,17 @@
 /**
  * @class Worker
  * @brief Base abstract class for thread workers
+ *
+ * Workers are run by a @a JobScheduler, which moves them to one of
+ * its threads and calls @a process().
+ *
+ * Long-running workers call Cancelled() between units of work. The
+ * main thread may Cancel() or pause a worker at any time; the worker
+ * stops at its next check, undoes its partial changes, and still
+ * emits finished().
+ *
+ * Workers that hold large amounts of data call WaitForMemory() before
+ * loading more of it.
  */
 
 /**
@@ -34,33 +45,95 @@
  *
  * Default constructor.
  */
-Worker::Worker(QObject *parent) : QObject(parent)
+Worker::Worker(QObject *parent) : QObject(parent),
+    _token(std::make_shared<CancelToken>())
+{
+}
+
+/**
+ * @brief Worker::Cancel
+ *
+ * Ask the worker to stop. This is safe to call from any thread.
+ */
+void Worker::Cancel()
+{
+    _token->cancelled = true;
+}
+
+/**
+ * @brief Worker::IsCancelled
+ * @return @c True when the worker has been asked to stop.
+ */
+bool Worker::IsCancelled() const
+{
+    return _token->cancelled;
+}
+
+/**
+ * @brief Worker::IsPaused
+ * @return @c True when the worker has been asked to wait.
+ */
+bool Worker::IsPaused() const
+{
+    return _token->paused;
+}
+
+/**
+ * @brief Worker::SetPaused
+ * @param paused
+ *
+ * Ask the worker to wait at its next check until it is resumed. This
+ * is safe to call from any thread.
+ */
+void Worker::SetPaused(bool paused)
+{
+    _token->paused = paused;
+}
+
+/**
+ * @brief Worker::ShareCancellation
+ * @param worker
+ *
+ * Follow the cancellation and pause requests of @a worker. This is
+ * used by workers that run other workers as part of their job.
+ */
+void Worker::ShareCancellation(const Worker &worker)
 {
+    _token = worker._token;
 }
 
 /**
- * @brief Worker::ConnectThreads
- * @param thread
- * @param sq
+ * @brief Worker::Cancelled
+ * @return @c True when the worker should stop.
  *
- * Connect the signals and slots and move the worker to the supplied thread.
+ * The check between units of work. While the worker is paused, this
+ * waits until it is resumed or cancelled.
+ */
+bool Worker::Cancelled() const
+{
+    while (_token->paused && !_token->cancelled)
+        QThread::msleep(100);
+    return _token->cancelled;
+}
+
+/**
+ * @brief Worker::WaitForMemory
+ * @return @c True when the process is within its memory budget.
  *
- * Returns the new QThread that the worker is attached to. It is up to the
- * calling entity to clean up the thread.
+ * Back off while the process is over its memory budget so that other
+ * jobs can release memory. The wait ends once the process's memory
+ * stops shrinking for half a second, or when the worker is cancelled.
  */
-[[nodiscard]] QThread* Worker::ConnectThreads(STIGQter *sq)
+bool Worker::WaitForMemory() const
 {
-    QThread *thread = new QThread();
-    this->moveToThread(thread);
-    connect(thread, SIGNAL(started()), this, SLOT(process()));
-    connect(this, SIGNAL(finished()), thread, SLOT(quit()));
-    if (sq)
+    qint64 last = MemoryMonitor::Resident();
+    int stalled = 0;
+    while (MemoryMonitor::OverBudget() && (stalled < 5) && !IsCancelled())
     {
-        connect(thread, SIGNAL(finished()), sq, SLOT(CompletedThread()));
-        connect(this, SIGNAL(initialize(int, int)), sq, SLOT(Initialize(int, int)));
-        connect(this, SIGNAL(progress(int)), sq, SLOT(Progress(int)));
-        connect(this, SIGNAL(updateStatus(QString)), sq, SLOT(StatusChange(QString)));
-        connect(this, SIGNAL(ThrowWarning(QString, QString)), sq, SLOT(ShowMessage(QString, QString)));
+        QThread::msleep(100);
+        qint64 resident = MemoryMonitor::Resident();
+        stalled = (resident < last) ? 0 : stalled + 1;
+        last = resident;
     }
-    return thread;
+    return !MemoryMonitor::OverBudget();
 }
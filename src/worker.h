@@ -20,11 +20,12 @@
 #ifndef WORKER_H
 #define WORKER_H
 
-class STIGQter;
-
-#include <QThread>
+#include <QObject>
 #include <QString>
 
+#include <atomic>
+#include <memory>
+
 class Worker : public QObject
 {
     Q_OBJECT
@@ -32,7 +33,15 @@ class Worker : public QObject
 public:
     explicit Worker(QObject *parent = nullptr);
     virtual void process() = 0;
-    [[nodiscard]] QThread* ConnectThreads(STIGQter *sq = nullptr);
+    void Cancel();
+    bool IsCancelled() const;
+    bool IsPaused() const;
+    void SetPaused(bool paused);
+    void ShareCancellation(const Worker &worker);
+
+protected:
+    bool Cancelled() const;
+    bool WaitForMemory() const;
 
 Q_SIGNALS:
     void initialize(int, int);
@@ -40,6 +49,14 @@ Q_SIGNALS:
     void updateStatus(QString);
     void finished();
     void ThrowWarning(QString title, QString message);
+
+private:
+    struct CancelToken
+    {
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> paused{false};
+    };
+    std::shared_ptr<CancelToken> _token;
 };
 
 #endif // WORKER_H
@@ -17,6 +17,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "cklcache.h"
 #include "common.h"
 #include "dbmanager.h"
 #include "workerassetckl.h"
@@ -132,186 +133,14 @@ void WorkerAssetCKL::process()
 
         Q_EMIT progress(-1);
 
+        //the asset checklist does not include LEGACY_ID attributes
+        CKLCache cache(false);
+
         Q_FOREACH (const STIG &s, stigs)
         {
             Q_EMIT updateStatus("Adding " + PrintSTIG(s) + "…");
             stream.writeStartElement(QStringLiteral("iSTIG"));
-
-            stream.writeStartElement(QStringLiteral("STIG_INFO"));
-
-            stream.writeStartElement(QStringLiteral("SI_DATA"));
-            WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("version")); //SID_NAME
-            WriteXMLEntry(stream, QStringLiteral("SID_DATA"), QString::number(s.version)); //SID_DATA
-            stream.writeEndElement(); //SI_DATA
-
-            stream.writeStartElement(QStringLiteral("SI_DATA"));
-            WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("stigid")); //SID_NAME
-            WriteXMLEntry(stream, QStringLiteral("SID_DATA"), s.benchmarkId); //SID_DATA
-            stream.writeEndElement(); //SI_DATA
-
-            stream.writeStartElement(QStringLiteral("SI_DATA"));
-            WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("description")); //SID_NAME
-            WriteXMLEntry(stream, QStringLiteral("SID_DATA"), s.description); //SID_DATA
-            stream.writeEndElement(); //SI_DATA
-
-            stream.writeStartElement(QStringLiteral("SI_DATA"));
-            WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("filename")); //SID_NAME
-            WriteXMLEntry(stream, QStringLiteral("SID_DATA"), s.fileName); //SID_DATA
-            stream.writeEndElement(); //SI_DATA
-
-            stream.writeStartElement(QStringLiteral("SI_DATA"));
-            WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("releaseinfo")); //SID_NAME
-            WriteXMLEntry(stream, QStringLiteral("SID_DATA"), s.release); //SID_DATA
-            stream.writeEndElement(); //SI_DATA
-
-            stream.writeStartElement(QStringLiteral("SI_DATA"));
-            WriteXMLEntry(stream, QStringLiteral("SID_NAME"), QStringLiteral("title")); //SID_NAME
-            WriteXMLEntry(stream, QStringLiteral("SID_DATA"), s.title); //SID_DATA
-            stream.writeEndElement(); //SI_DATA
-
-            stream.writeEndElement(); //STIG_INFO
-
-            Q_FOREACH (const CKLCheck &cc, _asset.GetCKLChecks(&s))
-            {
-                const STIGCheck sc = cc.GetSTIGCheck();
-                stream.writeStartElement(QStringLiteral("VULN"));
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Vuln_Num")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.vulnNum); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Severity")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), GetSeverity(cc.GetSeverity(), false)); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Group_Title")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.groupTitle); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Rule_ID")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.rule); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Rule_Ver")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.ruleVersion); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Rule_Title")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.title); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Vuln_Discuss")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.vulnDiscussion); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("IA_Controls")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.iaControls); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Check_Content")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.check); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Fix_Text")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.fix); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("False_Positives")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.falsePositives); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("False_Negatives")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.falseNegatives); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Documentable")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), PrintTrueFalse(sc.documentable)); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Mitigations")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.mitigations); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Potential_Impact")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.potentialImpact); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Third_Party_Tools")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.thirdPartyTools); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Mitigation_Control")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.mitigationControl); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Responsibility")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.responsibility); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Security_Override_Guidance")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.severityOverrideGuidance); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Check_Content_Ref")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.checkContentRef); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("Weight")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), QString::number(sc.weight)); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("STIGRef")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), s.title + " :: Version " + QString::number(s.version) + ", " + s.release); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("TargetKey")); //VULN_ATTRIBUTE
-                WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), sc.targetKey); //ATTRIBUTE_DATA
-                stream.writeEndElement(); //STIG_DATA
-
-                Q_FOREACH(CCI cci, sc.GetCCIs())
-                {
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    WriteXMLEntry(stream, QStringLiteral("VULN_ATTRIBUTE"), QStringLiteral("CCI_REF")); //VULN_ATTRIBUTE
-                    WriteXMLEntry(stream, QStringLiteral("ATTRIBUTE_DATA"), PrintCCI(cci)); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-                }
-
-                WriteXMLEntry(stream, QStringLiteral("STATUS"), GetStatus(cc.status, true)); //STATUS
-
-                WriteXMLEntry(stream, QStringLiteral("FINDING_DETAILS"), cc.findingDetails); //FINDING_DETAILS
-
-                WriteXMLEntry(stream, QStringLiteral("COMMENTS"), cc.comments); //COMMENTS
-
-                WriteXMLEntry(stream, QStringLiteral("SEVERITY_OVERRIDE"), GetSeverity(cc.severityOverride, false)); //SEVERITY_OVERRIDE
-
-                WriteXMLEntry(stream, QStringLiteral("SEVERITY_JUSTIFICATION"), cc.severityJustification); //SEVERITY_JUSTIFICATION
-
-                stream.writeEndElement(); //VULN
-            }
-
+            cache.WriteSTIG(stream, s, _asset.GetCKLChecks(&s));
             stream.writeEndElement(); //iSTIG
             Q_EMIT progress(-1);
         }
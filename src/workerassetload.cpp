@@ -0,0 +1,108 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dbmanager.h"
+#include "workerassetload.h"
+
+/**
+ * @class WorkerAssetLoad
+ * @brief Read the STIGs and checks displayed by an @a AssetView in
+ * the background.
+ *
+ * The checks are read in chunks, and each chunk is signaled as soon
+ * as it is read so that the @a AssetView can display it while the
+ * rest are loading.
+ */
+
+/**
+ * @brief WorkerAssetLoad::WorkerAssetLoad
+ * @param parent
+ *
+ * Default Constructor
+ */
+WorkerAssetLoad::WorkerAssetLoad(QObject *parent) : Worker(parent),
+    _loadId(0),
+    _loadSTIGs(true)
+{
+    //the loaded data are queued to the user interface thread
+    qRegisterMetaType<QVector<STIG>>("QVector<STIG>");
+    qRegisterMetaType<QVector<CKLCheckRow>>("QVector<CKLCheckRow>");
+}
+
+/**
+ * @brief WorkerAssetLoad::AddAsset
+ * @param asset
+ *
+ * The asset to load
+ */
+void WorkerAssetLoad::AddAsset(const Asset &asset)
+{
+    _asset = asset;
+}
+
+/**
+ * @brief WorkerAssetLoad::SetLoadId
+ * @param loadId
+ *
+ * Every signal of this worker includes the @a loadId so that the
+ * receiver can ignore the results of a load it has replaced.
+ */
+void WorkerAssetLoad::SetLoadId(int loadId)
+{
+    _loadId = loadId;
+}
+
+/**
+ * @brief WorkerAssetLoad::SetLoadSTIGs
+ * @param loadSTIGs
+ *
+ * When @a loadSTIGs is @c false, only the checks are loaded.
+ */
+void WorkerAssetLoad::SetLoadSTIGs(bool loadSTIGs)
+{
+    _loadSTIGs = loadSTIGs;
+}
+
+/**
+ * @brief WorkerAssetLoad::process
+ *
+ * Read the STIG list and each chunk of the @a Asset's checks.
+ */
+void WorkerAssetLoad::process()
+{
+    DbManager db;
+    if (_loadSTIGs)
+        Q_EMIT STIGsLoaded(_loadId, db.GetSTIGs(), db.GetSTIGs(_asset));
+
+    const int chunkSize = 500;
+    int lastId = -1;
+    QVector<CKLCheckRow> rows;
+    do
+    {
+        rows = db.GetCKLCheckRows(_asset, lastId, chunkSize);
+        if (!rows.isEmpty())
+        {
+            lastId = rows.constLast().id;
+            Q_EMIT ChecksLoaded(_loadId, rows);
+        }
+    } while (rows.count() == chunkSize);
+
+    Q_EMIT Loaded(_loadId);
+    Q_EMIT finished();
+}
@@ -0,0 +1,55 @@
+/*
+ * STIGQter - STIG fun with Qt
+ *
+ * Copyright © 2020 Jon Hood, http://www.hoodsecurity.com/
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORKERASSETLOAD_H
+#define WORKERASSETLOAD_H
+
+#include "asset.h"
+#include "cklcheck.h"
+#include "stig.h"
+#include "worker.h"
+
+#include <QObject>
+#include <QVector>
+
+class WorkerAssetLoad : public Worker
+{
+    Q_OBJECT
+
+private:
+    Asset _asset;
+    int _loadId;
+    bool _loadSTIGs;
+
+public:
+    explicit WorkerAssetLoad(QObject *parent = nullptr);
+    void AddAsset(const Asset &asset);
+    void SetLoadId(int loadId);
+    void SetLoadSTIGs(bool loadSTIGs);
+
+public Q_SLOTS:
+    void process();
+
+Q_SIGNALS:
+    void STIGsLoaded(int loadId, QVector<STIG> stigs, QVector<STIG> assetSTIGs);
+    void ChecksLoaded(int loadId, QVector<CKLCheckRow> rows);
+    void Loaded(int loadId);
+};
+
+#endif // WORKERASSETLOAD_H
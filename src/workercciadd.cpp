@@ -39,6 +39,9 @@
  *
  * This class indexes @a Family and @a Control information from NIST,
  * and it indexes @a CCI information from DISA.
+ *
+ * The CCIs are only imported into a database without them, so a
+ * cancelled import clears them again.
  */
 
 /**
@@ -51,6 +54,23 @@ WorkerCCIAdd::WorkerCCIAdd(QObject *parent) : Worker(parent)
 {
 }
 
+/**
+ * @brief WorkerCCIAdd::RollBack
+ *
+ * Remove the @a Families, @a Controls, and @a CCIs that this worker
+ * added so that a cancelled import leaves the database as it was,
+ * then finish the worker.
+ */
+void WorkerCCIAdd::RollBack()
+{
+    Q_EMIT updateStatus(QStringLiteral("Removing the CCIs that were imported…"));
+    DbManager db;
+    db.DelayCommit(false);
+    db.DeleteCCIs();
+    Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+    Q_EMIT finished();
+}
+
 /**
  * @brief WorkerCCIAdd::process
  *
@@ -59,6 +79,9 @@ WorkerCCIAdd::WorkerCCIAdd(QObject *parent) : Worker(parent)
  * @li Download and parse the NIST RMF information.
  * @li Download and parse the cyber.mil CCI information.
  * @endlist
+ *
+ * The import stops between steps, and within each step's loop, when
+ * it is cancelled.
  */
 void WorkerCCIAdd::process()
 {
@@ -81,7 +104,7 @@ void WorkerCCIAdd::process()
     auto *xml = new QXmlStreamReader(rmf);
     QList<QString> todo;
     db.DelayCommit(true);
-    while (!xml->atEnd() && !xml->hasError())
+    while (!xml->atEnd() && !xml->hasError() && !Cancelled())
     {
         xml->readNext();
         if (xml->isStartElement() && (xml->name() == "a"))
@@ -112,6 +135,11 @@ void WorkerCCIAdd::process()
     db.DelayCommit(false);
     Q_EMIT initialize(todo.size() + 959, 1); //# of base controls: 958
     delete xml;
+    if (IsCancelled())
+    {
+        RollBack();
+        return;
+    }
 
     //Step 3a: Additional Privacy Controls
     //obtained from https://nvlpubs.nist.gov/nistpubs/SpecialPublications/NIST.SP.800-53r4.pdf contents
@@ -131,7 +159,7 @@ void WorkerCCIAdd::process()
     QString title;
     QString description;
     bool inStatement = false;
-    while (!xml->atEnd() && !xml->hasError())
+    while (!xml->atEnd() && !xml->hasError() && !Cancelled())
     {
         xml->readNext();
         if (xml->isStartElement())
@@ -173,6 +201,12 @@ void WorkerCCIAdd::process()
             }
         }
     }
+    delete xml;
+    if (IsCancelled())
+    {
+        RollBack();
+        return;
+    }
     if (!control.isEmpty())
         db.AddControl(control, title, description);
 
@@ -236,10 +270,12 @@ void WorkerCCIAdd::process()
     QList<CCI> toAdd;
     Q_FOREACH (const QByteArray &xmlFile, xmlFiles)
     {
+        if (IsCancelled())
+            break;
         xml = new QXmlStreamReader(xmlFile);
         QString cci = QString();
         QString definition = QString();
-        while (!xml->atEnd() && !xml->hasError())
+        while (!xml->atEnd() && !xml->hasError() && !Cancelled())
         {
             xml->readNext();
             if (xml->isStartElement())
@@ -305,18 +341,30 @@ void WorkerCCIAdd::process()
         delete xml;
     }
     QFile::remove(tmpFile.fileName());
+    if (IsCancelled())
+    {
+        RollBack();
+        return;
+    }
 
     //Step 7: add CCIs
     Q_EMIT initialize(toAdd.size() + 1, 1);
     db.DelayCommit(true);
     Q_FOREACH (const CCI &c, toAdd)
     {
+        if (Cancelled())
+            break;
         CCI tmpCCI = c;
         Q_EMIT updateStatus("Adding CCI-" + QString::number(c.cci) + "…");
         db.AddCCI(tmpCCI);
         Q_EMIT progress(-1);
     }
     db.DelayCommit(false);
+    if (IsCancelled())
+    {
+        RollBack();
+        return;
+    }
 
     //complete
     Q_EMIT updateStatus(QStringLiteral("Done!"));
@@ -28,6 +28,9 @@ class WorkerCCIAdd : public Worker
 {
     Q_OBJECT
 
+private:
+    void RollBack();
+
 public:
     explicit WorkerCCIAdd(QObject *parent = nullptr);
 
@@ -17,8 +17,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "cklcache.h"
 #include "common.h"
 #include "dbmanager.h"
+#include "tracerecorder.h"
 #include "workercklexport.h"
 
 #include <QDir>
@@ -72,11 +74,19 @@ void WorkerCKLExport::process()
     DbManager db;
     auto assets = db.GetAssets();
     Q_EMIT initialize(assets.count(), 0);
+    //the STIG-specific portions of each checklist are only serialized once
+    CKLCache cache;
     Q_FOREACH (Asset a, assets)
     {
+        if (Cancelled())
+            break;
         Q_EMIT updateStatus("Exporting CKLs for " + PrintAsset(a));
         Q_FOREACH (STIG s, a.GetSTIGs())
         {
+            //each checklist is either written in full or not started
+            if (Cancelled())
+                break;
+            TraceSpan span(QStringLiteral("write CKL"), "io");
             Q_EMIT updateStatus("Exporting CKL " + PrintSTIG(s) + " for " + PrintAsset(a));
             QString fileName = QDir(_dirName).filePath(PrintAsset(a) + "_" + SanitizeFile(s.title) + "_V" + QString::number(s.version) + "R" + QString::number(GetReleaseNumber(s.release)) + ".ckl");
             if (QFile::exists(fileName))
@@ -131,322 +141,7 @@ void WorkerCKLExport::process()
                 stream.writeStartElement(QStringLiteral("STIGS"));
 
                 stream.writeStartElement(QStringLiteral("iSTIG"));
-                stream.writeStartElement(QStringLiteral("STIG_INFO"));
-
-                stream.writeStartElement(QStringLiteral("SI_DATA"));
-                stream.writeStartElement(QStringLiteral("SID_NAME"));
-                stream.writeCharacters(QStringLiteral("version"));
-                stream.writeEndElement(); //SID_NAME
-                stream.writeStartElement(QStringLiteral("SID_DATA"));
-                stream.writeCharacters(QString::number(s.version));
-                stream.writeEndElement(); //SID_DATA
-                stream.writeEndElement(); //SI_DATA
-
-                stream.writeStartElement(QStringLiteral("SI_DATA"));
-                stream.writeStartElement(QStringLiteral("SID_NAME"));
-                stream.writeCharacters(QStringLiteral("stigid"));
-                stream.writeEndElement(); //SID_NAME
-                stream.writeStartElement(QStringLiteral("SID_DATA"));
-                stream.writeCharacters(s.benchmarkId);
-                stream.writeEndElement(); //SID_DATA
-                stream.writeEndElement(); //SI_DATA
-
-                stream.writeStartElement(QStringLiteral("SI_DATA"));
-                stream.writeStartElement(QStringLiteral("SID_NAME"));
-                stream.writeCharacters(QStringLiteral("description"));
-                stream.writeEndElement(); //SID_NAME
-                stream.writeStartElement(QStringLiteral("SID_DATA"));
-                stream.writeCharacters(s.description);
-                stream.writeEndElement(); //SID_DATA
-                stream.writeEndElement(); //SI_DATA
-
-                stream.writeStartElement(QStringLiteral("SI_DATA"));
-                stream.writeStartElement(QStringLiteral("SID_NAME"));
-                stream.writeCharacters(QStringLiteral("filename"));
-                stream.writeEndElement(); //SID_NAME
-                stream.writeStartElement(QStringLiteral("SID_DATA"));
-                stream.writeCharacters(s.fileName);
-                stream.writeEndElement(); //SID_DATA
-                stream.writeEndElement(); //SI_DATA
-
-                stream.writeStartElement(QStringLiteral("SI_DATA"));
-                stream.writeStartElement(QStringLiteral("SID_NAME"));
-                stream.writeCharacters(QStringLiteral("releaseinfo"));
-                stream.writeEndElement(); //SID_NAME
-                stream.writeStartElement(QStringLiteral("SID_DATA"));
-                stream.writeCharacters(s.release);
-                stream.writeEndElement(); //SID_DATA
-                stream.writeEndElement(); //SI_DATA
-
-                stream.writeStartElement(QStringLiteral("SI_DATA"));
-                stream.writeStartElement(QStringLiteral("SID_NAME"));
-                stream.writeCharacters(QStringLiteral("title"));
-                stream.writeEndElement(); //SID_NAME
-                stream.writeStartElement(QStringLiteral("SID_DATA"));
-                stream.writeCharacters(s.title);
-                stream.writeEndElement(); //SID_DATA
-                stream.writeEndElement(); //SI_DATA
-
-                stream.writeEndElement(); //STIG_INFO
-
-                Q_FOREACH (const CKLCheck &cc, a.GetCKLChecks(&s))
-                {
-                    const STIGCheck sc = cc.GetSTIGCheck();
-                    stream.writeStartElement(QStringLiteral("VULN"));
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Vuln_Num"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.vulnNum);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Severity"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(GetSeverity(cc.GetSeverity(), false));
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Group_Title"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.groupTitle);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Rule_ID"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.rule);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Rule_Ver"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.ruleVersion);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Rule_Title"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.title);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Vuln_Discuss"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.vulnDiscussion);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("IA_Controls"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.iaControls);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Check_Content"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.check);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Fix_Text"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.fix);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("False_Positives"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.falsePositives);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("False_Negatives"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.falseNegatives);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Documentable"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(PrintTrueFalse(sc.documentable));
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Mitigations"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.mitigations);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Potential_Impact"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.potentialImpact);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Third_Party_Tools"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.thirdPartyTools);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Mitigation_Control"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.mitigationControl);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Responsibility"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.responsibility);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Security_Override_Guidance"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.severityOverrideGuidance);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Check_Content_Ref"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.checkContentRef);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("Weight"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(QString::number(sc.weight));
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("STIGRef"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(s.title + " :: Version " + QString::number(s.version) + ", " + s.release);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                    stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                    stream.writeCharacters(QStringLiteral("TargetKey"));
-                    stream.writeEndElement(); //VULN_ATTRIBUTE
-                    stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                    stream.writeCharacters(sc.targetKey);
-                    stream.writeEndElement(); //ATTRIBUTE_DATA
-                    stream.writeEndElement(); //STIG_DATA
-
-                    Q_FOREACH (CCI cci, sc.GetCCIs())
-                    {
-                        stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                        stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                        stream.writeCharacters(QStringLiteral("CCI_REF"));
-                        stream.writeEndElement(); //VULN_ATTRIBUTE
-                        stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                        stream.writeCharacters(PrintCCI(cci));
-                        stream.writeEndElement(); //ATTRIBUTE_DATA
-                        stream.writeEndElement(); //STIG_DATA
-                    }
-
-                    Q_FOREACH (QString legacyId, sc.legacyIds)
-                    {
-                        stream.writeStartElement(QStringLiteral("STIG_DATA"));
-                        stream.writeStartElement(QStringLiteral("VULN_ATTRIBUTE"));
-                        stream.writeCharacters(QStringLiteral("LEGACY_ID"));
-                        stream.writeEndElement(); //VULN_ATTRIBUTE
-                        stream.writeStartElement(QStringLiteral("ATTRIBUTE_DATA"));
-                        stream.writeCharacters(legacyId);
-                        stream.writeEndElement(); //ATTRIBUTE_DATA
-                        stream.writeEndElement(); //STIG_DATA
-                    }
-
-                    stream.writeStartElement(QStringLiteral("STATUS"));
-                    stream.writeCharacters(GetStatus(cc.status, true));
-                    stream.writeEndElement(); //STATUS
-
-                    stream.writeStartElement(QStringLiteral("FINDING_DETAILS"));
-                    stream.writeCharacters(cc.findingDetails);
-                    stream.writeEndElement(); //FINDING_DETAILS
-
-                    stream.writeStartElement(QStringLiteral("COMMENTS"));
-                    stream.writeCharacters(cc.comments);
-                    stream.writeEndElement(); //COMMENTS
-
-                    stream.writeStartElement(QStringLiteral("SEVERITY_OVERRIDE"));
-                    stream.writeCharacters(GetSeverity(cc.severityOverride, false));
-                    stream.writeEndElement(); //SEVERITY_OVERRIDE
-
-                    stream.writeStartElement(QStringLiteral("SEVERITY_JUSTIFICATION"));
-                    stream.writeCharacters(cc.severityJustification);
-                    stream.writeEndElement(); //SEVERITY_JUSTIFICATION
-
-                    stream.writeEndElement(); //VULN
-                }
+                cache.WriteSTIG(stream, s, a.GetCKLChecks(&s));
                 stream.writeEndElement(); //iSTIG
                 stream.writeEndElement(); //STIGS
                 stream.writeEndElement(); //CHECKLIST
@@ -455,6 +150,6 @@ void WorkerCKLExport::process()
         }
         Q_EMIT progress(-1);
     }
-    Q_EMIT updateStatus(QStringLiteral("Done!"));
+    Q_EMIT updateStatus(IsCancelled() ? QStringLiteral("Cancelled.") : QStringLiteral("Done!"));
     Q_EMIT finished();
 }
@@ -20,6 +20,7 @@
 #include "asset.h"
 #include "cklcheck.h"
 #include "dbmanager.h"
+#include "tracerecorder.h"
 #include "workercklimport.h"
 
 #include <QFile>
@@ -46,6 +47,7 @@
  */
 void WorkerCKLImport::ParseCKL(const QString &fileName)
 {
+    TraceSpan span(QStringLiteral("parse CKL"), "parse");
     QFile f(fileName);
     if (!f.open(QFile::ReadOnly | QFile::Text))
     {
@@ -88,7 +90,8 @@ void WorkerCKLImport::ParseCKL(const QString &fileName)
                     else
                     {
                         Q_EMIT updateStatus("Adding " + PrintSTIG(tmpSTIG) + " to " + PrintAsset(a) + "…");
-                        db.AddSTIGToAsset(tmpSTIG, a);
+                        if (db.AddSTIGToAsset(tmpSTIG, a))
+                            _addedSTIGs.append(qMakePair(tmpSTIG, a));
                         db.DelayCommit(true);
                         Q_FOREACH (CKLCheck c, checks)
                         {
@@ -211,7 +214,8 @@ void WorkerCKLImport::ParseCKL(const QString &fileName)
         Q_EMIT ThrowWarning(QStringLiteral("Asset already has STIG applied!"), "The asset " + PrintAsset(a) + " already has the STIG " + PrintSTIG(tmpSTIG) + " applied.");
         return;
     }
-    db.AddSTIGToAsset(tmpSTIG, a);
+    if (db.AddSTIGToAsset(tmpSTIG, a))
+        _addedSTIGs.append(qMakePair(tmpSTIG, a));
     db.DelayCommit(true);
     Q_FOREACH (CKLCheck c, checks)
     {
@@ -236,11 +240,30 @@ Asset WorkerCKLImport::CheckAsset(Asset &a)
     Asset tmpAsset = db.GetAsset(a.hostName);
     if (tmpAsset.id > 0)
         a = tmpAsset;
-    else
-        db.AddAsset(a);
+    else if (db.AddAsset(a))
+        _addedAssets.append(a);
     return a;
 }
 
+/**
+ * @brief WorkerCKLImport::RollBack
+ *
+ * Remove the checklists and @a Assets that this worker added so that
+ * a cancelled import leaves the database as it was.
+ */
+void WorkerCKLImport::RollBack()
+{
+    Q_EMIT updateStatus(QStringLiteral("Removing the checklists that were imported…"));
+    DbManager db;
+    while (!_addedSTIGs.isEmpty())
+    {
+        auto added = _addedSTIGs.takeLast();
+        db.DeleteSTIGFromAsset(added.first, added.second);
+    }
+    while (!_addedAssets.isEmpty())
+        db.DeleteAsset(_addedAssets.takeLast());
+}
+
 /**
  * @brief WorkerCKLImport::WorkerCKLImport
  * @param parent
@@ -272,10 +295,18 @@ void WorkerCKLImport::process()
     Q_EMIT initialize(_fileNames.count(), 0);
     Q_FOREACH(const QString fileName, _fileNames)
     {
+        if (Cancelled())
+            break;
         Q_EMIT updateStatus("Parsing " + fileName);
         ParseCKL(fileName);
         Q_EMIT progress(-1);
     }
-    Q_EMIT updateStatus(QStringLiteral("Done!"));
+    if (IsCancelled())
+    {
+        RollBack();
+        Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+    }
+    else
+        Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
 }
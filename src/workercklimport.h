@@ -21,9 +21,12 @@
 #define WORKERCKLIMPORT_H
 
 #include "asset.h"
+#include "stig.h"
 #include "worker.h"
 
 #include <QObject>
+#include <QPair>
+#include <QVector>
 
 class WorkerCKLImport : public Worker
 {
@@ -31,8 +34,11 @@ class WorkerCKLImport : public Worker
 
 private:
     QStringList _fileNames;
+    QVector<Asset> _addedAssets;
+    QVector<QPair<STIG, Asset>> _addedSTIGs;
     void ParseCKL(const QString &fileName);
     Asset CheckAsset(Asset &a);
+    void RollBack();
 
 public:
     explicit WorkerCKLImport(QObject *parent = nullptr);
@@ -20,20 +20,33 @@
 #include "asset.h"
 #include "common.h"
 #include "dbmanager.h"
+#include "memorymonitor.h"
 #include "stig.h"
 #include "stigcheck.h"
 #include "workercmrsexport.h"
 
+#include <QBuffer>
 #include <QDateTime>
 #include <QFile>
+#include <QHash>
+#include <QPair>
 #include <QXmlStreamWriter>
 
+#include <algorithm>
+
+#include <zlib.h>
+
 /**
  * @class WorkerCMRSExport
  * @brief Export a CMRS file of the results of the system.
  *
  * Continuous Monitoring and Risk Scoring (CMRS) formats foster
  * compliance with the continuous monitoring stage of RMF systems.
+ *
+ * The report is streamed to disk in chunks so that large enclaves
+ * can be exported in constant memory. When the output file name ends
+ * in ".gz", the report is gzip-compressed as it is written. A
+ * cancelled export removes the partial report.
  */
 
 /**
@@ -60,22 +73,42 @@ void WorkerCMRSExport::SetExportPath(const QString &fileName)
 /**
  * @brief WorkerCMRSExport::process
  *
- * Using the provided output directory of SetExportDir(), generate
+ * Using the provided output file of SetExportPath(), generate
  * every combination of @a Asset ↔ @a STIG mapping stored in the
- * database and build the CKL file for that mapping.
+ * database and write the findings of that mapping.
+ *
+ * The @a Assets and the findings of each mapping are read in chunks
+ * ordered by ID, and only the rule and vulnerability number of each
+ * @a STIGCheck are loaded, once per @a STIG instead of once per
+ * finding. The chunks shrink as the memory budget runs out, and each
+ * chunk of findings is tracked until it has been written out.
  */
 void WorkerCMRSExport::process()
 {
     DbManager db;
-    QVector<Asset> assets = db.GetAssets();
-    Q_EMIT initialize(assets.count(), 0);
+    Q_EMIT initialize(db.GetAssetCount(), 0);
 
     Q_EMIT updateStatus(QStringLiteral("Preparing Data…"));
 
+    //compress the output on the fly when a .gz file is requested
+    bool compress = _fileName.endsWith(QStringLiteral(".gz"), Qt::CaseInsensitive);
+    gzFile gz = compress ? gzopen(_fileName.toStdString().c_str(), "wb") : nullptr;
     QFile file(_fileName); //open the output file
-    if (file.open(QIODevice::WriteOnly))
+    if (compress ? (gz != nullptr) : file.open(QIODevice::WriteOnly))
     {
-        QXmlStreamWriter stream(&file); //write to the stream as an XML file
+        //the XML is built in a small buffer that is regularly written out
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        auto flush = [&buffer, &file, gz]() {
+            if (gz)
+                gzwrite(gz, buffer.data().constData(), static_cast<unsigned int>(buffer.data().size()));
+            else
+                file.write(buffer.data());
+            buffer.buffer().clear();
+            buffer.seek(0);
+        };
+
+        QXmlStreamWriter stream(&buffer); //write to the stream as an XML file
         stream.writeStartDocument(QStringLiteral("1.0"));
         stream.writeComment("STIGQter :: " + VERSION);
         stream.writeStartElement(QStringLiteral("IMPORT_FILE"));
@@ -84,124 +117,195 @@ void WorkerCMRSExport::process()
         QString curDate = QDateTime::currentDateTime().toTimeSpec(Qt::OffsetFromUTC).toString(Qt::ISODate); //current UTC time
         QString elementKey = QStringLiteral("0"); //doesn't make sense for target keys to be at this level
 
-        Q_FOREACH (Asset a, assets)
-        {
-            Q_EMIT updateStatus("Adding " + PrintAsset(a));
-
-            stream.writeStartElement(QStringLiteral("ASSET"));
-
-            stream.writeStartElement(QStringLiteral("ASSET_TS"));
-            stream.writeCharacters(curDate); //current UTC time
-            stream.writeEndElement(); //ASSET_TS
+        //rule and CMRS vulnerability ID of each STIGCheck, keyed by STIG and STIGCheck ID
+        QHash<int, QHash<int, QPair<QString, QString>>> stigChecks;
 
-            stream.writeStartElement(QStringLiteral("ASSET_ID")); //(ASSET NAME)
-            stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("ASSET NAME"));
-            stream.writeCharacters(a.hostName);
-            stream.writeEndElement(); //ASSET_ID (ASSET NAME)
-
-            stream.writeStartElement(QStringLiteral("ASSET_ID")); //(MAC ADDRESS)
-            stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("MAC ADDRESS"));
-            stream.writeCharacters(a.hostMAC);
-            stream.writeEndElement(); //ASSET_ID (MAC ADDRESS)
+        //the assets are read in pages ordered by ID
+        int lastAssetId = 0;
+        int assetLimit;
+        QVector<Asset> assets;
+        do
+        {
+            assetLimit = MemoryMonitor::ChunkSize(1024, 100, 10);
+            assets = db.GetAssets(QStringLiteral("WHERE Asset.id IN (SELECT id FROM Asset WHERE id > :id ORDER BY id LIMIT :limit)"),
+                                  {
+                                      std::make_tuple<QString, QVariant>(QStringLiteral(":id"), lastAssetId),
+                                      std::make_tuple<QString, QVariant>(QStringLiteral(":limit"), assetLimit)
+                                  });
+            Q_FOREACH (const Asset &a, assets)
+            {
+                if (Cancelled())
+                    break;
+                lastAssetId = std::max(lastAssetId, a.id);
+                Q_EMIT updateStatus("Adding " + PrintAsset(a));
 
-            stream.writeStartElement(QStringLiteral("ASSET_ID")); //(IP ADDRESS)
-            stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("IP ADDRESS"));
-            stream.writeCharacters(a.hostIP);
-            stream.writeEndElement(); //ASSET_ID (IP ADDRESS)
+                stream.writeStartElement(QStringLiteral("ASSET"));
 
-            stream.writeStartElement(QStringLiteral("ASSET_ID")); //(FQDN)
-            stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("FQDN"));
-            stream.writeCharacters(a.hostFQDN);
-            stream.writeEndElement(); //ASSET_ID (FQDN)
+                stream.writeStartElement(QStringLiteral("ASSET_TS"));
+                stream.writeCharacters(curDate); //current UTC time
+                stream.writeEndElement(); //ASSET_TS
 
-            stream.writeStartElement(QStringLiteral("ASSET_ID")); //(TechArea)
-            stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("TechArea"));
-            stream.writeCharacters(a.techArea);
-            stream.writeEndElement(); //ASSET_ID (TechArea)
+                stream.writeStartElement(QStringLiteral("ASSET_ID")); //(ASSET NAME)
+                stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("ASSET NAME"));
+                stream.writeCharacters(a.hostName);
+                stream.writeEndElement(); //ASSET_ID (ASSET NAME)
 
-            stream.writeStartElement(QStringLiteral("ASSET_TYPE"));
+                stream.writeStartElement(QStringLiteral("ASSET_ID")); //(MAC ADDRESS)
+                stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("MAC ADDRESS"));
+                stream.writeCharacters(a.hostMAC);
+                stream.writeEndElement(); //ASSET_ID (MAC ADDRESS)
 
-            stream.writeStartElement(QStringLiteral("ASSET_TYPE_KEY"));
-            stream.writeCharacters(a.assetType.startsWith(QStringLiteral("Computing")) ? QStringLiteral("1") : QStringLiteral("2"));
-            stream.writeEndElement(); //ASSET_TYPE_KEY
+                stream.writeStartElement(QStringLiteral("ASSET_ID")); //(IP ADDRESS)
+                stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("IP ADDRESS"));
+                stream.writeCharacters(a.hostIP);
+                stream.writeEndElement(); //ASSET_ID (IP ADDRESS)
 
-            stream.writeEndElement(); //ASSET_TYPE
+                stream.writeStartElement(QStringLiteral("ASSET_ID")); //(FQDN)
+                stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("FQDN"));
+                stream.writeCharacters(a.hostFQDN);
+                stream.writeEndElement(); //ASSET_ID (FQDN)
 
-            stream.writeStartElement(QStringLiteral("ELEMENT"));
+                stream.writeStartElement(QStringLiteral("ASSET_ID")); //(TechArea)
+                stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("TechArea"));
+                stream.writeCharacters(a.techArea);
+                stream.writeEndElement(); //ASSET_ID (TechArea)
 
-            stream.writeStartElement(QStringLiteral("ELEMENT_KEY"));
-            stream.writeCharacters(elementKey);
-            stream.writeEndElement(); //ELEMENT_KEY
+                stream.writeStartElement(QStringLiteral("ASSET_TYPE"));
 
-            stream.writeEndElement(); //ELEMENT
+                stream.writeStartElement(QStringLiteral("ASSET_TYPE_KEY"));
+                stream.writeCharacters(a.assetType.startsWith(QStringLiteral("Computing")) ? QStringLiteral("1") : QStringLiteral("2"));
+                stream.writeEndElement(); //ASSET_TYPE_KEY
 
-            Q_FOREACH (STIG s, a.GetSTIGs())
-            {
-                stream.writeStartElement(QStringLiteral("TARGET"));
+                stream.writeEndElement(); //ASSET_TYPE
 
-                stream.writeStartElement(QStringLiteral("TARGET_ID"));
-                stream.writeCharacters(s.benchmarkId);
-                stream.writeEndElement(); //TARGET_ID
+                stream.writeStartElement(QStringLiteral("ELEMENT"));
 
-                stream.writeStartElement(QStringLiteral("TARGET_KEY"));
+                stream.writeStartElement(QStringLiteral("ELEMENT_KEY"));
                 stream.writeCharacters(elementKey);
-                stream.writeEndElement(); //TARGET_KEY
-
-                Q_FOREACH (CKLCheck c, a.GetCKLChecks(&s))
-                {
-                    STIGCheck sc = c.GetSTIGCheck();
-
-                    stream.writeStartElement(QStringLiteral("FINDING"));
+                stream.writeEndElement(); //ELEMENT_KEY
 
-                    stream.writeStartElement(QStringLiteral("FINDING_ID"));
-                    stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("VK"));
-                    stream.writeAttribute(QStringLiteral("ID"), sc.rule);
-                    stream.writeCharacters(PrintCMRSVulnId(sc));
-                    stream.writeEndElement(); //FINDING_ID
+                stream.writeEndElement(); //ELEMENT
 
-                    stream.writeStartElement(QStringLiteral("FINDING_STATUS"));
-                    stream.writeCharacters(GetCMRSStatus(c.status));
-                    stream.writeEndElement(); //FINDING_STATUS
-
-                    stream.writeStartElement(QStringLiteral("FINDING_DETAILS"));
-                    stream.writeAttribute(QStringLiteral("OVERRIDE"), QStringLiteral("O"));
-                    stream.writeCharacters(c.findingDetails);
-                    stream.writeEndElement(); //FINDING_DETAILS
-
-                    stream.writeStartElement(QStringLiteral("SCRIPT_RESULTS"));
-                    stream.writeEndElement(); //SCRIPT_RESULTS
-
-                    stream.writeStartElement(QStringLiteral("COMMENT"));
-                    stream.writeCharacters(c.comments);
-                    stream.writeEndElement(); //COMMENT
-
-                    stream.writeStartElement(QStringLiteral("TOOL"));
-                    stream.writeCharacters(QStringLiteral("STIGQter"));
-                    stream.writeEndElement(); //TOOL
-
-                    stream.writeStartElement(QStringLiteral("TOOL_VERSION"));
-                    stream.writeCharacters(VERSION);
-                    stream.writeEndElement(); //TOOL_VERSION
-
-                    stream.writeStartElement(QStringLiteral("AUTHENTICATED_FINDING"));
-                    stream.writeCharacters(QStringLiteral("true"));
-                    stream.writeEndElement(); //AUTHENTICATED_FINDING
-
-                    stream.writeEndElement(); //FINDING
+                Q_FOREACH (const STIG &s, db.GetSTIGs(a))
+                {
+                    if (Cancelled())
+                        break;
+                    if (!stigChecks.contains(s.id))
+                    {
+                        QHash<int, QPair<QString, QString>> checks = db.GetSTIGCheckRules(s);
+                        for (auto i = checks.begin(); i != checks.end(); i++)
+                        {
+                            STIGCheck sc;
+                            sc.vulnNum = i.value().second;
+                            i.value().second = PrintCMRSVulnId(sc);
+                        }
+                        stigChecks.insert(s.id, checks);
+                    }
+                    QHash<int, QPair<QString, QString>> checks = stigChecks.value(s.id);
+
+                    stream.writeStartElement(QStringLiteral("TARGET"));
+
+                    stream.writeStartElement(QStringLiteral("TARGET_ID"));
+                    stream.writeCharacters(s.benchmarkId);
+                    stream.writeEndElement(); //TARGET_ID
+
+                    stream.writeStartElement(QStringLiteral("TARGET_KEY"));
+                    stream.writeCharacters(elementKey);
+                    stream.writeEndElement(); //TARGET_KEY
+
+                    //walk the findings of this mapping in chunks
+                    int lastId = 0;
+                    int limit;
+                    QVector<CKLCheck> chunk;
+                    do
+                    {
+                        //a finding (with its details and comments) is rarely more than a few KiB
+                        limit = MemoryMonitor::ChunkSize(4 * 1024, 1000, 50);
+                        chunk = db.GetCKLChecks(QStringLiteral("WHERE CKLCheck.AssetId = :AssetId AND CKLCheck.STIGCheckId IN (SELECT id FROM STIGCheck WHERE STIGId = :STIGId) AND CKLCheck.id > :id ORDER BY CKLCheck.id LIMIT :limit"),
+                                                {
+                                                    std::make_tuple<QString, QVariant>(QStringLiteral(":AssetId"), a.id),
+                                                    std::make_tuple<QString, QVariant>(QStringLiteral(":STIGId"), s.id),
+                                                    std::make_tuple<QString, QVariant>(QStringLiteral(":id"), lastId),
+                                                    std::make_tuple<QString, QVariant>(QStringLiteral(":limit"), limit)
+                                                });
+                        qint64 chunkBytes = 0;
+                        Q_FOREACH (const CKLCheck &c, chunk)
+                        {
+                            chunkBytes += static_cast<qint64>(sizeof(CKLCheck)) + 2 * (c.findingDetails.size() + c.comments.size());
+                        }
+                        MemoryMonitor::Track(chunkBytes);
+                        Q_FOREACH (const CKLCheck &c, chunk)
+                        {
+                            lastId = c.id;
+                            QPair<QString, QString> sc = checks.value(c.stigCheckId);
+
+                            stream.writeStartElement(QStringLiteral("FINDING"));
+
+                            stream.writeStartElement(QStringLiteral("FINDING_ID"));
+                            stream.writeAttribute(QStringLiteral("TYPE"), QStringLiteral("VK"));
+                            stream.writeAttribute(QStringLiteral("ID"), sc.first);
+                            stream.writeCharacters(sc.second);
+                            stream.writeEndElement(); //FINDING_ID
+
+                            stream.writeStartElement(QStringLiteral("FINDING_STATUS"));
+                            stream.writeCharacters(GetCMRSStatus(c.status));
+                            stream.writeEndElement(); //FINDING_STATUS
+
+                            stream.writeStartElement(QStringLiteral("FINDING_DETAILS"));
+                            stream.writeAttribute(QStringLiteral("OVERRIDE"), QStringLiteral("O"));
+                            stream.writeCharacters(c.findingDetails);
+                            stream.writeEndElement(); //FINDING_DETAILS
+
+                            stream.writeStartElement(QStringLiteral("SCRIPT_RESULTS"));
+                            stream.writeEndElement(); //SCRIPT_RESULTS
+
+                            stream.writeStartElement(QStringLiteral("COMMENT"));
+                            stream.writeCharacters(c.comments);
+                            stream.writeEndElement(); //COMMENT
+
+                            stream.writeStartElement(QStringLiteral("TOOL"));
+                            stream.writeCharacters(QStringLiteral("STIGQter"));
+                            stream.writeEndElement(); //TOOL
+
+                            stream.writeStartElement(QStringLiteral("TOOL_VERSION"));
+                            stream.writeCharacters(VERSION);
+                            stream.writeEndElement(); //TOOL_VERSION
+
+                            stream.writeStartElement(QStringLiteral("AUTHENTICATED_FINDING"));
+                            stream.writeCharacters(QStringLiteral("true"));
+                            stream.writeEndElement(); //AUTHENTICATED_FINDING
+
+                            stream.writeEndElement(); //FINDING
+                        }
+                        flush();
+                        MemoryMonitor::Track(-chunkBytes);
+                    } while ((chunk.count() == limit) && !Cancelled());
+
+                    stream.writeEndElement(); //TARGET
                 }
 
-                stream.writeEndElement(); //TARGET
-            }
-
-            stream.writeEndElement(); //ASSET
+                stream.writeEndElement(); //ASSET
 
-            Q_EMIT progress(-1);
-        }
+                Q_EMIT progress(-1);
+            }
+        } while ((assets.count() == assetLimit) && !IsCancelled());
 
         stream.writeEndElement(); //IMPORT_FILE
         stream.writeEndDocument();
+        flush();
+
+        if (gz)
+            gzclose(gz);
+        else
+            file.close();
     }
 
-    Q_EMIT updateStatus(QStringLiteral("Done!"));
+    if (IsCancelled())
+    {
+        QFile::remove(_fileName);
+        Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+    }
+    else
+        Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
 }
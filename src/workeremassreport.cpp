@@ -18,9 +18,12 @@
  */
 
 #include <QDate>
+#include <QFile>
 
 #include "common.h"
 #include "dbmanager.h"
+#include "memorymonitor.h"
+#include "tracerecorder.h"
 #include "workeremassreport.h"
 #include "xlsxwriter.h"
 
@@ -32,6 +35,10 @@
  * format for this spreadsheet is duplicated by this report so that
  * the results generated for the system can be directly imported into
  * eMASS.
+ *
+ * When the report would not fit in the memory budget, the workbook
+ * is written in constant-memory mode, which flushes each row to disk
+ * as soon as the next one starts.
  */
 
 /**
@@ -89,9 +96,8 @@ void WorkerEMASSReport::process()
 {
     DbManager db;
 
-    QVector<CKLCheck> checks = db.GetCKLChecks();
-    int numChecks = checks.count();
-    Q_EMIT initialize(numChecks+2, 0);
+    QVector<CCI> ccis = db.GetCCIs();
+    Q_EMIT initialize(ccis.count()+1, 0);
 
     //current date in eMASS format
     QString curDate = QDate::currentDate().toString(QStringLiteral("dd-MMM-yyyy"));
@@ -99,8 +105,10 @@ void WorkerEMASSReport::process()
     QDate tempDate(1899, 12, 31);
     qint64 excelCurDate = QDate::currentDate().toJulianDay() - tempDate.toJulianDay() + 1;
 
-    //new workbook
-    lxw_workbook  *wb = workbook_new(_fileName.toStdString().c_str());
+    //new workbook; each row holds about 8KiB of CCI text and results
+    lxw_workbook_options options = {};
+    options.constant_memory = MemoryMonitor::Fits(static_cast<qint64>(ccis.count()) * 8 * 1024) ? LXW_FALSE : LXW_TRUE;
+    lxw_workbook  *wb = workbook_new_opt(_fileName.toStdString().c_str(), &options);
     //2 sheets - findings and controls
     lxw_worksheet *ws = workbook_add_worksheet(wb, "Test Result Import");
 
@@ -200,10 +208,6 @@ void WorkerEMASSReport::process()
 
     bool dbIsImport = db.IsEmassImport();
 
-    QVector<CCI> ccis = db.GetCCIs();
-
-    Q_EMIT initialize(ccis.count()+1, 0);
-
     unsigned int onRow = 5;
 
     QString username(QString::fromLocal8Bit(qgetenv("USER")));
@@ -215,8 +219,11 @@ void WorkerEMASSReport::process()
     QVector<CKLCheck> failedChecks;
     QVector<CKLCheck> passedChecks;
 
-    Q_FOREACH (CCI cci, db.GetCCIs())
+    TraceSpan sheet(QStringLiteral("write sheet"), "io");
+    Q_FOREACH (CCI cci, ccis)
     {
+        if (Cancelled())
+            break;
         Q_EMIT progress(-1);
         Q_EMIT updateStatus("Adding " + PrintCCI(cci) + "…");
         failedChecks.clear();
@@ -364,14 +371,24 @@ void WorkerEMASSReport::process()
         worksheet_write_string(ws, onRow, 17, cci.isImport ? cci.importTestResults.toStdString().c_str() : "", fmtWrapped);
     }
 
+    sheet.End();
     Q_EMIT updateStatus(QStringLiteral("Writing workbook…"));
 
     //filter on column 1
     worksheet_autofilter(ws, 5, 0, onRow, 17);
 
     //close and write the workbook
+    TraceSpan save(QStringLiteral("write workbook"), "io");
     workbook_close(wb);
+    save.End();
 
-    Q_EMIT updateStatus(QStringLiteral("Done!"));
+    //a partial report is not left behind
+    if (IsCancelled())
+    {
+        QFile::remove(_fileName);
+        Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+    }
+    else
+        Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
 }
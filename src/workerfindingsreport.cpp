@@ -20,9 +20,13 @@
 #include "dbmanager.h"
 #include "cklcheck.h"
 #include "common.h"
+#include "memorymonitor.h"
+#include "tracerecorder.h"
 #include "workerfindingsreport.h"
 #include "xlsxwriter.h"
 
+#include <QFile>
+
 #include <algorithm>
 #include <cstdio>
 #include <string>
@@ -42,6 +46,9 @@
  * This report is generally  used when performing on-site validations
  * to help management understand the "big picture" of what needs to
  * be fixed on their system.
+ *
+ * Every sheet is written from top to bottom, so a report that would
+ * not fit in the memory budget is written in constant-memory mode.
  */
 
 /**
@@ -81,8 +88,10 @@ void WorkerFindingsReport::process()
     int numChecks = checks.count();
     Q_EMIT initialize(numChecks+3, 0);
 
-    //new workbook
-    lxw_workbook  *wb = workbook_new(_fileName.toStdString().c_str());
+    //new workbook; each finding holds about 8KiB of check text
+    lxw_workbook_options options = {};
+    options.constant_memory = MemoryMonitor::Fits(static_cast<qint64>(numChecks) * 8 * 1024) ? LXW_FALSE : LXW_TRUE;
+    lxw_workbook  *wb = workbook_new_opt(_fileName.toStdString().c_str(), &options);
 
     //2 sheets - findings and controls
     lxw_worksheet *wsFindings = workbook_add_worksheet(wb, "Findings");
@@ -132,7 +141,8 @@ void WorkerFindingsReport::process()
 
     //write each failed check
     unsigned int onRow = 0;
-    for (int i = 0; i < numChecks; i++)
+    TraceSpan sheet(QStringLiteral("write sheet"), "io");
+    for (int i = 0; (i < numChecks) && !Cancelled(); i++)
     {
         CKLCheck cc = checks[i];
         STIGCheck sc = cc.GetSTIGCheck();
@@ -273,11 +283,21 @@ void WorkerFindingsReport::process()
         worksheet_write_string(wsControls, onRow, 1, preamble.toStdString().c_str(), fmtWrapped);
     }
 
+    sheet.End();
     Q_EMIT updateStatus(QStringLiteral("Writing workbook…"));
 
     //close and write the workbook
+    TraceSpan save(QStringLiteral("write workbook"), "io");
     workbook_close(wb);
+    save.End();
 
-    Q_EMIT updateStatus(QStringLiteral("Done!"));
+    //a partial report is not left behind
+    if (IsCancelled())
+    {
+        QFile::remove(_fileName);
+        Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+    }
+    else
+        Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
 }
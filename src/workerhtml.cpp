@@ -19,13 +19,25 @@
 
 #include "workerhtml.h"
 
+#include "common.h"
 #include "dbmanager.h"
+#include "memorymonitor.h"
 #include "stig.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
 #include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
 #include <QList>
 #include <QMap>
+#include <QReadWriteLock>
+#include <QSet>
 #include <QVariant>
+#include <QtConcurrent>
+
+#include <zlib.h>
 
 /**
  * @class WorkerHTML
@@ -35,6 +47,23 @@
  * requirements.
  *
  * Only static, well-formatted HTML is created.
+ *
+ * A manifest of the exported STIGs is kept in the output directory.
+ * When exporting to the same directory again, only the pages of
+ * STIGs that were added or changed are regenerated, and the pages of
+ * removed STIGs are deleted.
+ *
+ * Alternatively, all pages can be written into a single zip archive,
+ * which avoids creating thousands of small files on slow or network
+ * filesystems. Each page is compressed by the thread that generated
+ * it and appended to the archive right away, so neither the pages
+ * nor temporary copies of them are kept until the archive is closed.
+ * Pages are generated one STIG at a time while the process is over
+ * budget.
+ *
+ * A page that cannot be written is reported as a warning. In a
+ * directory export, its STIG is left out of the manifest so that the
+ * next export generates it again.
  */
 
 /**
@@ -43,8 +72,92 @@
  *
  * Main constructor.
  */
-WorkerHTML::WorkerHTML(QObject *parent) : Worker(parent)
+WorkerHTML::WorkerHTML(QObject *parent) : Worker(parent),
+    _zipTime(0),
+    _zipDate(0),
+    _zipFailed(false),
+    _zipDropped(0)
+{
+}
+
+/**
+ * @brief WorkerHTML::AddToArchive
+ * @param fileName
+ * @param contents
+ * @return @c True when the page was added to the archive. Otherwise,
+ * @c false.
+ *
+ * The page is compressed by the calling thread; only appending it to
+ * the archive is serialized. Once a write to the archive fails, the
+ * archive is incomplete and the remaining pages are counted as
+ * dropped rather than written.
+ */
+bool WorkerHTML::AddToArchive(const QString &fileName, const QByteArray &contents)
 {
+    //raw deflate data, as stored in zip archives
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    QByteArray compressed;
+    bool ok = (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+    if (ok)
+    {
+        compressed.resize(static_cast<int>(deflateBound(&stream, static_cast<uLong>(contents.size()))));
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(contents.constData()));
+        stream.avail_in = static_cast<uInt>(contents.size());
+        stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+        stream.avail_out = static_cast<uInt>(compressed.size());
+        ok = (deflate(&stream, Z_FINISH) == Z_STREAM_END);
+        compressed.truncate(static_cast<int>(stream.total_out));
+        deflateEnd(&stream);
+    }
+    if (!ok)
+    {
+        _zipDropped++;
+        Q_EMIT ThrowWarning(QStringLiteral("Unable to Compress Page"), "Unable to compress " + fileName + " for the archive " + _archive + ".");
+        return false;
+    }
+
+    ArchiveEntry entry;
+    entry.name = fileName.toUtf8();
+    entry.crc = static_cast<quint32>(crc32(0L, reinterpret_cast<const Bytef*>(contents.constData()), static_cast<uInt>(contents.size())));
+    entry.compressedSize = static_cast<quint32>(compressed.size());
+    entry.size = static_cast<quint32>(contents.size());
+
+    //local file header: deflated, UTF-8 name
+    QByteArray header;
+    QDataStream out(&header, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    out << quint32(0x04034b50) << quint16(20) << quint16(0x0800) << quint16(8) << _zipTime << _zipDate
+        << entry.crc << entry.compressedSize << entry.size << static_cast<quint16>(entry.name.size()) << quint16(0);
+    out.writeRawData(entry.name.constData(), entry.name.size());
+
+    QString error;
+    {
+        //pages are generated concurrently, but only one thread may append to the archive at a time
+        QMutexLocker lock(&_zipMutex);
+        //as in a directory export, a page name is only written once
+        if (_zipNames.contains(entry.name))
+            return true;
+        if (_zipFailed)
+        {
+            _zipDropped++;
+            return false;
+        }
+        entry.offset = _zipFile.pos();
+        if ((_zipFile.write(header) == header.size()) && (_zipFile.write(compressed) == compressed.size()))
+        {
+            _zipNames.insert(entry.name);
+            _zipEntries.append(entry);
+            return true;
+        }
+        _zipFailed = true;
+        _zipDropped++;
+        error = _zipFile.errorString();
+    }
+    Q_EMIT ThrowWarning(QStringLiteral("Unable to Write Archive"), "Unable to write " + fileName + " to " + _archive + ": " + error);
+    return false;
 }
 
 /**
@@ -54,7 +167,7 @@ WorkerHTML::WorkerHTML(QObject *parent) : Worker(parent)
  * @return An HTML-formatted section within the @a STIGCheck file
  * detailing the @a contents, but only when @a contents exist.
  */
-QString WorkerHTML::CheckItem(const QString &title, const QString &contents)
+QString WorkerHTML::CheckItem(const QString &title, const QString &contents) const
 {
     QString ret = QLatin1String();
     if (!contents.isNull() && !contents.isEmpty())
@@ -71,7 +184,7 @@ QString WorkerHTML::CheckItem(const QString &title, const QString &contents)
  * @return An HTML-formatted section within the @a STIGCheck file
  * detailing the @a contents, but only when @a contents exist.
  */
-QString WorkerHTML::CheckItem(const QString &title, const QStringList &contents)
+QString WorkerHTML::CheckItem(const QString &title, const QStringList &contents) const
 {
     QString ret = QLatin1String();
     if (contents.count() > 0)
@@ -91,7 +204,7 @@ QString WorkerHTML::CheckItem(const QString &title, const QStringList &contents)
  * @param contents
  * @return Better HTML formatting of newlines
  */
-QString WorkerHTML::Sanitize(const QString &contents)
+QString WorkerHTML::Sanitize(const QString &contents) const
 {
     if (contents.isEmpty())
         return contents;
@@ -99,6 +212,175 @@ QString WorkerHTML::Sanitize(const QString &contents)
     return ret.replace(QStringLiteral("\n"), QStringLiteral("<br />\n"));
 }
 
+/**
+ * @brief WorkerHTML::CloseArchive
+ * @return @c True when every page was written and the archive was
+ * completed. Otherwise, @c false.
+ *
+ * The pages are already in the archive; closing it writes the central
+ * directory that indexes them. The ZIP64 end records are added when
+ * there are too many pages (or too much data) for the original
+ * format. An incomplete archive is removed.
+ */
+bool WorkerHTML::CloseArchive()
+{
+    if (!_zipFile.isOpen())
+        return false;
+
+    QByteArray directory;
+    QDataStream out(&directory, QIODevice::WriteOnly);
+    out.setByteOrder(QDataStream::LittleEndian);
+    Q_FOREACH (const ArchiveEntry &entry, _zipEntries)
+    {
+        //pages past the first 4GiB carry their offset in a ZIP64 extra field
+        bool zip64 = (entry.offset >= 0xFFFFFFFF);
+        out << quint32(0x02014b50) << quint16(zip64 ? 45 : 20) << quint16(zip64 ? 45 : 20) << quint16(0x0800) << quint16(8)
+            << _zipTime << _zipDate << entry.crc << entry.compressedSize << entry.size
+            << static_cast<quint16>(entry.name.size()) << quint16(zip64 ? 12 : 0) << quint16(0) << quint16(0) << quint16(0)
+            << quint32(0) << (zip64 ? quint32(0xFFFFFFFF) : static_cast<quint32>(entry.offset));
+        out.writeRawData(entry.name.constData(), entry.name.size());
+        if (zip64)
+            out << quint16(0x0001) << quint16(8) << static_cast<quint64>(entry.offset);
+    }
+
+    qint64 start = _zipFile.pos();
+    quint64 count = static_cast<quint64>(_zipEntries.count());
+    quint64 size = static_cast<quint64>(directory.size());
+    if ((count >= 0xFFFF) || (start >= 0xFFFFFFFF))
+    {
+        //ZIP64 end of central directory record and locator
+        out << quint32(0x06064b50) << quint64(44) << quint16(45) << quint16(45) << quint32(0) << quint32(0)
+            << count << count << size << static_cast<quint64>(start);
+        out << quint32(0x07064b50) << quint32(0) << static_cast<quint64>(start + static_cast<qint64>(size)) << quint32(1);
+    }
+    out << quint32(0x06054b50) << quint16(0) << quint16(0)
+        << static_cast<quint16>(qMin(count, quint64(0xFFFF))) << static_cast<quint16>(qMin(count, quint64(0xFFFF)))
+        << static_cast<quint32>(size) << static_cast<quint32>(qMin(static_cast<quint64>(start), quint64(0xFFFFFFFF))) << quint16(0);
+
+    bool written = !_zipFailed && (_zipFile.write(directory) == directory.size()) && _zipFile.flush();
+    QString error = _zipFile.errorString();
+    _zipFile.close();
+    _zipEntries.clear();
+    _zipNames.clear();
+    if (!written)
+    {
+        QFile::remove(_archive);
+        Warning(QStringLiteral("Unable to Write Archive"), "Unable to complete the HTML archive " + _archive + ": " + error + ". " +
+                (_zipDropped > 0 ? QString::number(_zipDropped) + " pages were not written, and the" : QStringLiteral("The")) + " incomplete archive was removed.");
+    }
+    return written && (_zipDropped == 0);
+}
+
+/**
+ * @brief WorkerHTML::ManifestEntry
+ * @param stig
+ * @param checks
+ * @return The manifest record of the pages generated for the @a stig
+ * and its @a checks.
+ *
+ * The hash covers everything that is rendered into the pages
+ * (including the shared header), so an edit to the STIG, any of its
+ * checks, or the mapped CCIs results in a different hash.
+ */
+QJsonObject WorkerHTML::ManifestEntry(const STIG &stig, const QVector<STIGCheck> &checks) const
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(_header);
+    hash.addData(QStringList({PrintSTIG(stig), stig.title, stig.fileName}).join(QChar(0)).toUtf8());
+    QJsonArray pages;
+    Q_FOREACH (const STIGCheck &c, checks)
+    {
+        QStringList fields({c.rule, c.vulnNum, c.groupTitle, c.ruleVersion, GetSeverity(c.severity),
+                            QString::number(c.weight), c.title, c.falsePositives, c.falseNegatives,
+                            c.fix, c.check, PrintTrueFalse(c.documentable), c.mitigations, c.checkContentRef,
+                            c.potentialImpact, c.thirdPartyTools, c.mitigationControl, c.responsibility,
+                            c.iaControls, c.targetKey});
+        Q_FOREACH (int cciId, c.cciIds)
+        {
+            fields.append(_ccis.value(cciId));
+        }
+        hash.addData(fields.join(QChar(0)).toUtf8());
+        pages.append(PrintSTIGCheck(c) + ".html");
+    }
+
+    QJsonObject ret;
+    ret.insert(QStringLiteral("id"), stig.id);
+    ret.insert(QStringLiteral("hash"), QString::fromLatin1(hash.result().toHex()));
+    ret.insert(QStringLiteral("page"), PageName(stig));
+    ret.insert(QStringLiteral("checks"), pages);
+    return ret;
+}
+
+/**
+ * @brief WorkerHTML::OpenArchive
+ * @return @c True when the archive was created. Otherwise, @c false.
+ *
+ * Creates (or truncates) the zip archive that the pages are streamed
+ * into. Every page is stamped with the time of the export.
+ */
+bool WorkerHTML::OpenArchive()
+{
+    _zipEntries.clear();
+    _zipNames.clear();
+    _zipFailed = false;
+    _zipDropped = 0;
+
+    //MS-DOS date and time, as stored in zip archives
+    QDateTime now = QDateTime::currentDateTime();
+    _zipTime = static_cast<quint16>((now.time().hour() << 11) | (now.time().minute() << 5) | (now.time().second() / 2));
+    _zipDate = static_cast<quint16>(((now.date().year() - 1980) << 9) | (now.date().month() << 5) | now.date().day());
+
+    _zipFile.setFileName(_archive);
+    return _zipFile.open(QIODevice::WriteOnly | QIODevice::Truncate);
+}
+
+/**
+ * @brief WorkerHTML::PageName
+ * @param stig
+ * @return The file name of the summary page for the @a stig.
+ */
+QString WorkerHTML::PageName(const STIG &stig) const
+{
+    QString ret = stig.fileName;
+    return ret.replace(QStringLiteral(".xml"), QStringLiteral(".html"), Qt::CaseInsensitive);
+}
+
+/**
+ * @brief WorkerHTML::ReadManifest
+ * @return The manifest entries of the previous export to this
+ * directory, keyed by STIG ID. When there is no previous export (or
+ * the manifest cannot be read), the map is empty and every page is
+ * generated.
+ */
+QMap<int, QJsonObject> WorkerHTML::ReadManifest() const
+{
+    QMap<int, QJsonObject> ret;
+    QFile file(QDir(_exportDir).filePath(QStringLiteral("manifest.json")));
+    if (file.open(QIODevice::ReadOnly))
+    {
+        QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+        file.close();
+        Q_FOREACH (const QJsonValue &entry, doc.object().value(QStringLiteral("stigs")).toArray())
+        {
+            QJsonObject obj = entry.toObject();
+            ret.insert(obj.value(QStringLiteral("id")).toInt(), obj);
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief WorkerHTML::SetArchive
+ * @param fileName
+ *
+ * Write all pages into the zip archive @a fileName instead of
+ * individual files in a directory.
+ */
+void WorkerHTML::SetArchive(const QString &fileName)
+{
+    _archive = fileName;
+}
+
 /**
  * @brief WorkerHTML::SetDir
  * @param dir
@@ -110,6 +392,153 @@ void WorkerHTML::SetDir(const QString &dir)
     _exportDir = dir;
 }
 
+/**
+ * @brief WorkerHTML::WriteFile
+ * @param fileName
+ * @param contents
+ * @return @c True when the page was written. Otherwise, @c false.
+ *
+ * Writes the fully-rendered @a contents to @a fileName inside of the
+ * export directory (or archive) in a single write. The page is
+ * tracked until it has been written.
+ */
+bool WorkerHTML::WriteFile(const QString &fileName, const QByteArray &contents)
+{
+    MemoryMonitor::Track(contents.size());
+    bool ret = false;
+    if (!_archive.isEmpty())
+        ret = AddToArchive(fileName, contents);
+    else
+    {
+        QFile file(QDir(_exportDir).filePath(fileName));
+        ret = file.open(QIODevice::WriteOnly) && (file.write(contents) == contents.size()) && file.flush();
+        if (!ret)
+            Q_EMIT ThrowWarning(QStringLiteral("Unable to Write Page"), "Unable to write " + file.fileName() + ": " + file.errorString());
+    }
+    MemoryMonitor::Track(-contents.size());
+    return ret;
+}
+
+/**
+ * @brief WorkerHTML::WriteSTIG
+ * @param stig
+ * @param checks
+ *
+ * @return @c True when all of the pages were written. Otherwise,
+ * @c false.
+ *
+ * Renders the summary page for the @a stig and the detail page for
+ * each of its @a checks.
+ *
+ * This function runs concurrently for multiple STIGs, so it must not
+ * access the database. All data that it needs (including the CCI
+ * descriptions) is loaded before the pages are generated.
+ */
+bool WorkerHTML::WriteSTIG(const STIG &stig, const QVector<STIGCheck> &checks)
+{
+    bool ret = true;
+    QString STIGName = PrintSTIG(stig);
+    QString STIGFileName = PageName(stig);
+    Q_EMIT updateStatus("Creating page for " + STIGName + "…");
+
+    QByteArray page("<!doctype html>"
+                    "<html lang=\"en\">"
+                    "<head>"
+                    "<meta charset=\"utf-8\">"
+                    "<title>STIGQter: STIG Details: ");
+    page.append(STIGName.toUtf8());
+    page.append("</title>");
+    page.append(_header);
+    page.append(" <a href=\"main.html\">STIG Summary</a>:</div> <h1>");
+    page.append(stig.title.toUtf8());
+    page.append("</h1><h2>Version: ");
+    page.append(QByteArray::number(stig.version));
+    page.append("</h2>"
+                "<h2>");
+    page.append(stig.release.toUtf8());
+    page.append("</h2>"
+                "<table style=\"border-collapse: collapse; border: 1px solid black;\">"
+                "<tr>"
+                "<th style=\"border: 1px solid black;\">Checked</th>"
+                "<th style=\"border: 1px solid black;\">Name</th>"
+                "<th style=\"border: 1px solid black;\">Title</th>"
+                "</tr>");
+
+    Q_FOREACH (const STIGCheck &c, checks)
+    {
+        //the summary page is not written for a partial STIG
+        if (Cancelled())
+            return false;
+        QString checkName(PrintSTIGCheck(c));
+        page.append("<tr>"
+                    "<td style=\"border: 1px solid black;\">☐</td>"
+                    "<td style=\"border: 1px solid black; white-space: nowrap;\">"
+                    "<a href=\"");
+        page.append(checkName.toUtf8());
+        page.append(".html\">");
+        page.append(checkName.toUtf8());
+        page.append("</a>"
+                    "</td>"
+                    "<td style=\"border: 1px solid black;\">");
+        page.append(c.title.toUtf8());
+        page.append("</td>"
+                    "</tr>");
+
+        QStringList cciStr;
+        Q_FOREACH (int cciId, c.cciIds)
+        {
+            if (_ccis.contains(cciId))
+                cciStr.append(_ccis.value(cciId));
+        }
+
+        QByteArray check("<!doctype html>"
+                         "<html lang=\"en\">"
+                         "<head>"
+                         "<meta charset=\"utf-8\">"
+                         "<title>STIGQter: STIG Check Details: ");
+        check.append(QString(checkName + ": " + c.title).toUtf8());
+        check.append("</title>");
+        check.append(_header);
+        check.append(QString(" <a href=\"main.html\">STIG Summary</a>: <a href=\"" + STIGFileName + "\">" + STIGName + "</a>"
+                             ":</div> <h1>" + c.title + "</h1>").toUtf8());
+        check.append(CheckItem(QStringLiteral("DISA Rule"), c.rule).toUtf8());
+        check.append(CheckItem(QStringLiteral("Vulnerability Number"), c.vulnNum).toUtf8());
+        check.append(CheckItem(QStringLiteral("Group Title"), c.groupTitle).toUtf8());
+        check.append(CheckItem(QStringLiteral("Rule Version"), c.ruleVersion).toUtf8());
+        check.append(CheckItem(QStringLiteral("Severity"), GetSeverity(c.severity)).toUtf8());
+        check.append(CheckItem(QStringLiteral("CCI(s)"), cciStr).toUtf8());
+        check.append(CheckItem(QStringLiteral("Weight"), QString::number(c.weight)).toUtf8());
+        check.append(CheckItem(QStringLiteral("False Positives"), c.falsePositives).toUtf8());
+        check.append(CheckItem(QStringLiteral("False Negatives"), c.falseNegatives).toUtf8());
+        check.append(CheckItem(QStringLiteral("Fix Recommendation"), c.fix).toUtf8());
+        check.append(CheckItem(QStringLiteral("Check Contents"), c.check).toUtf8());
+        check.append(CheckItem(QStringLiteral("Vulnerability Number"), c.vulnNum).toUtf8());
+        check.append(CheckItem(QStringLiteral("Documentable"), c.documentable ? QStringLiteral("True") : QStringLiteral("False")).toUtf8());
+        check.append(CheckItem(QStringLiteral("Rule Version"), c.ruleVersion).toUtf8());
+        check.append(CheckItem(QStringLiteral("Mitigations"), c.mitigations).toUtf8());
+        check.append(CheckItem(QStringLiteral("Severity Override Guidance"), c.check).toUtf8());
+        check.append(CheckItem(QStringLiteral("Check Content Reference"), c.checkContentRef).toUtf8());
+        check.append(CheckItem(QStringLiteral("Potential Impact"), c.potentialImpact).toUtf8());
+        check.append(CheckItem(QStringLiteral("Third-Party Tools"), c.thirdPartyTools).toUtf8());
+        check.append(CheckItem(QStringLiteral("Mitigation Control"), c.mitigationControl).toUtf8());
+        check.append(CheckItem(QStringLiteral("Responsibility"), c.responsibility).toUtf8());
+        check.append(CheckItem(QStringLiteral("IA Controls"), c.iaControls).toUtf8());
+        check.append(CheckItem(QStringLiteral("Target Key"), c.targetKey).toUtf8());
+        check.append(_footer);
+        if (!WriteFile(checkName + ".html", check))
+            ret = false;
+
+        Q_EMIT progress(-1);
+    }
+
+    page.append("</table>");
+    page.append(_footer);
+    if (!WriteFile(STIGFileName, page))
+        ret = false;
+    Q_EMIT progress(-1);
+    return ret;
+}
+
 /**
  * @brief WorkerHTML::process
  *
@@ -146,181 +575,196 @@ void WorkerHTML::process()
     QVector<STIG> stigs = db.GetSTIGs();
 
     QMap<STIG, QVector<STIGCheck>> checkMap;
-    int count = 0;
     Q_FOREACH (const STIG &s, stigs)
     {
-        QVector<STIGCheck> checks = s.GetSTIGChecks();
-        count += checks.count();
-        checkMap.insert(s, checks);
+        if (Cancelled())
+            break;
+        checkMap.insert(s, s.GetSTIGChecks());
     }
 
-    //update progress bar to reflect number of steps
-    Q_EMIT initialize(1 + checkMap.count() + count, 1);
+    //a partial list of STIGs would remove the pages of the STIGs that were not loaded
+    if (IsCancelled())
+    {
+        Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+        Q_EMIT finished();
+        return;
+    }
 
-    QDir outputDir(_exportDir);
-    QFile main(outputDir.filePath(QStringLiteral("main.html")));
-    main.open(QIODevice::WriteOnly);
-    QString headerExtra = db.GetVariable(QStringLiteral("HTMLHeader"));
-
-    main.write("<!doctype html>"
-               "<html lang=\"en\">"
-               "<head>"
-               "<meta charset=\"utf-8\">"
-               "<title>STIGQter: STIG Summary</title>");
-    main.write("<link rel=\"icon\" type=\"image/svg+xml\" href=\"STIGQter.svg\" />");
-    main.write(headerExtra.toStdString().c_str());
-    main.write("</head>"
-               "<body>"
-               "<div><img src=\"STIGQter.svg\" alt=\"STIGQter\" style=\"height:1em;\" /> <a href=\"https://www.stigqter.com/\">STIGQter</a>:</div> <h1>STIG Summary</h1>"
-               "<ul>");
-
-    Q_FOREACH (const STIG &s, checkMap.keys())
+    //prefetch the CCI descriptions so that the pages can be built without the database
+    _ccis.clear();
+    Q_FOREACH (const CCI &cci, db.GetCCIs())
     {
-        QString STIGName = PrintSTIG(s);
-        QString STIGFileName = s.fileName;
-        STIGFileName = STIGFileName.replace(QStringLiteral(".xml"), QStringLiteral(".html"), Qt::CaseInsensitive);
-        Q_EMIT updateStatus("Creating page for " + STIGName + "…");
-        main.write("<li><a href=\"");
-        main.write(STIGFileName.toStdString().c_str());
-        main.write("\">");
-        main.write(STIGName.toStdString().c_str());
-        main.write("</a></li>");
-
-        QFile stig(outputDir.filePath(STIGFileName));
-        stig.open(QIODevice::WriteOnly);
-
-        stig.write("<!doctype html>"
-                   "<html lang=\"en\">"
-                   "<head>"
-                   "<meta charset=\"utf-8\">"
-                   "<title>STIGQter: STIG Details: ");
-        stig.write(STIGName.toStdString().c_str());
-        stig.write("</title>");
-        stig.write("<link rel=\"icon\" type=\"image/svg+xml\" href=\"STIGQter.svg\" />");
-        stig.write(headerExtra.toStdString().c_str());
-        stig.write("</head>"
+        _ccis.insert(cci.id, PrintCCI(cci) + " - " + cci.definition);
+    }
+
+    //the same header and footer are used for every page
+    _header = "<link rel=\"icon\" type=\"image/svg+xml\" href=\"STIGQter.svg\" />";
+    _header.append(db.GetVariable(QStringLiteral("HTMLHeader")).toUtf8());
+    _header.append("</head>"
                    "<body>"
                    "<div><img src=\"STIGQter.svg\" alt=\"STIGQter\" style=\"height:1em;\" /> "
-                   "<a href=\"https://www.stigqter.com/\">STIGQter</a>: <a href=\"main.html\">STIG Summary</a>:</div> <h1>");
-        stig.write(s.title.toStdString().c_str());
-        stig.write("</h1><h2>Version: ");
-        stig.write(QString::number(s.version).toStdString().c_str());
-        stig.write("</h2>"
-                   "<h2>");
-        stig.write(QString(s.release).toStdString().c_str());
-        stig.write("</h2>"
-                   "<table style=\"border-collapse: collapse; border: 1px solid black;\">"
-                   "<tr>"
-                   "<th style=\"border: 1px solid black;\">Checked</th>"
-                   "<th style=\"border: 1px solid black;\">Name</th>"
-                   "<th style=\"border: 1px solid black;\">Title</th>"
-                   "</tr>");
-
-        Q_FOREACH (const STIGCheck &c, checkMap[s])
+                   "<a href=\"https://www.stigqter.com/\">STIGQter</a>:");
+    _footer = "</body>"
+              "</html>";
+
+    if (!_archive.isEmpty() && !OpenArchive())
+    {
+        Warning(QStringLiteral("Unable to Create Archive"), "Unable to create the HTML archive " + _archive + ": " + _zipFile.errorString());
+        Q_EMIT updateStatus(QStringLiteral("Done!"));
+        Q_EMIT finished();
+        return;
+    }
+
+    //compare against the manifest of the previous export; only added or changed STIGs are regenerated
+    Q_EMIT updateStatus(QStringLiteral("Comparing against previous export…"));
+    QMap<int, QJsonObject> previous;
+    if (_archive.isEmpty())
+        previous = ReadManifest();
+    QList<STIG> keys = checkMap.keys();
+    QList<STIG> toWrite;
+    QJsonArray manifest;
+    QSet<QString> files;
+    int count = 0;
+    Q_FOREACH (const STIG &s, keys)
+    {
+        QJsonObject entry = ManifestEntry(s, checkMap.value(s));
+        manifest.append(entry);
+        files.insert(entry.value(QStringLiteral("page")).toString());
+        Q_FOREACH (const QJsonValue &page, entry.value(QStringLiteral("checks")).toArray())
         {
-            QString checkName(PrintSTIGCheck(c));
-            Q_EMIT updateStatus("Creating Check " + checkName + "…");
-            stig.write("<tr>"
-                       "<td style=\"border: 1px solid black;\">☐</td>"
-                       "<td style=\"border: 1px solid black; white-space: nowrap;\">"
-                       "<a href=\"");
-            stig.write(checkName.toStdString().c_str());
-            stig.write(".html\">");
-            stig.write(checkName.toStdString().c_str());
-            stig.write("</a>"
-                       "</td>"
-                       "<td style=\"border: 1px solid black;\">");
-            stig.write(c.title.toStdString().c_str());
-            stig.write("</td>"
-                       "</tr>");
-
-            QFile check(outputDir.filePath(checkName + ".html"));
-            check.open(QIODevice::WriteOnly);
-            check.write("<!doctype html>"
-                       "<html lang=\"en\">"
-                       "<head>"
-                       "<meta charset=\"utf-8\">"
-                       "<title>STIGQter: STIG Check Details: ");
-            check.write(checkName.toStdString().c_str());
-            check.write(": ");
-            check.write(c.title.toStdString().c_str());
-            check.write("</title>");
-            check.write("<link rel=\"icon\" type=\"image/svg+xml\" href=\"STIGQter.svg\" />");
-            check.write(headerExtra.toStdString().c_str());
-            check.write("</head>"
-                       "<body>"
-                       "<div><img src=\"STIGQter.svg\" alt=\"STIGQter\" style=\"height:1em;\" /> "
-                       "<a href=\"https://www.stigqter.com/\">STIGQter</a>: <a href=\"main.html\">STIG Summary</a>: <a href=\"");
-            check.write(STIGFileName.toStdString().c_str());
-            check.write("\">");
-            check.write(STIGName.toStdString().c_str());
-            check.write("</a>"
-                        ":</div> <h1>");
-            check.write(c.title.toStdString().c_str());
-            check.write("</h1>");
-            check.write(CheckItem(QStringLiteral("DISA Rule"), c.rule).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Vulnerability Number"), c.vulnNum).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Group Title"), c.groupTitle).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Rule Version"), c.ruleVersion).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Severity"), GetSeverity(c.severity)).toStdString().c_str());
-            QVector<CCI> ccis = c.GetCCIs();
-            QStringList cciStr;
-            if (ccis.count() > 0)
-            {
-                Q_FOREACH (CCI cci, ccis)
-                {
-                    cciStr.append(PrintCCI(cci) + " - " + cci.definition);
-                }
-            }
-            check.write(CheckItem(QStringLiteral("CCI(s)"), cciStr).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Weight"), QString::number(c.weight)).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("False Positives"), c.falsePositives).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("False Negatives"), c.falseNegatives).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Fix Recommendation"), c.fix).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Check Contents"), c.check).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Vulnerability Number"), c.vulnNum).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Documentable"), c.documentable ? QStringLiteral("True") : QStringLiteral("False")).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Rule Version"), c.ruleVersion).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Mitigations"), c.mitigations).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Severity Override Guidance"), c.check).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Check Content Reference"), c.checkContentRef).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Potential Impact"), c.potentialImpact).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Third-Party Tools"), c.thirdPartyTools).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Mitigation Control"), c.mitigationControl).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Responsibility"), c.responsibility).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("IA Controls"), c.iaControls).toStdString().c_str());
-            check.write(CheckItem(QStringLiteral("Target Key"), c.targetKey).toStdString().c_str());
-            check.write("</body>"
-                        "</html>");
-            check.close();
-
-            Q_EMIT progress(-1);
+            files.insert(page.toString());
         }
-        Q_EMIT progress(-1);
-        stig.write("</table>"
-                   "</body>"
-                   "</html>");
-        stig.close();
+        if (!previous.contains(s.id) ||
+                (previous.value(s.id).value(QStringLiteral("hash")) != entry.value(QStringLiteral("hash"))) ||
+                (_archive.isEmpty() && !QFile::exists(QDir(_exportDir).filePath(PageName(s)))))
+        {
+            toWrite.append(s);
+            count += checkMap.value(s).count();
+        }
+    }
+    bool changed = (toWrite.count() > 0) || (previous.count() != keys.count());
+
+    //update progress bar to reflect number of steps
+    Q_EMIT initialize(1 + toWrite.count() + count, 1);
+
+    //remove pages of STIGs that were removed or no longer generate the same checks
+    QDir outputDir(_exportDir);
+    Q_FOREACH (const QJsonObject &entry, previous)
+    {
+        QStringList stale({entry.value(QStringLiteral("page")).toString()});
+        Q_FOREACH (const QJsonValue &page, entry.value(QStringLiteral("checks")).toArray())
+        {
+            stale.append(page.toString());
+        }
+        Q_FOREACH (const QString &page, stale)
+        {
+            if (!page.isEmpty() && !files.contains(page))
+                outputDir.remove(page);
+        }
+    }
+
+    if (changed || !_archive.isEmpty() || !outputDir.exists(QStringLiteral("main.html")))
+    {
+        QByteArray main("<!doctype html>"
+                        "<html lang=\"en\">"
+                        "<head>"
+                        "<meta charset=\"utf-8\">"
+                        "<title>STIGQter: STIG Summary</title>");
+        main.append(_header);
+        main.append("</div> <h1>STIG Summary</h1>"
+                    "<ul>");
+
+        Q_FOREACH (const STIG &s, keys)
+        {
+            main.append("<li><a href=\"");
+            main.append(PageName(s).toUtf8());
+            main.append("\">");
+            main.append(PrintSTIG(s).toUtf8());
+            main.append("</a></li>");
+        }
+
+        main.append("</ul>");
+        main.append(_footer);
+        WriteFile(QStringLiteral("main.html"), main);
     }
 
-    main.write("</ul>"
-               "</body>"
-               "</html>");
-    main.close();
-
-    QFile svg(outputDir.filePath(QStringLiteral("STIGQter.svg")));
-    svg.open(QIODevice::WriteOnly);
-    svg.write("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>"
-              "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">"
-              "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:serif=\"http://www.serif.com/\" width=\"100%\" height=\"100%\" viewBox=\"0 0 200 200\" version=\"1.1\" xml:space=\"preserve\" style=\"fill-rule:evenodd;clip-rule:evenodd;stroke-linejoin:round;stroke-miterlimit:2;\">"
-              "<path d=\"M96.811,126.461c53.038,-67.257 49.958,-90.674 83.894,-85.511c-34.584,47.088 -46.567,66.713 -73.966,128.5l-9.928,-42.989Z\"/>"
-              "<path d=\"M96.389,189.918c-15.558,-21.486 -33.377,-47.067 -59.228,-65.725c15.928,-2.634 24.927,-4.043 44.655,11.884c5.738,6.627 11.554,5.763 14.573,53.841Z\"/>"
-              "<path d=\"M75.819,42.48c46.439,16.837 84.329,22.755 101.582,17.593c-3.873,11.242 -10.34,16.366 -8.151,33.728c-27.173,-6.625 -48.701,-5.615 -75.874,0c-1.274,-26.031 -10.43,-39.058 -17.557,-51.321Z\"/>"
-              "<path d=\"M85.537,125.771l3.4,2.92c35.832,-68.049 70.548,-107.987 106.971,-121.27c0.235,-0.082 0.497,0.002 0.638,0.207c0.142,0.205 0.129,0.48 -0.031,0.67c-42.227,50.312 -76.735,107.201 -101.304,172.554c-7.075,-9.074 -14.287,-17.998 -21.693,-26.738c5.477,-7.456 9.688,-17.216 12.019,-28.343Z\" style=\"fill:#41cd52;\"/>"
-              "<path d=\"M67.272,111.238c0.261,-2.075 0.395,-4.204 0.395,-6.382c0,-17.825 -8.991,-32.297 -20.066,-32.297c-7.848,0 -14.65,7.268 -17.927,17.859c-6.685,-2.715 -13.378,-4.851 -20.03,-6.38c5.349,-25.453 20.334,-43.776 37.957,-43.776c22.149,0 40.132,28.944 40.132,64.594c0,7.211 -0.736,14.148 -2.129,20.608l-0.067,0.307c-2.352,11.13 -6.546,20.89 -12.019,28.343l-0.164,0.224c-6.942,9.43 -15.938,15.112 -25.753,15.112c-22.149,0 -40.131,-28.943 -40.131,-64.594c0,-5.743 0.467,-11.312 1.387,-16.582l7.497,6.473l11.189,10.347c0.073,17.716 9.033,32.059 20.058,32.059c2.981,0 5.811,-1.048 8.359,-2.967l0.133,-0.099c5.645,-4.223 9.861,-12.583 11.154,-22.649l0.025,-0.2Z\"/>"
-              "<path d=\"M8.857,88.274l-5.079,-4.386c-0.194,-0.16 -0.255,-0.431 -0.15,-0.659c0.105,-0.228 0.351,-0.357 0.599,-0.313c1.803,0.329 3.607,0.702 5.417,1.122l-0.369,1.619l-0.042,0.268l0.042,-0.268l0.369,-1.619c6.679,1.538 13.359,3.668 20.03,6.38c-0.099,0.312 -0.195,0.627 -0.287,0.945c0.092,-0.318 0.188,-0.633 0.287,-0.945c12.527,5.05 25.049,12.102 37.573,21.02c-1.3,10.135 -5.564,18.543 -11.287,22.748c-9.155,-10.061 -18.611,-19.79 -28.417,-29.092l-0.007,-0.238c0,-2.852 0.23,-5.619 0.665,-8.252c-0.435,2.633 -0.665,5.4 -0.665,8.252l0.007,0.238l-11.189,-10.347l-7.497,-6.473Zm19.515,7.36c-0.049,0.265 -0.097,0.532 -0.142,0.801c0.039,-0.231 0.079,-0.461 0.122,-0.69l0.02,-0.111Zm0.18,-0.913c-0.055,0.268 -0.109,0.537 -0.16,0.808c0.051,-0.271 0.105,-0.54 0.16,-0.808Zm0.328,-1.455c-0.089,0.364 -0.173,0.731 -0.253,1.101c0.08,-0.37 0.164,-0.737 0.253,-1.101Zm0.033,-0.137l-0.017,0.07l0.017,-0.07l0.019,-0.077l-0.019,0.077Zm0.433,-1.625c-0.037,0.129 -0.073,0.258 -0.109,0.387c0.036,-0.129 0.072,-0.258 0.109,-0.387Z\" style=\"fill:#41cd52;\"/>"
-              "</svg>");
-    svg.close();
+    //each STIG (and its checks) is independent of the others
+    //over the memory budget, a STIG waits for the STIGs being generated to finish and is then generated alone
+    //the pages in flight on the pool's threads count toward this job's memory
+    QReadWriteLock budgetLock;
+    QMutex failedMutex;
+    QSet<int> failed;
+    MemoryUsage *usage = MemoryUsage::Current();
+    QtConcurrent::blockingMap(toWrite, [this, &checkMap, &budgetLock, &failedMutex, &failed, usage](const STIG &s) {
+        if (Cancelled())
+            return;
+        //the calling thread may run a STIG itself, so its own usage is put back afterward
+        MemoryUsage *previous = MemoryUsage::Current();
+        MemoryUsage::SetCurrent(usage);
+        //the budget is checked once the STIG holds its place, so that no STIG starts alongside one being generated alone
+        budgetLock.lockForRead();
+        if (MemoryMonitor::OverBudget())
+        {
+            budgetLock.unlock();
+            budgetLock.lockForWrite();
+        }
+        bool written = WriteSTIG(s, checkMap.value(s));
+        budgetLock.unlock();
+        MemoryUsage::SetCurrent(previous);
+        if (!written)
+        {
+            QMutexLocker lock(&failedMutex);
+            failed.insert(s.id);
+        }
+    });
+
+    if (IsCancelled())
+    {
+        //a partial archive is removed; the previous manifest is kept so that the next export regenerates the unwritten pages
+        if (_zipFile.isOpen())
+        {
+            _zipFile.close();
+            QFile::remove(_archive);
+        }
+        Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+        Q_EMIT finished();
+        return;
+    }
+
+    if (_archive.isEmpty())
+    {
+        //STIGs with pages that could not be written are left out so that the next export writes them again
+        QJsonArray written;
+        Q_FOREACH (const QJsonValue &entry, manifest)
+        {
+            if (!failed.contains(entry.toObject().value(QStringLiteral("id")).toInt()))
+                written.append(entry);
+        }
+        QJsonObject manifestRoot;
+        manifestRoot.insert(QStringLiteral("generator"), QStringLiteral("STIGQter ") + VERSION);
+        manifestRoot.insert(QStringLiteral("stigs"), written);
+        WriteFile(QStringLiteral("manifest.json"), QJsonDocument(manifestRoot).toJson(QJsonDocument::Compact));
+    }
+
+    if (!_archive.isEmpty() || !outputDir.exists(QStringLiteral("STIGQter.svg")))
+    {
+        WriteFile(QStringLiteral("STIGQter.svg"), QByteArray("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>"
+                                                             "<!DOCTYPE svg PUBLIC \"-//W3C//DTD SVG 1.1//EN\" \"http://www.w3.org/Graphics/SVG/1.1/DTD/svg11.dtd\">"
+                                                             "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" xmlns:serif=\"http://www.serif.com/\" width=\"100%\" height=\"100%\" viewBox=\"0 0 200 200\" version=\"1.1\" xml:space=\"preserve\" style=\"fill-rule:evenodd;clip-rule:evenodd;stroke-linejoin:round;stroke-miterlimit:2;\">"
+                                                             "<path d=\"M96.811,126.461c53.038,-67.257 49.958,-90.674 83.894,-85.511c-34.584,47.088 -46.567,66.713 -73.966,128.5l-9.928,-42.989Z\"/>"
+                                                             "<path d=\"M96.389,189.918c-15.558,-21.486 -33.377,-47.067 -59.228,-65.725c15.928,-2.634 24.927,-4.043 44.655,11.884c5.738,6.627 11.554,5.763 14.573,53.841Z\"/>"
+                                                             "<path d=\"M75.819,42.48c46.439,16.837 84.329,22.755 101.582,17.593c-3.873,11.242 -10.34,16.366 -8.151,33.728c-27.173,-6.625 -48.701,-5.615 -75.874,0c-1.274,-26.031 -10.43,-39.058 -17.557,-51.321Z\"/>"
+                                                             "<path d=\"M85.537,125.771l3.4,2.92c35.832,-68.049 70.548,-107.987 106.971,-121.27c0.235,-0.082 0.497,0.002 0.638,0.207c0.142,0.205 0.129,0.48 -0.031,0.67c-42.227,50.312 -76.735,107.201 -101.304,172.554c-7.075,-9.074 -14.287,-17.998 -21.693,-26.738c5.477,-7.456 9.688,-17.216 12.019,-28.343Z\" style=\"fill:#41cd52;\"/>"
+                                                             "<path d=\"M67.272,111.238c0.261,-2.075 0.395,-4.204 0.395,-6.382c0,-17.825 -8.991,-32.297 -20.066,-32.297c-7.848,0 -14.65,7.268 -17.927,17.859c-6.685,-2.715 -13.378,-4.851 -20.03,-6.38c5.349,-25.453 20.334,-43.776 37.957,-43.776c22.149,0 40.132,28.944 40.132,64.594c0,7.211 -0.736,14.148 -2.129,20.608l-0.067,0.307c-2.352,11.13 -6.546,20.89 -12.019,28.343l-0.164,0.224c-6.942,9.43 -15.938,15.112 -25.753,15.112c-22.149,0 -40.131,-28.943 -40.131,-64.594c0,-5.743 0.467,-11.312 1.387,-16.582l7.497,6.473l11.189,10.347c0.073,17.716 9.033,32.059 20.058,32.059c2.981,0 5.811,-1.048 8.359,-2.967l0.133,-0.099c5.645,-4.223 9.861,-12.583 11.154,-22.649l0.025,-0.2Z\"/>"
+                                                             "<path d=\"M8.857,88.274l-5.079,-4.386c-0.194,-0.16 -0.255,-0.431 -0.15,-0.659c0.105,-0.228 0.351,-0.357 0.599,-0.313c1.803,0.329 3.607,0.702 5.417,1.122l-0.369,1.619l-0.042,0.268l0.042,-0.268l0.369,-1.619c6.679,1.538 13.359,3.668 20.03,6.38c-0.099,0.312 -0.195,0.627 -0.287,0.945c0.092,-0.318 0.188,-0.633 0.287,-0.945c12.527,5.05 25.049,12.102 37.573,21.02c-1.3,10.135 -5.564,18.543 -11.287,22.748c-9.155,-10.061 -18.611,-19.79 -28.417,-29.092l-0.007,-0.238c0,-2.852 0.23,-5.619 0.665,-8.252c-0.435,2.633 -0.665,5.4 -0.665,8.252l0.007,0.238l-11.189,-10.347l-7.497,-6.473Zm19.515,7.36c-0.049,0.265 -0.097,0.532 -0.142,0.801c0.039,-0.231 0.079,-0.461 0.122,-0.69l0.02,-0.111Zm0.18,-0.913c-0.055,0.268 -0.109,0.537 -0.16,0.808c0.051,-0.271 0.105,-0.54 0.16,-0.808Zm0.328,-1.455c-0.089,0.364 -0.173,0.731 -0.253,1.101c0.08,-0.37 0.164,-0.737 0.253,-1.101Zm0.033,-0.137l-0.017,0.07l0.017,-0.07l0.019,-0.077l-0.019,0.077Zm0.433,-1.625c-0.037,0.129 -0.073,0.258 -0.109,0.387c0.036,-0.129 0.072,-0.258 0.109,-0.387Z\" style=\"fill:#41cd52;\"/>"
+                                                             "</svg>"));
+    }
+
+    if (!_archive.isEmpty())
+    {
+        Q_EMIT updateStatus(QStringLiteral("Finishing archive…"));
+        CloseArchive();
+    }
 
     Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
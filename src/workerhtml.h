@@ -22,7 +22,29 @@
 
 #include "worker.h"
 
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
 #include <QObject>
+#include <QSet>
+#include <QVector>
+
+#include <atomic>
+
+class STIG;
+class STIGCheck;
+
+struct ArchiveEntry
+{
+    QByteArray name;
+    quint32 crc;
+    quint32 compressedSize;
+    quint32 size;
+    qint64 offset;
+};
 
 class WorkerHTML : public Worker
 {
@@ -30,12 +52,33 @@ class WorkerHTML : public Worker
 
 private:
     QString _exportDir;
-    QString CheckItem(const QString &title, const QString &contents);
-    QString CheckItem(const QString &title, const QStringList &contents);
-    QString Sanitize(const QString &contents);
+    QString _archive;
+    QFile _zipFile;
+    QMutex _zipMutex;
+    QVector<ArchiveEntry> _zipEntries;
+    QSet<QByteArray> _zipNames;
+    quint16 _zipTime;
+    quint16 _zipDate;
+    bool _zipFailed;
+    std::atomic<int> _zipDropped;
+    QByteArray _header;
+    QByteArray _footer;
+    QHash<int, QString> _ccis;
+    QString CheckItem(const QString &title, const QString &contents) const;
+    QString CheckItem(const QString &title, const QStringList &contents) const;
+    QJsonObject ManifestEntry(const STIG &stig, const QVector<STIGCheck> &checks) const;
+    QString PageName(const STIG &stig) const;
+    QMap<int, QJsonObject> ReadManifest() const;
+    QString Sanitize(const QString &contents) const;
+    bool AddToArchive(const QString &fileName, const QByteArray &contents);
+    bool CloseArchive();
+    bool OpenArchive();
+    bool WriteFile(const QString &fileName, const QByteArray &contents);
+    bool WriteSTIG(const STIG &stig, const QVector<STIGCheck> &checks);
 
 public:
     explicit WorkerHTML(QObject *parent = nullptr);
+    void SetArchive(const QString &fileName);
     void SetDir(const QString &dir);
 
 public Q_SLOTS:
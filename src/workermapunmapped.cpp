@@ -36,6 +36,9 @@
  * Many systems have STIGs that map against controls not included in their
  * categorization baseline or tailoring. These findings can be remapped to
  * CM-6.
+ *
+ * The original mapping of each STIGCheck that is changed is kept so
+ * that a cancelled remap can be undone.
  */
 
 /**
@@ -48,6 +51,20 @@ WorkerMapUnmapped::WorkerMapUnmapped(QObject *parent) : Worker(parent)
 {
 }
 
+/**
+ * @brief WorkerMapUnmapped::RollBack
+ *
+ * Restore the mapping of the STIGChecks that this worker changed so
+ * that a cancelled remap leaves the database as it was.
+ */
+void WorkerMapUnmapped::RollBack()
+{
+    Q_EMIT updateStatus(QStringLiteral("Restoring the original mappings…"));
+    DbManager db;
+    while (!_original.isEmpty())
+        db.UpdateSTIGCheck(_original.takeLast());
+}
+
 /**
  * @brief WorkerMapUnmapped::process
  *
@@ -68,8 +85,12 @@ void WorkerMapUnmapped::process()
         remapCCIIds.append(c.id);
     }
 
+    _original.clear();
     Q_FOREACH (STIGCheck check, stigchecks)
     {
+        if (Cancelled())
+            break;
+        STIGCheck original = check;
         //Q_EMIT updateStatus(QStringLiteral("Checking ") + PrintSTIGCheck(check) + QStringLiteral("…"));
         bool updateCheck = false;
 
@@ -107,11 +128,18 @@ void WorkerMapUnmapped::process()
         if (updateCheck)
         {
             Q_EMIT updateStatus(QStringLiteral("Updating mapping for ") + PrintSTIGCheck(check) + QStringLiteral("…"));
-            db.UpdateSTIGCheck(check);
+            if (db.UpdateSTIGCheck(check))
+                _original.append(original);
         }
         Q_EMIT progress(-1);
     }
 
-    Q_EMIT updateStatus(QStringLiteral("Done!"));
+    if (IsCancelled())
+    {
+        RollBack();
+        Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+    }
+    else
+        Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
 }
@@ -20,14 +20,20 @@
 #ifndef WORKERMAPUNMAPPED_H
 #define WORKERMAPUNMAPPED_H
 
+#include "stigcheck.h"
 #include "worker.h"
 
 #include <QObject>
+#include <QVector>
 
 class WorkerMapUnmapped : public Worker
 {
     Q_OBJECT
 
+private:
+    QVector<STIGCheck> _original;
+    void RollBack();
+
 public:
     explicit WorkerMapUnmapped(QObject *parent = nullptr);
 
@@ -21,6 +21,7 @@
 #include "dbmanager.h"
 #include "stig.h"
 #include "stigcheck.h"
+#include "tracerecorder.h"
 #include "workerstigadd.h"
 
 #include <QXmlStreamReader>
@@ -55,6 +56,7 @@ WorkerSTIGAdd::WorkerSTIGAdd(QObject *parent) : Worker(parent),
  */
 void WorkerSTIGAdd::ParseSTIG(const QByteArray &stig, const QString &fileName, const QMap<QString, QByteArray> &supplements)
 {
+    TraceSpan span(QStringLiteral("parse XCCDF"), "parse");
     //should be the .xml file inside of the STIG .zip file here
     auto *xml = new QXmlStreamReader(stig);
     STIG s;
@@ -341,8 +343,31 @@ void WorkerSTIGAdd::ParseSTIG(const QByteArray &stig, const QString &fileName, c
     }
 
     //Sometimes the .zip file contains extraneous .xml files
-    if (checks.count() > 0)
-        db.AddSTIG(s, checks, supplementsToAdd);
+    if ((checks.count() > 0) && db.AddSTIG(s, checks, supplementsToAdd))
+        _added.append(s);
+}
+
+/**
+ * @brief WorkerSTIGAdd::AddedSTIGs
+ * @return The @a STIGs that this worker added to the database.
+ */
+QVector<STIG> WorkerSTIGAdd::AddedSTIGs() const
+{
+    return _added;
+}
+
+/**
+ * @brief WorkerSTIGAdd::RollBack
+ *
+ * Remove the @a STIGs that this worker added so that a cancelled
+ * import leaves the database as it was.
+ */
+void WorkerSTIGAdd::RollBack()
+{
+    Q_EMIT updateStatus(QStringLiteral("Removing the STIGs that were added…"));
+    DbManager db;
+    while (!_added.isEmpty())
+        db.DeleteSTIG(_added.takeLast());
 }
 
 /**
@@ -385,6 +410,8 @@ void WorkerSTIGAdd::process()
     //loop through it and parse all XML files inside
     Q_FOREACH(const QString s, _todo)
     {
+        if (Cancelled())
+            break;
         Q_EMIT updateStatus("Extracting " + s + "…");
         //get the list of XML files inside the STIG
         QMap<QString, QByteArray> toParse = GetFilesFromZip(s);
@@ -392,6 +419,8 @@ void WorkerSTIGAdd::process()
         Q_EMIT updateStatus("Parsing " + s + "…");
         Q_FOREACH(const QString stig, toParse.keys())
         {
+            if (Cancelled())
+                break;
             if (stig.endsWith(QStringLiteral("-xccdf.xml"), Qt::CaseInsensitive))
             {
                 QByteArray val = toParse.value(stig);
@@ -401,6 +430,12 @@ void WorkerSTIGAdd::process()
         }
         Q_EMIT progress(-1);
     }
-    Q_EMIT updateStatus(QStringLiteral("Done!"));
+    if (IsCancelled())
+    {
+        RollBack();
+        Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+    }
+    else
+        Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
 }
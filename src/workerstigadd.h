@@ -20,9 +20,11 @@
 #ifndef WORKERSTIGADD_H
 #define WORKERSTIGADD_H
 
+#include "stig.h"
 #include "worker.h"
 
 #include <QObject>
+#include <QVector>
 
 class WorkerSTIGAdd : public Worker
 {
@@ -31,11 +33,14 @@ class WorkerSTIGAdd : public Worker
 private:
     QStringList _todo;
     bool _enableSupplements;
+    QVector<STIG> _added;
     void ParseSTIG(const QByteArray &stig, const QString &fileName, const QMap<QString, QByteArray> &supplements);
 
 public:
     explicit WorkerSTIGAdd(QObject *parent = nullptr);
     void AddSTIGs(const QStringList &stigs);
+    QVector<STIG> AddedSTIGs() const;
+    void RollBack();
     void SetEnableSupplements(bool enableSupplements);
 
 public Q_SLOTS:
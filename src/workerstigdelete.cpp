@@ -25,6 +25,9 @@
  * @brief Remove STIGs and SRGs from the internal database.
  *
  * STIG and SRG IDs are provided and removed from the database.
+ *
+ * A copy of each removed STIG is kept until the worker finishes so
+ * that a cancelled deletion can add the STIGs back.
  */
 
 /**
@@ -48,6 +51,27 @@ void WorkerSTIGDelete::AddId(int id)
     _ids.append(id);
 }
 
+/**
+ * @brief WorkerSTIGDelete::RollBack
+ *
+ * Add back the STIGs (with their checks and supplements) that this
+ * worker removed so that a cancelled deletion leaves the database as
+ * it was. Only STIGs that no @a Asset uses are removed, so the
+ * restored STIGs may receive new IDs.
+ */
+void WorkerSTIGDelete::RollBack()
+{
+    Q_EMIT updateStatus(QStringLiteral("Restoring the STIGs that were removed…"));
+    DbManager db;
+    while (!_deleted.isEmpty())
+    {
+        auto deleted = _deleted.takeLast();
+        STIG stig = std::get<0>(deleted);
+        stig.id = -1;
+        db.AddSTIG(stig, std::get<1>(deleted), std::get<2>(deleted));
+    }
+}
+
 /**
  * @brief WorkerSTIGDelete::process
  *
@@ -61,15 +85,27 @@ void WorkerSTIGDelete::process()
 
     Q_EMIT updateStatus(QStringLiteral("Clearing DB of selected STIG information…"));
     db.DelayCommit(true);
+    _deleted.clear();
     Q_FOREACH (int i, _ids)
     {
-        db.DeleteSTIG(i);
+        if (Cancelled())
+            break;
+        STIG stig = db.GetSTIG(i);
+        QVector<STIGCheck> checks = db.GetSTIGChecks(stig);
+        QVector<Supplement> supplements = db.GetSupplements(stig);
+        if (db.DeleteSTIG(i))
+            _deleted.append(std::make_tuple(stig, checks, supplements));
         Q_EMIT progress(-1);
     }
     db.DelayCommit(false);
     Q_EMIT progress(-1);
 
-    //complete
-    Q_EMIT updateStatus(QStringLiteral("Done!"));
+    if (IsCancelled())
+    {
+        RollBack();
+        Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+    }
+    else
+        Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
 }
@@ -20,9 +20,15 @@
 #ifndef WORKERSTIGDELETE_H
 #define WORKERSTIGDELETE_H
 
+#include "stig.h"
+#include "stigcheck.h"
+#include "supplement.h"
 #include "worker.h"
 
 #include <QObject>
+#include <QVector>
+
+#include <tuple>
 
 class WorkerSTIGDelete : public Worker
 {
@@ -30,6 +36,8 @@ class WorkerSTIGDelete : public Worker
 
 private:
     QList<int> _ids;
+    QVector<std::tuple<STIG, QVector<STIGCheck>, QVector<Supplement>>> _deleted;
+    void RollBack();
 
 public:
     explicit WorkerSTIGDelete(QObject *parent = nullptr);
@@ -19,13 +19,14 @@
 
 #include "common.h"
 #include "dbmanager.h"
+#include "memorymonitor.h"
 #include "stig.h"
 #include "stigcheck.h"
 #include "workerstigdownload.h"
 
 #include "workerstigadd.h"
+#include <QStringList>
 #include <QTemporaryFile>
-#include <QMap>
 
 /**
  * @class WorkerSTIGDownload
@@ -35,6 +36,9 @@
  * The main source of STIG and SRG information is from DISA. They
  * publish a quarterly STIG release that is downloaded and processed
  * in this worker.
+ *
+ * The STIGs within the release are extracted one at a time, so only
+ * one of them is held in memory while it is parsed.
  */
 
 /**
@@ -74,6 +78,7 @@ void WorkerSTIGDownload::process()
     Q_EMIT updateStatus(QStringLiteral("Downloading quarterly…"));
 
     QTemporaryFile tmpFile;
+    QVector<STIG> added;
     if (tmpFile.open())
     {
         DbManager db;
@@ -81,29 +86,46 @@ void WorkerSTIGDownload::process()
         DownloadFile(stigs, &tmpFile);
         //get all zip files within the master zip file
         Q_EMIT updateStatus(QStringLiteral("Extracting and adding STIGs…"));
-        auto stigFiles = GetFilesFromZip(tmpFile.fileName(), QStringLiteral(".zip"));
+        QStringList stigFiles = GetFileNamesFromZip(tmpFile.fileName(), QStringLiteral(".zip"));
         Q_EMIT initialize(stigFiles.count() + 2, 2);
         //assume that each zip file within the archive is its own STIG and try to process it
-        QMap<QString, QByteArray>::iterator i;
-        for (i = stigFiles.begin(); i != stigFiles.end(); ++i)
+        for (auto i = stigFiles.constBegin(); (i != stigFiles.constEnd()) && !Cancelled(); ++i)
         {
-            Q_EMIT updateStatus("Parsing " + i.key() + "…");
+            //let other jobs release memory before extracting the next STIG
+            WaitForMemory();
+            Q_EMIT updateStatus("Parsing " + *i + "…");
             WorkerSTIGAdd tmpWorker;
+            //cancelling the download also cancels the STIG being parsed
+            tmpWorker.ShareCancellation(*this);
             tmpWorker.SetEnableSupplements(_enableSupplements);
             QTemporaryFile tmpFile2;
             if (tmpFile2.open())
             {
-                tmpFile2.write(i.value());
+                QByteArray stigFile = GetFileFromZip(tmpFile.fileName(), *i);
+                MemoryMonitor::Track(stigFile.size());
+                tmpFile2.write(stigFile);
+                MemoryMonitor::Track(-stigFile.size());
             }
             tmpFile2.close();
             QStringList tmpList;
             tmpList.push_back(tmpFile2.fileName());
             tmpWorker.AddSTIGs(tmpList);
             tmpWorker.process();
+            added.append(tmpWorker.AddedSTIGs());
             Q_EMIT progress(-1);
         }
         tmpFile.close();
     }
-    Q_EMIT updateStatus(QStringLiteral("Done!"));
+    if (IsCancelled())
+    {
+        //the STIG that was being parsed removed itself; remove the earlier ones
+        Q_EMIT updateStatus(QStringLiteral("Removing the STIGs that were added…"));
+        DbManager db;
+        while (!added.isEmpty())
+            db.DeleteSTIG(added.takeLast());
+        Q_EMIT updateStatus(QStringLiteral("Cancelled."));
+    }
+    else
+        Q_EMIT updateStatus(QStringLiteral("Done!"));
     Q_EMIT finished();
 }